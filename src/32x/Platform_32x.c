@@ -164,6 +164,10 @@ int File_Exists(const cc_filepath* path) {
 	return false;
 }
 
+cc_result File_Delete(const cc_filepath* path) {
+	return ERR_NOT_SUPPORTED;
+}
+
 cc_result Directory_Enum(const cc_string* dirPath, void* obj, Directory_EnumCallback callback) {
 	return ERR_NOT_SUPPORTED;
 }
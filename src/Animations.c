@@ -14,7 +14,7 @@
 
 /* Disables when no hardware FPU, as lava/water animations are FPU heavy and thus costly */
 #if CC_BUILD_FPU_MODE >= CC_FPU_MODE_NORMAL
-static void Animations_Update(int loc, struct Bitmap* bmp, int stride);
+static const BitmapCol* Animations_CurrentFrame(TextureLoc texLoc, int* size, int* stride);
 
 #ifdef CC_BUILD_LOWMEM
 	#define LIQUID_ANIM_MAX 16
@@ -25,6 +25,159 @@ static void Animations_Update(int loc, struct Bitmap* bmp, int stride);
 #define WATER_TEX_LOC 14
 #define LAVA_TEX_LOC  30
 
+/*########################################################################################################################*
+*----------------------------------------------------Animation uploads----------------------------------------------------*
+*#########################################################################################################################*/
+/* Tiles changed during a tick are only uploaded at the end of the tick, so that nearby tiles */
+/*  in the same 1D atlas can be combined into one texture update instead of one per tile */
+struct AnimationFrame {
+	TextureLoc texLoc;
+	int size, stride;
+	const BitmapCol* pixels;
+};
+static struct AnimationFrame anims_changed[ATLAS1D_MAX_ATLASES + 2];
+static int anims_changedCount;
+static BitmapCol* anims_staging;
+static int anims_stagingSize;
+/* Max number of unchanged tiles that can be in between two changed tiles in one update */
+#define ANIMS_MAX_GAP 2
+
+static void Animations_Draw(TextureLoc texLoc, const BitmapCol* pixels, int size, int stride) {
+	struct AnimationFrame* frames = anims_changed;
+	int i, j;
+
+	/* List is kept sorted by tile */
+	for (i = 0; i < anims_changedCount && frames[i].texLoc < texLoc; i++) { }
+
+	if (i == anims_changedCount || frames[i].texLoc != texLoc) {
+		if (anims_changedCount == Array_Elems(anims_changed)) return;
+
+		for (j = anims_changedCount; j > i; j--) {
+			frames[j] = frames[j - 1];
+		}
+		anims_changedCount++;
+	}
+
+	frames[i].texLoc = texLoc;
+	frames[i].size   = size;
+	frames[i].stride = stride;
+	frames[i].pixels = pixels;
+}
+
+static void Animations_Upload(TextureLoc texLoc, struct Bitmap* bmp, int stride) {
+	int dstX = Atlas1D_Index(texLoc);
+	int dstY = Atlas1D_RowId(texLoc) * Atlas2D.TileSize;
+	GfxResourceID tex;
+	int i;
+
+	tex = Atlas1D.TexIds[dstX];
+	if (!tex) return;
+
+	/* Every copy of the tile in the 1D atlas needs updating */
+	for (i = 0; i < Atlas1D.Repeats; i++, dstY += Atlas2D.TileSize)
+	{
+		Gfx_UpdateTexture(tex, 0, dstY, bmp, stride, Gfx.Mipmaps);
+	}
+}
+
+static void Animations_UploadFrame(struct AnimationFrame* frame) {
+	struct Bitmap bmp;
+	Bitmap_Init(bmp, frame->size, frame->size, (BitmapCol*)frame->pixels);
+	Animations_Upload(frame->texLoc, &bmp, frame->stride);
+}
+
+static void Animations_CopyTile(TextureLoc texLoc, BitmapCol* dst) {
+	int tileSize = Atlas2D.TileSize;
+	int x = Atlas2D_TileX(texLoc) * tileSize;
+	int y = Atlas2D_TileY(texLoc) * tileSize;
+	int i;
+
+	if (Atlas2D_TileY(texLoc) >= Atlas2D.RowsCount) {
+		Mem_Set(dst, 0, tileSize * tileSize * BITMAPCOLOR_SIZE); return;
+	}
+
+	for (i = 0; i < tileSize; i++) {
+		Mem_Copy(dst + i * tileSize, Bitmap_GetRow(&Atlas2D.Bmp, y + i) + x, tileSize * BITMAPCOLOR_SIZE);
+	}
+}
+
+/* Combines a run of nearby tiles into one bitmap, so they can be uploaded in one texture update */
+/* Each tile is written Atlas1D.Repeats times, matching how tiles are laid out in the 1D atlas */
+static cc_bool Animations_UploadRun(struct AnimationFrame* frames, int count) {
+	int tileSize = Atlas2D.TileSize, area = tileSize * tileSize;
+	int first    = frames[0].texLoc;
+	int repeats  = Atlas1D.Repeats;
+	int rows     = (frames[count - 1].texLoc - first + 1) * repeats;
+	int loc, size, stride, y, i;
+	const BitmapCol* src;
+	BitmapCol* dst;
+	struct Bitmap bmp;
+	GfxResourceID tex;
+
+	tex = Atlas1D.TexIds[Atlas1D_Index(first)];
+	if (!tex) return true;
+
+	if (rows * area > anims_stagingSize) {
+		Mem_Free(anims_staging);
+		anims_stagingSize = 0;
+
+		anims_staging = (BitmapCol*)Mem_TryAlloc(rows * area, BITMAPCOLOR_SIZE);
+		if (!anims_staging) return false;
+		anims_stagingSize = rows * area;
+	}
+
+	for (loc = first; loc < first + rows / repeats; loc++) {
+		dst = anims_staging + (loc - first) * repeats * area;
+		Animations_CopyTile(loc, dst);
+
+		if (loc == frames->texLoc) {
+			src  = frames->pixels;
+			size = frames->size; stride = frames->stride;
+			frames++;
+		} else {
+			src  = Animations_CurrentFrame(loc, &size, &stride);
+		}
+
+		for (y = 0; src && y < size; y++) {
+			Mem_Copy(dst + y * tileSize, src + y * stride, size * BITMAPCOLOR_SIZE);
+		}
+		for (i = 1; i < repeats; i++) {
+			Mem_Copy(dst + i * area, dst, area * BITMAPCOLOR_SIZE);
+		}
+	}
+
+	Bitmap_Init(bmp, tileSize, rows * tileSize, anims_staging);
+	Gfx_UpdateTexture(tex, 0, Atlas1D_RowId(first) * tileSize, &bmp, tileSize, Gfx.Mipmaps);
+	return true;
+}
+
+static void Animations_Flush(void) {
+	struct AnimationFrame* frames = anims_changed;
+	int i, j, k, count = anims_changedCount;
+	anims_changedCount = 0;
+
+	for (i = 0; i < count; i = j + 1) {
+		/* Extend run over following tiles in the same 1D atlas, that are also at most a few tiles further down */
+		for (j = i; j + 1 < count; j++) {
+			if (Atlas1D_Index(frames[j + 1].texLoc) != Atlas1D_Index(frames[i].texLoc)) break;
+			if (frames[j + 1].texLoc - frames[j].texLoc > ANIMS_MAX_GAP + 1) break;
+		}
+		if (i != j && Animations_UploadRun(frames + i, j - i + 1)) continue;
+
+		for (k = i; k <= j; k++) {
+			Animations_UploadFrame(&frames[k]);
+		}
+	}
+}
+
+static void Animations_FreeUploads(void) {
+	Mem_Free(anims_staging);
+	anims_staging      = NULL;
+	anims_stagingSize  = 0;
+	anims_changedCount = 0;
+}
+
+
 #ifndef CC_BUILD_WEB
 /* Based off the incredible work from https://dl.dropboxusercontent.com/u/12694594/lava.txt
 	mirrored at https://github.com/ClassiCube/ClassiCube/wiki/Minecraft-Classic-lava-animation-algorithm
@@ -39,15 +192,11 @@ static float L_flameHeat[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
 static RNGState L_rnd;
 static cc_bool  L_rndInited;
 
-static void LavaAnimation_Tick(void) {
-	BitmapCol pixels[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
-	BitmapCol* ptr = pixels;
+static void LavaAnimation_Step(BitmapCol* ptr, int size) {
 	float soupHeat, potHeat, color;
-	int size, mask, shift;
+	int mask, shift;
 	int x, y, i = 0;
-	struct Bitmap bmp;
 
-	size  = min(Atlas2D.TileSize, LIQUID_ANIM_MAX);
 	mask  = size - 1;
 	shift = Math_ilog2(size);
 
@@ -105,9 +254,6 @@ static void LavaAnimation_Tick(void) {
 			ptr++; i++;
 		}
 	}
-
-	Bitmap_Init(bmp, size, size, pixels);
-	Animations_Update(LAVA_TEX_LOC, &bmp, size);
 }
 
 
@@ -120,15 +266,11 @@ static float W_flameHeat[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
 static RNGState W_rnd;
 static cc_bool  W_rndInited;
 
-static void WaterAnimation_Tick(void) {
-	BitmapCol pixels[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
-	BitmapCol* ptr = pixels;
+static void WaterAnimation_Step(BitmapCol* ptr, int size) {
 	float soupHeat, color;
-	int size, mask, shift;
+	int mask, shift;
 	int x, y, i = 0;
-	struct Bitmap bmp;
 
-	size  = min(Atlas2D.TileSize, LIQUID_ANIM_MAX);
 	mask  = size - 1;
 	shift = Math_ilog2(size);
 
@@ -167,9 +309,89 @@ static void WaterAnimation_Tick(void) {
 			ptr++; i++;
 		}
 	}
+}
 
-	Bitmap_Init(bmp, size, size, pixels);
-	Animations_Update(WATER_TEX_LOC, &bmp, size);
+/*########################################################################################################################*
+*-------------------------------------------------Liquid animation cycle--------------------------------------------------*
+*#########################################################################################################################*/
+/* Rather than simulating lava/water every tick, a fixed cycle of frames is simulated once and then looped */
+#define LIQUID_CYCLE_FRAMES  128
+/* Ticks simulated before the cycle, so that it does not start from an empty heatmap */
+#define LIQUID_WARMUP_FRAMES 64
+/* Number of frames at start of the cycle that are crossfaded with the frames following the end of it */
+#define LIQUID_BLEND_FRAMES  24
+typedef void (*LiquidAnimation_StepFunc)(BitmapCol* pixels, int size);
+
+struct LiquidAnimation {
+	TextureLoc texLoc;
+	LiquidAnimation_StepFunc step;
+	int size, frame;
+	BitmapCol* frames;      /* Precomputed cycle, or NULL when simulated every tick instead */
+	const BitmapCol* shown; /* Frame currently drawn in the terrain atlas */
+	BitmapCol live[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
+};
+static struct LiquidAnimation lavaAnim  = { LAVA_TEX_LOC,  LavaAnimation_Step  };
+static struct LiquidAnimation waterAnim = { WATER_TEX_LOC, WaterAnimation_Step };
+
+static BitmapCol LiquidAnimation_Blend(BitmapCol a, BitmapCol b, int t) {
+	int s = LIQUID_BLEND_FRAMES - t;
+	return BitmapCol_Make(
+		(BitmapCol_R(a) * s + BitmapCol_R(b) * t) / LIQUID_BLEND_FRAMES,
+		(BitmapCol_G(a) * s + BitmapCol_G(b) * t) / LIQUID_BLEND_FRAMES,
+		(BitmapCol_B(a) * s + BitmapCol_B(b) * t) / LIQUID_BLEND_FRAMES,
+		(BitmapCol_A(a) * s + BitmapCol_A(b) * t) / LIQUID_BLEND_FRAMES);
+}
+
+static void LiquidAnimation_Precompute(struct LiquidAnimation* anim) {
+	int i, j, size = anim->size, area = size * size;
+	BitmapCol* frames;
+	BitmapCol* dst;
+
+	frames = (BitmapCol*)Mem_TryAlloc(LIQUID_CYCLE_FRAMES * area, BITMAPCOLOR_SIZE);
+	if (!frames) return;
+
+	for (i = 0; i < LIQUID_WARMUP_FRAMES; i++) anim->step(anim->live, size);
+	for (i = 0; i < LIQUID_CYCLE_FRAMES;  i++) anim->step(frames + i * area, size);
+
+	/* Crossfade start of the cycle with what would have followed the end of it, so it loops seamlessly */
+	for (i = 0; i < LIQUID_BLEND_FRAMES; i++) {
+		anim->step(anim->live, size);
+		dst = frames + i * area;
+
+		for (j = 0; j < area; j++) {
+			dst[j] = LiquidAnimation_Blend(anim->live[j], dst[j], i);
+		}
+	}
+	anim->frames = frames;
+}
+
+static void LiquidAnimation_Free(struct LiquidAnimation* anim) {
+	Mem_Free(anim->frames);
+	anim->frames = NULL;
+	anim->shown  = NULL;
+	anim->size   = 0;
+	anim->frame  = 0;
+}
+
+static void LiquidAnimation_Tick(struct LiquidAnimation* anim) {
+	int size = min(Atlas2D.TileSize, LIQUID_ANIM_MAX);
+	if (anim->size != size) {
+		LiquidAnimation_Free(anim);
+		anim->size = size;
+		/* Not worth the memory when it is this scarce */
+#ifndef CC_BUILD_LOWMEM
+		LiquidAnimation_Precompute(anim);
+#endif
+	}
+
+	if (anim->frames) {
+		anim->shown = anim->frames + anim->frame * size * size;
+		anim->frame = (anim->frame + 1) % LIQUID_CYCLE_FRAMES;
+	} else {
+		anim->step(anim->live, size);
+		anim->shown = anim->live;
+	}
+	Animations_Draw(anim->texLoc, anim->shown, size, size);
 }
 #endif
 
@@ -185,9 +407,11 @@ struct AnimationData {
 	cc_uint16 statesCount;    /* Total number of animation frames */
 	cc_uint16 delay;          /* Delay in ticks until next frame is drawn */
 	cc_uint16 frameDelay;     /* Delay between each frame */
+	BitmapCol* frames;        /* Frames extracted from animations.png, or NULL */
 };
 
 static struct Bitmap anims_bmp;
+static BitmapCol* anims_frames;
 static struct AnimationData anims_list[ATLAS1D_MAX_ATLASES];
 static int anims_count;
 static cc_bool anims_validated, useLavaAnim, useWaterAnim, alwaysLavaAnim, alwaysWaterAnim;
@@ -250,18 +474,86 @@ static void Animations_ReadDescription(struct Stream* stream, const cc_string* p
 	}
 }
 
-static void Animations_Update(int texLoc, struct Bitmap* bmp, int stride) {
-	int dstX = Atlas1D_Index(texLoc);
-	int dstY = Atlas1D_RowId(texLoc) * Atlas2D.TileSize;
-	GfxResourceID tex;
+/* Copies all animation frames out of animations.png into separate contiguous tiles, */
+/*  so that frames can be uploaded directly without a row stride */
+static void Animations_ExtractFrames(void) {
+	struct AnimationData* data;
+	const BitmapCol* src;
+	BitmapCol* dst;
+	cc_uint32 total = 0;
+	int i, frame, y, size;
 
-	tex = Atlas1D.TexIds[dstX];
-	if (tex) Gfx_UpdateTexture(tex, 0, dstY, bmp, stride, Gfx.Mipmaps);
+	for (i = 0; i < anims_count; i++) {
+		size   = anims_list[i].frameSize;
+		total += anims_list[i].statesCount * size * size;
+	}
+	if (!total) return;
+
+	/* Not fatal, frames are just read from animations.png instead */
+	anims_frames = (BitmapCol*)Mem_TryAlloc(total, BITMAPCOLOR_SIZE);
+	if (!anims_frames) return;
+	dst = anims_frames;
+
+	for (i = 0; i < anims_count; i++) {
+		data = &anims_list[i];
+		size = data->frameSize;
+		data->frames = dst;
+
+		for (frame = 0; frame < data->statesCount; frame++) {
+			for (y = 0; y < size; y++) {
+				src = Bitmap_GetRow(&anims_bmp, data->frameY + y) + data->frameX + frame * size;
+				Mem_Copy(dst, src, size * BITMAPCOLOR_SIZE);
+				dst += size;
+			}
+		}
+	}
+
+	/* animations.png is no longer needed */
+	Mem_Free(anims_bmp.scan0);
+	anims_bmp.scan0 = NULL;
+}
+
+static const BitmapCol* Animations_FramePixels(struct AnimationData* data, int* stride) {
+	int size = data->frameSize;
+	if (data->frames) {
+		*stride = size;
+		return data->frames + data->state * size * size;
+	}
+
+	*stride = anims_bmp.width;
+	return Bitmap_GetRow(&anims_bmp, data->frameY) + (data->frameX + data->state * size);
 }
 
+/* Returns the frame currently drawn for the given tile, or NULL if the tile is not animated */
+static const BitmapCol* Animations_CurrentFrame(TextureLoc texLoc, int* size, int* stride) {
+	struct AnimationData* data;
+	int i;
+#ifndef CC_BUILD_WEB
+	struct LiquidAnimation* liquid = NULL;
+	if (texLoc == LAVA_TEX_LOC  && useLavaAnim)  liquid = &lavaAnim;
+	if (texLoc == WATER_TEX_LOC && useWaterAnim) liquid = &waterAnim;
+
+	if (liquid) {
+		*size = liquid->size; *stride = liquid->size;
+		return liquid->shown;
+	}
+#endif
+
+	/* Later animations are drawn over earlier ones for the same tile */
+	for (i = anims_count - 1; i >= 0; i--) {
+		data = &anims_list[i];
+		if (data->texLoc != texLoc) continue;
+
+		*size = data->frameSize;
+		return Animations_FramePixels(data, stride);
+	}
+	return NULL;
+}
+
+
 static void Animations_Apply(struct AnimationData* data) {
-	struct Bitmap frame;
-	int loc, size;
+	const BitmapCol* pixels;
+	int loc, stride;
 	if (data->delay) { data->delay--; return; }
 
 	data->state++;
@@ -274,13 +566,8 @@ static void Animations_Apply(struct AnimationData* data) {
 	if (loc == WATER_TEX_LOC && useWaterAnim) return;
 #endif
 
-	size = data->frameSize;
-	Bitmap_Init(frame, size, size, NULL);
-
-	frame.scan0 = anims_bmp.scan0 
-				+ data->frameY * anims_bmp.width
-				+ (data->frameX + data->state * size);
-	Animations_Update(loc, &frame, anims_bmp.width);
+	pixels = Animations_FramePixels(data, &stride);
+	Animations_Draw(loc, pixels, data->frameSize, stride);
 }
 
 static cc_bool Animations_IsDefaultZip(void) {
@@ -294,9 +581,17 @@ static cc_bool Animations_IsDefaultZip(void) {
 
 static void Animations_Clear(void) {
 	Mem_Free(anims_bmp.scan0);
+	Mem_Free(anims_frames);
 	anims_count = 0;
 	anims_bmp.scan0 = NULL;
+	anims_frames    = NULL;
 	anims_validated = false;
+
+	Animations_FreeUploads();
+#ifndef CC_BUILD_WEB
+	LiquidAnimation_Free(&lavaAnim);
+	LiquidAnimation_Free(&waterAnim);
+#endif
 }
 
 static void Animations_Validate(void) {
@@ -332,27 +627,41 @@ static void Animations_Validate(void) {
 		}
 		i--; anims_count--;
 	}
+	Animations_ExtractFrames();
 }
 
 static void Animations_Tick(struct ScheduledTask* task) {
 	int i;
 #ifndef CC_BUILD_WEB
-	if (useLavaAnim)  LavaAnimation_Tick();
-	if (useWaterAnim) WaterAnimation_Tick();
+	if (useLavaAnim)  LiquidAnimation_Tick(&lavaAnim);
+	if (useWaterAnim) LiquidAnimation_Tick(&waterAnim);
 #endif
 
-	if (!anims_count) return;
-	if (!anims_bmp.scan0) {
+	if (anims_count && !anims_validated && !anims_bmp.scan0) {
 		Chat_AddRaw("&cCurrent texture pack specifies it uses animations,");
 		Chat_AddRaw("&cbut is missing animations.png");
-		anims_count = 0; return;
+		anims_count = 0;
 	}
 
 	/* deferred, because when reading animations.txt, might not have read animations.png yet */
-	if (!anims_validated) Animations_Validate();
+	if (anims_count && !anims_validated) Animations_Validate();
 	for (i = 0; i < anims_count; i++) {
 		Animations_Apply(&anims_list[i]);
 	}
+	Animations_Flush();
+}
+
+cc_bool Animations_IsAnimated(TextureLoc texLoc) {
+	int i;
+#ifndef CC_BUILD_WEB
+	if (texLoc == LAVA_TEX_LOC  && useLavaAnim)  return true;
+	if (texLoc == WATER_TEX_LOC && useWaterAnim) return true;
+#endif
+
+	for (i = 0; i < anims_count; i++) {
+		if (anims_list[i].texLoc == texLoc) return true;
+	}
+	return false;
 }
 
 
@@ -360,7 +669,7 @@ static void Animations_Tick(struct ScheduledTask* task) {
 *--------------------------------------------------Animations component---------------------------------------------------*
 *#########################################################################################################################*/
 static void AnimationsPngProcess(struct Stream* stream, const cc_string* name) {
-	cc_result res = Png_Decode(&anims_bmp, stream);
+	cc_result res = TexturePack_DecodePng(&anims_bmp, stream);
 	if (!res) return;
 
 	Logger_SysWarn2(res, "decoding", name);
@@ -402,6 +711,7 @@ static void OnInit(void) {
 #else
 static void Animations_Clear(void) { }
 static void OnInit(void) { }
+cc_bool Animations_IsAnimated(TextureLoc texLoc) { return false; }
 #endif
 
 struct IGameComponent Animations_Component = {
@@ -10,5 +10,8 @@ CC_BEGIN_HEADER
 struct IGameComponent;
 extern struct IGameComponent Animations_Component;
 
+/* Whether the given tile in terrain.png is periodically changed by an animation */
+cc_bool Animations_IsAnimated(TextureLoc texLoc);
+
 CC_END_HEADER
 #endif
@@ -119,18 +119,16 @@ static struct SoundGroup* Soundboard_FindGroup(struct Soundboard* board, const c
 	return NULL;
 }
 
-static void Soundboard_Load(struct Soundboard* board, const cc_string* boardName, const cc_string* file, struct Stream* stream) {
+static struct SoundGroup* Soundboard_FindSlot(struct Soundboard* board, const cc_string* boardName, const cc_string* file) {
 	struct SoundGroup* group;
-	struct Sound* snd;
 	cc_string name = *file;
-	cc_result res;
 	int dotIndex;
 	Utils_UNSAFE_TrimFirstDirectory(&name);
 
 	/* dig_grass1.wav -> dig_grass1 */
 	dotIndex = String_LastIndexOf(&name, '.');
 	if (dotIndex >= 0) name.length = dotIndex;
-	if (!String_CaselessStarts(&name, boardName)) return;
+	if (!String_CaselessStarts(&name, boardName)) return NULL;
 
 	/* Convert dig_grass1 to grass */
 	name = String_UNSAFE_SubstringAt(&name, boardName->length);
@@ -138,25 +136,409 @@ static void Soundboard_Load(struct Soundboard* board, const cc_string* boardName
 
 	group = Soundboard_FindGroup(board, &name);
 	if (!group) {
-		Chat_Add1("&cUnknown sound group '%s'", &name); return;
+		Chat_Add1("&cUnknown sound group '%s'", &name); return NULL;
 	}
 	if (group->count == Array_Elems(group->sounds)) {
-		Chat_AddRaw("&cCannot have more than 10 sounds in a group"); return;
+		Chat_AddRaw("&cCannot have more than 10 sounds in a group"); return NULL;
+	}
+	return group;
+}
+
+static void Sound_Unload(struct Sound* snd) {
+	if (snd->chunk.data) Audio_FreeChunks(&snd->chunk, 1);
+	snd->chunk.data = NULL;
+	snd->chunk.size = 0;
+}
+
+
+/* .ogg sound effects are decoded to PCM once on a background thread, then the */
+/*  decoded samples are saved as a .wav in the cache directory for later sessions */
+/* Evicted sounds are later reloaded from the cache on the same background thread */
+#define SOUND_CACHE_DIR "audio/soundcache"
+#define SOUND_MAX_JOBS (2 * SOUND_COUNT * AUDIO_MAX_SOUNDS)
+#define WAV_HDR_SIZE 44
+
+/* data is NULL for jobs that just reload a sound from the cache */
+struct SoundJob { struct Sound* snd; cc_uint8* data; cc_uint32 size; };
+/* Queue of jobs, as a ring buffer (each sound is only ever queued once at a time) */
+static struct SoundJob sound_jobs[SOUND_MAX_JOBS];
+static int sound_jobsHead, sound_numJobs;
+static void* sound_thread;
+static void* sound_mutex;
+static void* sound_waitable;
+static volatile cc_bool sound_stopping;
+/* Decoded sounds stay resident until this limit is exceeded, */
+/*  after which the least recently played sounds are evicted */
+static cc_uint32 sound_maxBytes, sound_residentBytes;
+
+static cc_bool Sound_CanCache(void) {
+#ifdef CC_BIG_ENDIAN
+	return false; /* .wav samples would need to be swapped when writing */
+#else
+	return !Platform_ReadonlyFilesystem;
+#endif
+}
+
+static void Sound_GetCachePath(cc_string* path, cc_uint32 key) {
+	String_Format1(path, SOUND_CACHE_DIR "/%h.wav", &key);
+}
+
+static cc_result Sound_ReadCache(struct Sound* snd) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	struct Stream stream;
+	cc_result res;
+
+	String_InitArray(path, pathBuffer);
+	Sound_GetCachePath(&path, snd->cacheKey);
+	if ((res = Stream_OpenFile(&stream, &path))) return res;
+
+	res = Sound_ReadWaveData(&stream, snd);
+	/* No point logging error for closing readonly file */
+	(void)stream.Close(&stream);
+
+	if (res) Sound_Unload(snd);
+	return res;
+}
+
+static cc_result Sound_WriteCache(struct Sound* snd) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	cc_uint8 header[WAV_HDR_SIZE];
+	cc_uint32 len = snd->chunk.size;
+	struct Stream stream;
+	cc_result res, closeRes;
+
+	Stream_SetU32_BE(header +  0, WAV_FourCC('R','I','F','F'));
+	Stream_SetU32_LE(header +  4, len + WAV_HDR_SIZE - 8);
+	Stream_SetU32_BE(header +  8, WAV_FourCC('W','A','V','E'));
+	Stream_SetU32_BE(header + 12, WAV_FourCC('f','m','t',' '));
+	Stream_SetU32_LE(header + 16, WAV_FMT_SIZE);
+	Stream_SetU16_LE(header + 20, 1); /* PCM audio format */
+	Stream_SetU16_LE(header + 22, snd->channels);
+	Stream_SetU32_LE(header + 24, snd->sampleRate);
+
+	Stream_SetU32_LE(header + 28, snd->sampleRate * snd->channels * 2); /* byte rate */
+	Stream_SetU16_LE(header + 32, snd->channels * 2);                   /* block align */
+	Stream_SetU16_LE(header + 34, 16);                                  /* bits per sample */
+	Stream_SetU32_BE(header + 36, WAV_FourCC('d','a','t','a'));
+	Stream_SetU32_LE(header + 40, len);
+
+	String_InitArray(path, pathBuffer);
+	Sound_GetCachePath(&path, snd->cacheKey);
+	if ((res = Stream_CreateFile(&stream, &path))) return res;
+
+	res = Stream_Write(&stream, header, WAV_HDR_SIZE);
+	if (!res) res = Stream_Write(&stream, (cc_uint8*)snd->chunk.data, len);
+
+	closeRes = stream.Close(&stream);
+	return res ? res : closeRes;
+}
+
+static cc_result Sound_DecodeOgg(struct Sound* snd, cc_uint8* data, cc_uint32 size) {
+	struct VorbisState* vorbis;
+	struct OggState* ogg;
+	struct Stream stream;
+	cc_int16* samples = NULL;
+	cc_int16* tmp;
+	cc_uint32 count = 0, capacity = 0, frameMax;
+	cc_result res;
+
+	vorbis = (struct VorbisState*)Mem_TryAllocCleared(1, sizeof(struct VorbisState));
+	ogg    = (struct OggState*)Mem_TryAllocCleared(1, sizeof(struct OggState));
+	if (!vorbis || !ogg) { res = ERR_OUT_OF_MEMORY; goto cleanup; }
+
+	Stream_ReadonlyMemory(&stream, data, size);
+	Ogg_Init(ogg, &stream);
+	Vorbis_Init(vorbis);
+	vorbis->source = ogg;
+	if ((res = Vorbis_DecodeHeaders(vorbis))) goto cleanup;
+	frameMax = vorbis->blockSizes[1] * vorbis->channels;
+
+	for (;;) {
+		if (count + frameMax > capacity) {
+			capacity = max(capacity * 2, frameMax * 8);
+			/* Some platforms can't realloc a NULL pointer */
+			tmp      = samples ? (cc_int16*)Mem_TryRealloc(samples, capacity, 2)
+							   : (cc_int16*)Mem_TryAlloc(capacity, 2);
+			if (!tmp) { res = ERR_OUT_OF_MEMORY; goto cleanup; }
+			samples  = tmp;
+		}
+
+		res = Vorbis_DecodeFrame(vorbis);
+		if (res == ERR_END_OF_STREAM) break;
+		if (res) goto cleanup;
+		count += Vorbis_OutputFrame(vorbis, samples + count);
 	}
+	if (!count) goto cleanup;
+
+	if ((res = Audio_AllocChunks(count * 2, &snd->chunk, 1))) goto cleanup;
+	Mem_Copy(snd->chunk.data, samples, count * 2);
+	snd->channels   = vorbis->channels;
+	snd->sampleRate = vorbis->sampleRate;
+
+cleanup:
+	if (vorbis) Vorbis_Free(vorbis);
+	Mem_Free(vorbis);
+	Mem_Free(ogg);
+	Mem_Free(samples);
+	return res;
+}
 
-	snd = &group->sounds[group->count];
-	res = Sound_ReadWaveData(stream, snd);
+static void Sound_ProcessJob(struct SoundJob* job) {
+	struct Sound* snd = job->snd;
+	cc_result res = ReturnCode_FileNotFound;
+
+	if (snd->cacheKey) res = Sound_ReadCache(snd);
+	if (res && job->data) {
+		res = Sound_DecodeOgg(snd, job->data, job->size);
+		if (!res && snd->cacheKey && Sound_WriteCache(snd)) snd->cacheKey = 0;
+	}
+	if (res) {
+		Platform_Log1("Error %e loading .ogg sound", &res);
+		snd->cacheKey = 0;
+	}
+
+	Mem_Free(job->data);
+	job->data = NULL;
+
+	Mutex_Lock(sound_mutex);
+	{
+		/* Only sounds that can be reloaded from the cache count towards the limit */
+		if (snd->cacheKey) sound_residentBytes += snd->chunk.size;
+		snd->loading = false;
+	}
+	Mutex_Unlock(sound_mutex);
+}
+
+/* NOTE: Must be called while holding sound_mutex once the worker has been started */
+static void Sound_PushJob(struct Sound* snd, cc_uint8* data, cc_uint32 size) {
+	struct SoundJob* job = &sound_jobs[(sound_jobsHead + sound_numJobs) % SOUND_MAX_JOBS];
+	job->snd  = snd;
+	job->data = data;
+	job->size = size;
+
+	snd->loading = true;
+	sound_numJobs++;
+}
+
+static cc_bool Sound_PopJob(struct SoundJob* job) {
+	cc_bool hasJob;
+	Mutex_Lock(sound_mutex);
+	{
+		hasJob = sound_numJobs > 0 && !sound_stopping;
+		if (hasJob) {
+			*job = sound_jobs[sound_jobsHead];
+			sound_jobsHead = (sound_jobsHead + 1) % SOUND_MAX_JOBS;
+			sound_numJobs--;
+		}
+	}
+	Mutex_Unlock(sound_mutex);
+	return hasJob;
+}
+
+static void Sound_ProcessJobs(void) {
+	struct SoundJob job;
+	while (Sound_PopJob(&job)) { Sound_ProcessJob(&job); }
+}
+
+static cc_bool Soundboard_UsesCacheFile(struct Soundboard* board, const cc_string* file) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	struct SoundGroup* group;
+	int i, j;
+	String_InitArray(path, pathBuffer);
+
+	for (i = 0; i < SOUND_COUNT; i++)
+	{
+		group = &board->groups[i];
+		for (j = 0; j < group->count; j++)
+		{
+			if (!group->sounds[j].cacheKey) continue;
+			path.length = 0;
+			Sound_GetCachePath(&path, group->sounds[j].cacheKey);
+			if (String_CaselessEquals(&path, file)) return true;
+		}
+	}
+	return false;
+}
+
+static void Sound_PruneFile(const cc_string* file, void* obj, int isDirectory) {
+	cc_filepath raw;
+	if (isDirectory) return;
+	if (Soundboard_UsesCacheFile(&digBoard, file) || Soundboard_UsesCacheFile(&stepBoard, file)) return;
+
+	Platform_EncodePath(&raw, file);
+	File_Delete(&raw);
+}
+
+/* Deletes cached sounds from previously used sound packs, */
+/*  so the cache is never larger than the current decoded sounds */
+static void Sound_PruneCache(void) {
+	static const cc_string dir = String_FromConst(SOUND_CACHE_DIR);
+	if (Sound_CanCache()) Directory_Enum(&dir, NULL, Sound_PruneFile);
+}
+
+static void Sound_RunWorker(void) {
+	Sound_PruneCache();
+	for (;;)
+	{
+		Sound_ProcessJobs();
+		if (sound_stopping) break;
+		Waitable_Wait(sound_waitable);
+	}
+}
+
+static void Sound_StartWorker(void) {
+	if (!sound_numJobs) return;
+	if (Sound_CanCache()) Utils_EnsureDirectory(SOUND_CACHE_DIR);
+
+	sound_stopping = false;
+	Thread_Run(&sound_thread, Sound_RunWorker, 256 * 1024, "Sound decoder");
+	if (sound_thread) return;
+
+	/* Platform doesn't support threads, so decode everything now */
+	Sound_PruneCache();
+	Sound_ProcessJobs();
+}
+
+static void Sound_StopWorker(void) {
+	int i;
+	sound_stopping = true;
+	if (sound_thread) {
+		Waitable_Signal(sound_waitable);
+		Thread_Join(sound_thread);
+	}
+	sound_thread = NULL;
+
+	for (i = 0; i < sound_numJobs; i++)
+	{
+		Mem_Free(sound_jobs[(sound_jobsHead + i) % SOUND_MAX_JOBS].data);
+	}
+	sound_jobsHead = 0;
+	sound_numJobs  = 0;
+}
+
+static void Sound_QueueOgg(struct Sound* snd, cc_uint8* data, cc_uint32 size) {
+	Sound_PushJob(snd, data, size);
+	snd->cacheKey = Sound_CanCache() ? Utils_CRC32(data, size) : 0;
+}
+
+/* Returns whether the given sound has its samples in memory */
+/*  (and if previously evicted, starts reloading them from the cache) */
+static cc_bool Sound_EnsureResident(struct Sound* snd) {
+	struct SoundJob job;
+	cc_bool loading, reload;
+
+	Mutex_Lock(sound_mutex);
+	{
+		loading = snd->loading;
+		reload  = !loading && !snd->chunk.data && snd->cacheKey;
+		if (reload && sound_thread) Sound_PushJob(snd, NULL, 0);
+	}
+	Mutex_Unlock(sound_mutex);
+
+	if (loading) return false;
+	if (!reload) return snd->chunk.data != NULL;
+
+	/* Avoid stalling the game on disk reads, so this sound is */
+	/*  just skipped until the background thread has reloaded it */
+	if (sound_thread) { Waitable_Signal(sound_waitable); return false; }
+
+	/* Platform doesn't support threads, so reload now */
+	job.snd  = snd;
+	job.data = NULL;
+	job.size = 0;
+	Sound_ProcessJob(&job);
+	return snd->chunk.data != NULL;
+}
+
+static cc_bool Sounds_IsUsing(const void* samples, const void** inUse, int numInUse) {
+	int i;
+	for (i = 0; i < numInUse; i++)
+	{
+		if (inUse[i] == samples) return true;
+	}
+	return false;
+}
+
+static struct Sound* Soundboard_FindEvictable(struct Soundboard* board, struct Sound* best, 
+											const void** inUse, int numInUse) {
+	struct SoundGroup* group;
+	struct Sound* snd;
+	int i, j;
+
+	for (i = 0; i < SOUND_COUNT; i++)
+	{
+		group = &board->groups[i];
+		for (j = 0; j < group->count; j++)
+		{
+			snd = &group->sounds[j];
+			if (!snd->cacheKey || snd->loading || !snd->chunk.data) continue;
+			if (best && snd->lastPlayed >= best->lastPlayed) continue;
+
+			/* Samples must not be freed while backend may still be reading them */
+			if (Sounds_IsUsing(snd->chunk.data, inUse, numInUse)) continue;
+			best = snd;
+		}
+	}
+	return best;
+}
+
+/* Evicts least recently played sounds until within the memory limit */
+static void Sounds_Trim(void) {
+	const void* inUse[AUDIOPOOL_MAX_USING];
+	int numInUse;
+	struct Sound* snd;
+	if (sound_residentBytes <= sound_maxBytes) return;
+
+	/* Only this thread plays sounds, so the snapshot stays valid while trimming */
+	numInUse = AudioPool_GetUsing(inUse);
+
+	Mutex_Lock(sound_mutex);
+	while (sound_residentBytes > sound_maxBytes)
+	{
+		snd = Soundboard_FindEvictable(&digBoard,  NULL, inUse, numInUse);
+		snd = Soundboard_FindEvictable(&stepBoard, snd,  inUse, numInUse);
+		if (!snd) break;
+
+		sound_residentBytes -= snd->chunk.size;
+		Sound_Unload(snd);
+	}
+	Mutex_Unlock(sound_mutex);
+}
+
+static void Soundboard_Load(struct SoundGroup* group, const cc_string* file, struct Stream* stream, struct ZipEntry* source) {
+	struct Sound* snd = &group->sounds[group->count];
+	cc_uint32 size    = source->UncompressedSize;
+	struct Stream mem;
+	cc_uint8* data;
+	cc_result res;
+
+	data = (cc_uint8*)Mem_TryAlloc(size, 1);
+	if (!data) { Logger_SysWarn2(ERR_OUT_OF_MEMORY, "allocating", file); return; }
+
+	if ((res = Stream_Read(stream, data, size))) {
+		Logger_SysWarn2(res, "reading", file);
+		Mem_Free(data); return;
+	}
+
+	/* .ogg sounds are decoded later on the background thread instead */
+	if (size >= 4 && Stream_GetU32_BE(data) == WAV_FourCC('O','g','g','S')) {
+		Sound_QueueOgg(snd, data, size);
+		group->count++; return;
+	}
+
+	Stream_ReadonlyMemory(&mem, data, size);
+	res = Sound_ReadWaveData(&mem, snd);
+	Mem_Free(data);
 
 	if (res) {
 		Logger_SysWarn2(res, "decoding", file);
-		Audio_FreeChunks(&snd->chunk, 1);
-		snd->chunk.data = NULL;
-		snd->chunk.size = 0;
+		Sound_Unload(snd);
 	} else { group->count++; }
 }
 
-static const struct Sound* Soundboard_PickRandom(struct Soundboard* board, cc_uint8 type) {
+static struct Sound* Soundboard_PickRandom(struct Soundboard* board, cc_uint8 type) {
 	struct SoundGroup* group;
+	struct Sound* snd;
 	int idx;
 
 	if (type == SOUND_NONE || type >= SOUND_COUNT) return NULL;
@@ -166,7 +548,11 @@ static const struct Sound* Soundboard_PickRandom(struct Soundboard* board, cc_ui
 	if (!group->count) return NULL;
 
 	idx = Random_Next(&sounds_rnd, group->count);
-	return &group->sounds[idx];
+	snd = &group->sounds[idx];
+	if (!Sound_EnsureResident(snd)) return NULL;
+
+	snd->lastPlayed = Game.Time;
+	return snd;
 }
 
 
@@ -177,7 +563,7 @@ CC_NOINLINE static void Sounds_Fail(cc_result res) {
 }
 
 static void Sounds_Play(cc_uint8 type, struct Soundboard* board) {
-	const struct Sound* snd;
+	struct Sound* snd;
 	struct AudioData data;
 	cc_result res;
 
@@ -203,6 +589,7 @@ static void Sounds_Play(cc_uint8 type, struct Soundboard* board) {
 	
 	res = AudioPool_Play(&data);
 	if (res) Sounds_Fail(res);
+	Sounds_Trim();
 }
 
 static void Audio_PlayBlockSound(void* obj, IVec3 coords, BlockID old, BlockID now) {
@@ -219,9 +606,13 @@ static cc_bool SelectZipEntry(const cc_string* path) { return true; }
 static cc_result ProcessZipEntry(const cc_string* path, struct Stream* stream, struct ZipEntry* source) {
 	static const cc_string dig  = String_FromConst("dig_");
 	static const cc_string step = String_FromConst("step_");
+	struct SoundGroup* group;
 	
-	Soundboard_Load(&digBoard,  &dig,  path, stream);
-	Soundboard_Load(&stepBoard, &step, path, stream);
+	if ((group = Soundboard_FindSlot(&digBoard, &dig, path))) {
+		Soundboard_Load(group, path, stream, source);
+	} else if ((group = Soundboard_FindSlot(&stepBoard, &step, path))) {
+		Soundboard_Load(group, path, stream, source);
+	}
 	return 0;
 }
 
@@ -248,6 +639,7 @@ void Sounds_LoadDefault(void) {
 	cc_result res = Sounds_ExtractZip(&Sounds_ZipPathMC);
 	if (res == ReturnCode_FileNotFound)
 		Sounds_ExtractZip(&Sounds_ZipPathCC);
+	Sound_StartWorker();
 }
 
 static cc_bool sounds_loaded;
@@ -267,10 +659,23 @@ static void Sounds_Stop(void) { AudioPool_Close(); }
 
 static void Sounds_Init(void) {
 	int volume = Options_GetInt(OPT_SOUND_VOLUME, 0, 100, DEFAULT_SOUNDS_VOLUME);
+	int cacheMB = Options_GetInt(OPT_SOUND_CACHE_SIZE, 1, 1024, 32);
+
+	sound_maxBytes = cacheMB * 1024 * 1024;
+	sound_mutex    = Mutex_Create("Sound cache");
+	sound_waitable = Waitable_Create("Sound cache wait");
 	Audio_SetSounds(volume);
 	Event_Register_(&UserEvents.BlockChanged, NULL, Audio_PlayBlockSound);
 }
-static void Sounds_Free(void) { Sounds_Stop(); }
+
+static void Sounds_Free(void) {
+	Sounds_Stop();
+	Sound_StopWorker();
+	Mutex_Free(sound_mutex);
+	Waitable_Free(sound_waitable);
+	sound_mutex    = NULL;
+	sound_waitable = NULL;
+}
 
 void Audio_PlayDigSound(cc_uint8 type)  { Sounds_Play(type, &digBoard); }
 void Audio_PlayStepSound(cc_uint8 type) { Sounds_Play(type, &stepBoard); }
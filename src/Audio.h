@@ -79,6 +79,10 @@ void Audio_Warn(cc_result res, const char* action);
 
 cc_result AudioPool_Play(struct AudioData* data);
 void AudioPool_Close(void);
+#define AUDIOPOOL_MAX_USING 64
+/* Stores the samples that any sound being played may still be reading from, returning how many were stored */
+/* NOTE: samples must have room for AUDIOPOOL_MAX_USING entries */
+int AudioPool_GetUsing(const void** samples);
 
 
 /*########################################################################################################################*
@@ -127,6 +131,9 @@ extern const char* const Sound_Names[SOUND_COUNT];
 struct Sound {
 	int channels, sampleRate;
 	struct AudioChunk chunk;
+	cc_uint32 cacheKey; /* Name of decoded .wav in sound cache, 0 if not cached */
+	double lastPlayed;  /* Game.Time this sound was last played at */
+	cc_bool loading;    /* Whether still being decoded or reloaded on background thread */
 };
 struct SoundGroup {
 	int count;
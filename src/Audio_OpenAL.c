@@ -65,6 +65,7 @@ struct AudioContext {
 };
 
 #define AUDIO_COMMON_ALLOC
+#define AUDIO_SOFTWARE_MIXER
 #include "_AudioBase.h"
 #include "Funcs.h"
 
@@ -26,6 +26,7 @@ struct AudioContext {
 };
 
 #define AUDIO_COMMON_VOLUME
+#define AUDIO_SOFTWARE_MIXER
 #include "_AudioBase.h"
 
 cc_bool AudioBackend_Init(void) { return true; }
@@ -152,9 +152,119 @@ static void Png_ReconstructFirst(cc_uint8 type, cc_uint8 bytesPerPixel, cc_uint8
 	}
 }
 
+/* SSE2 is always available on x86_64, so 3 and 4 byte per pixel filters can be vectorised */
+#ifdef CC_BUILD_SSE2
+#include <emmintrin.h>
+#define PNG_SSE2
+
+static CC_INLINE __m128i Png_Load3(const cc_uint8* p) {
+	return _mm_cvtsi32_si128(p[0] | (p[1] << 8) | (p[2] << 16));
+}
+static CC_INLINE __m128i Png_Load4(const cc_uint8* p) {
+	return _mm_cvtsi32_si128(p[0] | (p[1] << 8) | (p[2] << 16) | ((cc_uint32)p[3] << 24));
+}
+static CC_INLINE void Png_Store3(cc_uint8* p, __m128i v) {
+	cc_uint32 x = (cc_uint32)_mm_cvtsi128_si32(v);
+	p[0] = (cc_uint8)x; p[1] = (cc_uint8)(x >> 8); p[2] = (cc_uint8)(x >> 16);
+}
+static CC_INLINE void Png_Store4(cc_uint8* p, __m128i v) {
+	cc_uint32 x = (cc_uint32)_mm_cvtsi128_si32(v);
+	p[0] = (cc_uint8)x; p[1] = (cc_uint8)(x >> 8); p[2] = (cc_uint8)(x >> 16); p[3] = (cc_uint8)(x >> 24);
+}
+#define Png_Load(bpp, p)     (bpp == 4 ? Png_Load4(p)     : Png_Load3(p))
+#define Png_Store(bpp, p, v) if (bpp == 4) Png_Store4(p, v); else Png_Store3(p, v);
+
+static void Png_Up_SSE2(cc_uint8* line, const cc_uint8* prior, cc_uint32 lineLen) {
+	cc_uint32 i;
+	for (i = 0; i + 16 <= lineLen; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(line  + i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(prior + i));
+		_mm_storeu_si128((__m128i*)(line + i), _mm_add_epi8(a, b));
+	}
+	for (; i < lineLen; i++) { line[i] += prior[i]; }
+}
+
+/* Each pixel depends on the previous one, so only the channels of a pixel are done in parallel */
+static void Png_Sub_SSE2(int bpp, cc_uint8* line, cc_uint32 lineLen) {
+	__m128i a = _mm_setzero_si128();
+	cc_uint32 i;
+
+	for (i = 0; i + bpp <= lineLen; i += bpp) {
+		a = _mm_add_epi8(a, Png_Load(bpp, line + i));
+		Png_Store(bpp, line + i, a);
+	}
+}
+
+static void Png_Average_SSE2(int bpp, cc_uint8* line, const cc_uint8* prior, cc_uint32 lineLen) {
+	__m128i a = _mm_setzero_si128(), b, avg;
+	__m128i ones = _mm_set1_epi8(1);
+	cc_uint32 i;
+
+	for (i = 0; i + bpp <= lineLen; i += bpp) {
+		b   = Png_Load(bpp, prior + i);
+		/* _mm_avg_epu8 rounds up, whereas PNG requires (a + b) >> 1 */
+		avg = _mm_avg_epu8(a, b);
+		avg = _mm_sub_epi8(avg, _mm_and_si128(_mm_xor_si128(a, b), ones));
+
+		a = _mm_add_epi8(avg, Png_Load(bpp, line + i));
+		Png_Store(bpp, line + i, a);
+	}
+}
+
+static void Png_Paeth_SSE2(int bpp, cc_uint8* line, const cc_uint8* prior, cc_uint32 lineLen) {
+	__m128i zero = _mm_setzero_si128();
+	__m128i a = zero, b, c = zero, x;
+	__m128i pa, pb, pc, smallest, nearest, mask;
+	cc_uint32 i;
+
+	/* Works in 16 bit lanes, since the predictor needs 9 bits of precision */
+	for (i = 0; i + bpp <= lineLen; i += bpp) {
+		b = _mm_unpacklo_epi8(Png_Load(bpp, prior + i), zero);
+		x = _mm_unpacklo_epi8(Png_Load(bpp, line  + i), zero);
+
+		/* p = a + b - c, so |p - a| = |b - c|, |p - b| = |a - c|, |p - c| = |(b - c) + (a - c)| */
+		pa = _mm_sub_epi16(b, c);
+		pb = _mm_sub_epi16(a, c);
+		pc = _mm_add_epi16(pa, pb);
+
+		pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+		pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+		pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+		smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+
+		/* Ties resolve in the order a, b, c */
+		mask    = _mm_cmpeq_epi16(smallest, pb);
+		nearest = _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, c));
+		mask    = _mm_cmpeq_epi16(smallest, pa);
+		nearest = _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, nearest));
+
+		c = b;
+		a = _mm_and_si128(_mm_add_epi16(x, nearest), _mm_set1_epi16(0xFF));
+		Png_Store(bpp, line + i, _mm_packus_epi16(a, a));
+	}
+}
+#endif
+
 static void Png_Reconstruct(cc_uint8 type, cc_uint8 bytesPerPixel, cc_uint8* line, cc_uint8* prior, cc_uint32 lineLen) {
 	cc_uint32 i, j;
 
+#ifdef PNG_SSE2
+	if (type == PNG_FILTER_UP) {
+		Png_Up_SSE2(line, prior, lineLen); return;
+	}
+
+	if (bytesPerPixel == 3 || bytesPerPixel == 4) {
+		switch (type) {
+		case PNG_FILTER_SUB:
+			Png_Sub_SSE2(bytesPerPixel, line, lineLen); return;
+		case PNG_FILTER_AVERAGE:
+			Png_Average_SSE2(bytesPerPixel, line, prior, lineLen); return;
+		case PNG_FILTER_PAETH:
+			Png_Paeth_SSE2(bytesPerPixel, line, prior, lineLen); return;
+		}
+	}
+#endif
+
 	switch (type) {
 	case PNG_FILTER_SUB:
 		for (i = bytesPerPixel, j = 0; i < lineLen; i++, j++) {
@@ -292,6 +402,22 @@ static void Png_Expand_GRAYSCALE_A_8(int width, BitmapCol* palette, cc_uint8* sr
 
 static void Png_Expand_RGB_A_8(int width, BitmapCol* palette, cc_uint8* src, BitmapCol* dst) {
 	/* Processed in forward order */
+#if !defined BITMAP_16BPP && !defined CC_BIG_ENDIAN && BITMAPCOLOR_R_SHIFT == 0 && BITMAPCOLOR_G_SHIFT == 8 && BITMAPCOLOR_B_SHIFT == 16 && BITMAPCOLOR_A_SHIFT == 24
+	/* Bitmap already has same byte order as PNG */
+	Mem_Move(dst, src, width * 4);
+	return;
+#elif defined PNG_SSE2 && !defined BITMAP_16BPP && BITMAPCOLOR_B_SHIFT == 0 && BITMAPCOLOR_G_SHIFT == 8 && BITMAPCOLOR_R_SHIFT == 16 && BITMAPCOLOR_A_SHIFT == 24
+	/* Only R and B need to be swapped. dst is never after src, so loading before storing is safe */
+	__m128i ga = _mm_set1_epi32(0xFF00FF00), rb;
+	for (; width >= 4; width -= 4) {
+		__m128i v = _mm_loadu_si128((const __m128i*)src);
+		rb = _mm_andnot_si128(ga, v);
+		rb = _mm_shufflehi_epi16(_mm_shufflelo_epi16(rb, 0xB1), 0xB1);
+
+		_mm_storeu_si128((__m128i*)dst, _mm_or_si128(_mm_and_si128(v, ga), rb));
+		dst += 4; src += 16;
+	}
+#endif
 
 	for (; width >= 4; width -= 4) {
 		PNG_Do_RGB_A__8(); PNG_Do_RGB_A__8();
@@ -780,8 +906,10 @@ static cc_result Png_EncodeCore(struct Bitmap* bmp, struct Stream* stream, cc_ui
 cc_result Png_Encode(struct Bitmap* bmp, struct Stream* stream, 
 					Png_RowGetter getRow, cc_bool alpha, void* ctx) {
 	cc_result res;
+	cc_uint8* buffer;
+
 	/* Add 1 for scanline filter type byter */
-	cc_uint8* buffer = (cc_uint8*)Mem_TryAlloc(3, bmp->width * 4 + 1);
+	buffer = (cc_uint8*)Mem_TryAlloc(3, bmp->width * 4 + 1);
 	if (!buffer) return ERR_NOT_SUPPORTED;
 
 	res = Png_EncodeCore(bmp, stream, buffer, getRow, alpha, ctx);
@@ -13,6 +13,11 @@
 #include "TexturePack.h"
 #include "Game.h"
 #include "Options.h"
+#include "Stream.h"
+#include "Utils.h"
+#include "Event.h"
+#include "Errors.h"
+#include "String_.h"
 
 int Builder_SidesLevel, Builder_EdgeLevel;
 /* Packs an index into the 16x16x16 count array. Coordinates range from 0 to 15. */
@@ -27,7 +32,7 @@ static int Builder_X, Builder_Y, Builder_Z;
 static BlockID Builder_Block;
 static int Builder_ChunkIndex;
 static cc_bool Builder_FullBright;
-static int Builder_ChunkEndX, Builder_ChunkEndZ;
+static int Builder_ChunkEndX, Builder_ChunkEndY, Builder_ChunkEndZ;
 static int Builder_Offsets[FACE_COUNT] = { -1,1, -EXTCHUNK_SIZE,EXTCHUNK_SIZE, -EXTCHUNK_SIZE_2,EXTCHUNK_SIZE_2 };
 
 static int (*Builder_StretchXLiquid)(int countIndex, int x, int y, int z, int chunkIndex, BlockID block);
@@ -86,6 +91,397 @@ static int Builder_TotalVerticesCount(void) {
 }
 
 
+/*########################################################################################################################*
+*----------------------------------------------------Chunk mesh cache-----------------------------------------------------*
+*#########################################################################################################################*/
+/* Built chunk meshes are optionally appended to a cache file, keyed by a hash of everything a mesh depends on */
+/*  (i.e. the chunk's blocks and borders, their lighting, block definitions and texture atlas layout) */
+/* When the cache file would exceed its maximum size, it is simply discarded and started over */
+#if !defined CC_BUILD_LOWMEM && CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
+#define CC_BUILD_MESHCACHE
+#define MESHCACHE_VERSION 1
+#define MESHCACHE_HEADER_SIZE 12
+#define MESHCACHE_RECORD_SIZE 16
+#define MESHCACHE_PART_SIZE 22
+#define MESHCACHE_TRANSLUCENT 0x8000
+/* Upper bound on vertices in a chunk mesh, i.e. every face of every block drawn */
+#define MESHCACHE_MAX_VERTICES (CHUNK_SIZE_3 * FACE_COUNT * 4)
+#define FNV64_OFFSET 0xCBF29CE484222325ULL
+#define FNV64_PRIME  0x00000100000001B3ULL
+
+struct MeshCacheSlot { cc_uint64 key; cc_uint32 offset; };
+/* Hash table of the offset of each mesh in the cache file */
+static struct MeshCacheSlot* meshCache_slots;
+static int meshCache_capacity, meshCache_count;
+
+static cc_file meshCache_file;
+static cc_bool meshCache_enabled;
+static cc_uint32 meshCache_end, meshCache_maxSize;
+static cc_filepath meshCache_path;
+/* Hash of block definitions, 0 if needs to be recalculated */
+static cc_uint64 meshCache_blocksHash;
+
+/* Chunks are built into this buffer instead, as vertex buffer memory may not be readable */
+static struct VertexTextured* meshCache_vertices;
+static int meshCache_verticesCount;
+static cc_uint8 meshCache_parts[MESHCACHE_PART_SIZE * ATLAS1D_MAX_ATLASES * 2];
+
+static cc_uint64 MeshCache_Hash(cc_uint64 hash, const void* data, cc_uint32 len) {
+	const cc_uint8* src = (const cc_uint8*)data;
+	cc_uint32 i;
+
+	for (i = 0; i < len; i++) {
+		hash = (hash ^ src[i]) * FNV64_PRIME;
+	}
+	return hash;
+}
+
+static cc_uint64 MeshCache_CalcKey(int x1, int y1, int z1) {
+	cc_uint64 hash;
+	int state[16];
+	int x, y, z;
+	PackedCol col;
+
+	if (!meshCache_blocksHash) {
+		meshCache_blocksHash = MeshCache_Hash(FNV64_OFFSET, &Blocks, sizeof(Blocks));
+	}
+
+	state[0]  = x1; state[1] = y1; state[2] = z1;
+	state[3]  = World.Width; state[4] = World.Height; state[5] = World.Length;
+	state[6]  = Builder_SidesLevel;
+	state[7]  = Builder_EdgeLevel;
+	state[8]  = Builder_SmoothLighting;
+	state[9]  = Builder_GreedyMeshing;
+	state[10] = Lighting_Mode;
+	state[11] = Atlas1D.TilesPerAtlas | (Atlas1D.Repeats << 16);
+	state[12] = MapRenderer_1DUsedCount;
+	state[13] = Env.SunCol;
+	state[14] = Env.ShadowCol;
+	state[15] = World.ChunksCount;
+
+	hash = MeshCache_Hash(meshCache_blocksHash, state, sizeof(state));
+	hash = MeshCache_Hash(hash, Builder_Chunk, EXTCHUNK_SIZE_3 * sizeof(BlockID));
+
+	/* All the other lighting colours are derived from the same light levels */
+	for (y = y1 - 1; y <= y1 + CHUNK_SIZE; y++) {
+		for (z = z1 - 1; z <= z1 + CHUNK_SIZE; z++) {
+			for (x = x1 - 1; x <= x1 + CHUNK_SIZE; x++) {
+				col  = Lighting.Color(x, y, z);
+				hash = MeshCache_Hash(hash, &col, sizeof(col));
+			}
+		}
+	}
+	return hash ? hash : 1;
+}
+
+static struct MeshCacheSlot* MeshCache_Find(cc_uint64 key) {
+	int i, mask = meshCache_capacity - 1;
+	if (!meshCache_capacity) return NULL;
+
+	for (i = (int)(key & mask); meshCache_slots[i].key; i = (i + 1) & mask) 
+	{
+		if (meshCache_slots[i].key == key) return &meshCache_slots[i];
+	}
+	return NULL;
+}
+
+static void MeshCache_Insert(cc_uint64 key, cc_uint32 offset);
+static void MeshCache_Grow(void) {
+	struct MeshCacheSlot* slots = meshCache_slots;
+	int i, capacity = meshCache_capacity;
+
+	meshCache_capacity = max(1024, capacity * 2);
+	meshCache_slots    = (struct MeshCacheSlot*)Mem_AllocCleared(meshCache_capacity, 
+										sizeof(struct MeshCacheSlot), "mesh cache slots");
+	meshCache_count    = 0;
+
+	for (i = 0; i < capacity; i++) 
+	{
+		if (slots[i].key) MeshCache_Insert(slots[i].key, slots[i].offset);
+	}
+	Mem_Free(slots);
+}
+
+static void MeshCache_Insert(cc_uint64 key, cc_uint32 offset) {
+	int i, mask;
+	if ((meshCache_count + 1) * 2 > meshCache_capacity) MeshCache_Grow();
+	mask = meshCache_capacity - 1;
+
+	for (i = (int)(key & mask); meshCache_slots[i].key; i = (i + 1) & mask) 
+	{
+		if (meshCache_slots[i].key == key) break;
+	}
+
+	if (!meshCache_slots[i].key) meshCache_count++;
+	meshCache_slots[i].key    = key;
+	meshCache_slots[i].offset = offset;
+}
+
+static cc_result MeshCache_ReadAll(void* data, cc_uint32 count) {
+	cc_uint8* dst = (cc_uint8*)data;
+	cc_uint32 read;
+	cc_result res;
+
+	while (count) {
+		if ((res = File_Read(meshCache_file, dst, count, &read))) return res;
+		if (!read) return ERR_END_OF_STREAM;
+		dst += read; count -= read;
+	}
+	return 0;
+}
+
+static cc_result MeshCache_WriteAll(const void* data, cc_uint32 count) {
+	const cc_uint8* src = (const cc_uint8*)data;
+	cc_uint32 wrote;
+	cc_result res;
+
+	while (count) {
+		if ((res = File_Write(meshCache_file, src, count, &wrote))) return res;
+		if (!wrote) return ERR_END_OF_STREAM;
+		src += wrote; count -= wrote;
+	}
+	return 0;
+}
+
+static void MeshCache_Disable(void) {
+	if (meshCache_enabled) File_Close(meshCache_file);
+	meshCache_enabled = false;
+
+	Mem_Free(meshCache_slots);
+	meshCache_slots    = NULL;
+	meshCache_capacity = 0;
+	meshCache_count    = 0;
+}
+
+/* Discards all cached meshes and starts a new cache file */
+static void MeshCache_Reset(void) {
+	cc_uint8 header[MESHCACHE_HEADER_SIZE];
+	cc_file file;
+
+	File_Close(meshCache_file);
+	meshCache_enabled = false;
+	if (!File_Create(&file, &meshCache_path)) File_Close(file);
+
+	if (File_OpenOrCreate(&meshCache_file, &meshCache_path)) { MeshCache_Disable(); return; }
+	meshCache_enabled = true;
+
+	if (meshCache_slots) Mem_Set(meshCache_slots, 0, meshCache_capacity * sizeof(struct MeshCacheSlot));
+	meshCache_count = 0;
+	meshCache_end   = MESHCACHE_HEADER_SIZE;
+
+	header[0] = 'C'; header[1] = 'C'; header[2] = 'M'; header[3] = 'C';
+	Stream_SetU32_LE(header + 4, MESHCACHE_VERSION);
+	Stream_SetU32_LE(header + 8, sizeof(struct VertexTextured));
+	if (MeshCache_WriteAll(header, MESHCACHE_HEADER_SIZE)) MeshCache_Disable();
+}
+
+/* Finds the location of all the meshes in the cache file */
+static void MeshCache_Scan(void) {
+	cc_uint8 header[MESHCACHE_RECORD_SIZE];
+	cc_uint32 len, pos, size;
+	cc_uint64 key;
+
+	if (File_Length(meshCache_file, &len)) { MeshCache_Reset(); return; }
+	pos = MESHCACHE_HEADER_SIZE;
+
+	while (pos + MESHCACHE_RECORD_SIZE <= len) {
+		if (File_Seek(meshCache_file, pos, FILE_SEEKFROM_BEGIN))  break;
+		if (MeshCache_ReadAll(header, MESHCACHE_RECORD_SIZE)) break;
+
+		key  = Stream_GetU32_LE(header) | ((cc_uint64)Stream_GetU32_LE(header + 4) << 32);
+		size = MESHCACHE_RECORD_SIZE + Stream_GetU16_LE(header + 12) * MESHCACHE_PART_SIZE
+				+ Stream_GetU32_LE(header + 8) * sizeof(struct VertexTextured);
+		/* A partially written mesh at the end just gets overwritten */
+		if (!key || pos + size > len) break;
+
+		MeshCache_Insert(key, pos);
+		pos += size;
+	}
+	meshCache_end = pos;
+}
+
+static void MeshCache_Init(void) {
+	static const cc_string path = String_FromConst("texturecache/meshes.bin");
+	cc_uint8 header[MESHCACHE_HEADER_SIZE];
+
+	if (!Options_GetBool(OPT_MESH_CACHE, false) || Platform_ReadonlyFilesystem) return;
+	meshCache_maxSize = Options_GetInt(OPT_MESH_CACHE_SIZE, 16, 1024, 256) * 1024 * 1024;
+	if (!Utils_EnsureDirectory("texturecache")) return;
+
+	Platform_EncodePath(&meshCache_path, &path);
+	if (File_OpenOrCreate(&meshCache_file, &meshCache_path)) return;
+	meshCache_enabled = true;
+
+	if (MeshCache_ReadAll(header, MESHCACHE_HEADER_SIZE) || !(header[0] == 'C' && header[1] == 'C' 
+			&& header[2] == 'M' && header[3] == 'C') || Stream_GetU32_LE(header + 4) != MESHCACHE_VERSION
+			|| Stream_GetU32_LE(header + 8) != sizeof(struct VertexTextured)) {
+		MeshCache_Reset();
+	} else {
+		MeshCache_Scan();
+	}
+}
+
+static void MeshCache_ReadPart(const cc_uint8* data, struct ChunkPartInfo* part) {
+	int i;
+	part->offset      = (int)Stream_GetU32_LE(data + 2);
+	part->spriteCount = (int)Stream_GetU32_LE(data + 6);
+
+	for (i = 0; i < FACE_COUNT; i++) {
+		part->counts[i] = Stream_GetU16_LE(data + 10 + i * 2);
+	}
+}
+
+/* Whether the vertices a cached part covers are all within the mesh's vertices */
+static cc_bool MeshCache_ValidPart(const cc_uint8* data, cc_uint32 vertices) {
+	cc_uint32 offset      = Stream_GetU32_LE(data + 2);
+	cc_uint32 spriteCount = Stream_GetU32_LE(data + 6);
+	cc_uint32 total;
+	int i;
+
+	if (offset > vertices || spriteCount > vertices || (spriteCount & 3)) return false;
+	total = offset + spriteCount;
+
+	for (i = 0; i < FACE_COUNT; i++) {
+		total += Stream_GetU16_LE(data + 10 + i * 2);
+	}
+	return total <= vertices;
+}
+
+/* Attempts to load the mesh of the given chunk from the cache */
+static cc_bool MeshCache_Load(cc_uint64 key, int x1, int y1, int z1, struct ChunkInfo* info) {
+	struct MeshCacheSlot* slot = MeshCache_Find(key);
+	cc_uint8 header[MESHCACHE_RECORD_SIZE];
+	struct ChunkPartInfo* part;
+	struct VertexTextured* data;
+	int i, partsIndex, batch, count, vertices;
+	cc_uint8* src;
+	cc_result res;
+
+	if (!slot) return false;
+	if (File_Seek(meshCache_file, slot->offset, FILE_SEEKFROM_BEGIN)) return false;
+	if (MeshCache_ReadAll(header, MESHCACHE_RECORD_SIZE)) return false;
+
+	/* Record might have been overwritten or corrupted since the file was scanned */
+	if (Stream_GetU32_LE(header) != (cc_uint32)key || Stream_GetU32_LE(header + 4) != (cc_uint32)(key >> 32)) return false;
+
+	if (Stream_GetU32_LE(header + 8) > MESHCACHE_MAX_VERTICES) return false;
+	vertices = Stream_GetU32_LE(header + 8);
+	count    = Stream_GetU16_LE(header + 12);
+	if (count > ATLAS1D_MAX_ATLASES * 2) return false;
+	if (MeshCache_ReadAll(meshCache_parts, count * MESHCACHE_PART_SIZE)) return false;
+
+	/* Reject the whole record before changing any parts */
+	for (i = 0, src = meshCache_parts; i < count; i++, src += MESHCACHE_PART_SIZE) {
+		batch = Stream_GetU16_LE(src) & ~MESHCACHE_TRANSLUCENT;
+		if (batch >= MapRenderer_1DUsedCount)         return false;
+		if (!MeshCache_ValidPart(src, vertices))      return false;
+	}
+
+	partsIndex = World_ChunkPack(x1 >> CHUNK_SHIFT, y1 >> CHUNK_SHIFT, z1 >> CHUNK_SHIFT);
+	for (i = 0; i < MapRenderer_1DUsedCount; i++) {
+		MapRenderer_PartsNormal[partsIndex + i * World.ChunksCount].offset      = -1;
+		MapRenderer_PartsTranslucent[partsIndex + i * World.ChunksCount].offset = -1;
+	}
+
+	for (i = 0, src = meshCache_parts; i < count; i++, src += MESHCACHE_PART_SIZE) {
+		batch = Stream_GetU16_LE(src) & ~MESHCACHE_TRANSLUCENT;
+
+		if (Stream_GetU16_LE(src) & MESHCACHE_TRANSLUCENT) {
+			part = &MapRenderer_PartsTranslucent[partsIndex + batch * World.ChunksCount];
+			info->translucentParts = &MapRenderer_PartsTranslucent[partsIndex];
+		} else {
+			part = &MapRenderer_PartsNormal[partsIndex + batch * World.ChunksCount];
+			info->normalParts      = &MapRenderer_PartsNormal[partsIndex];
+		}
+		MeshCache_ReadPart(src, part);
+	}
+	if (!vertices) return true;
+
+	/* add an extra element to fix crashing on some GPUs */
+	info->vb = Gfx_CreateVb(VERTEX_FORMAT_TEXTURED, vertices + 1);
+	data     = (struct VertexTextured*)Gfx_LockVb(info->vb, VERTEX_FORMAT_TEXTURED, vertices + 1);
+	res      = MeshCache_ReadAll(data, vertices * sizeof(struct VertexTextured));
+	Gfx_UnlockVb(info->vb);
+	if (!res) return true;
+
+	Gfx_DeleteVb(&info->vb);
+	info->normalParts      = NULL;
+	info->translucentParts = NULL;
+	return false;
+}
+
+static int MeshCache_WriteParts(struct ChunkPartInfo* parts, int flags, cc_uint8* dst) {
+	struct ChunkPartInfo* part;
+	int i, j, count = 0;
+	if (!parts) return 0;
+
+	for (i = 0; i < MapRenderer_1DUsedCount; i++) {
+		part = &parts[i * World.ChunksCount];
+		if (part->offset < 0) continue;
+
+		Stream_SetU16_LE(dst + 0, i | flags);
+		Stream_SetU32_LE(dst + 2, part->offset);
+		Stream_SetU32_LE(dst + 6, part->spriteCount);
+		for (j = 0; j < FACE_COUNT; j++) {
+			Stream_SetU16_LE(dst + 10 + j * 2, part->counts[j]);
+		}
+		dst += MESHCACHE_PART_SIZE; count++;
+	}
+	return count;
+}
+
+/* Appends the mesh of the given chunk to the cache */
+static void MeshCache_Save(cc_uint64 key, struct ChunkInfo* info, struct VertexTextured* vertices, int vCount) {
+	cc_uint8 header[MESHCACHE_RECORD_SIZE];
+	cc_uint32 size;
+	int count;
+
+	count  = MeshCache_WriteParts(info->normalParts, 0, meshCache_parts);
+	count += MeshCache_WriteParts(info->translucentParts, MESHCACHE_TRANSLUCENT, 
+									meshCache_parts + count * MESHCACHE_PART_SIZE);
+	size   = MESHCACHE_RECORD_SIZE + count * MESHCACHE_PART_SIZE + vCount * sizeof(struct VertexTextured);
+
+	if (meshCache_end + size > meshCache_maxSize) MeshCache_Reset();
+	if (!meshCache_enabled) return;
+
+	Stream_SetU32_LE(header + 0,  (cc_uint32)key);
+	Stream_SetU32_LE(header + 4,  (cc_uint32)(key >> 32));
+	Stream_SetU32_LE(header + 8,  vCount);
+	Stream_SetU16_LE(header + 12, count);
+	Stream_SetU16_LE(header + 14, 0);
+
+	if (File_Seek(meshCache_file, meshCache_end, FILE_SEEKFROM_BEGIN)
+		|| MeshCache_WriteAll(header, MESHCACHE_RECORD_SIZE)
+		|| MeshCache_WriteAll(meshCache_parts, count * MESHCACHE_PART_SIZE)
+		|| MeshCache_WriteAll(vertices, vCount * sizeof(struct VertexTextured))) {
+		MeshCache_Disable(); return;
+	}
+
+	MeshCache_Insert(key, meshCache_end);
+	meshCache_end += size;
+}
+
+/* Returns a buffer for building the vertices of a chunk into, NULL if not enough memory */
+static struct VertexTextured* MeshCache_GetVertices(int count) {
+	if (count > meshCache_verticesCount) {
+		Mem_Free(meshCache_vertices);
+		meshCache_vertices      = (struct VertexTextured*)Mem_TryAlloc(count, sizeof(struct VertexTextured));
+		meshCache_verticesCount = meshCache_vertices ? count : 0;
+	}
+	return meshCache_vertices;
+}
+
+static void MeshCache_Free(void) {
+	MeshCache_Disable();
+	Mem_Free(meshCache_vertices);
+	meshCache_vertices      = NULL;
+	meshCache_verticesCount = 0;
+}
+
+static void MeshCache_InvalidateBlocks(void* obj) { meshCache_blocksHash = 0; }
+#endif
+
+
 /*########################################################################################################################*
 *----------------------------------------------------Base mesh builder----------------------------------------------------*
 *#########################################################################################################################*/
@@ -381,6 +777,10 @@ void Builder_MakeChunk(struct ChunkInfo* info) {
 	int cIndex, index;
 	int x, y, z, xx, yy, zz;
 	int x1 = info->centreX - 8, y1 = info->centreY - 8, z1 = info->centreZ - 8;
+#ifdef CC_BUILD_MESHCACHE
+	struct VertexTextured* vertices = NULL;
+	cc_uint64 key = 0;
+#endif
 
 	Builder_Chunk  = chunk;
 	Builder_Counts = counts;
@@ -403,15 +803,25 @@ void Builder_MakeChunk(struct ChunkInfo* info) {
 	if (allAir || allSolid) return;
 	Lighting.LightHint(x1 - 1, y1 - 1, z1 - 1);
 
+#ifdef CC_BUILD_MESHCACHE
+	if (meshCache_enabled) {
+		key = MeshCache_CalcKey(x1, y1, z1);
+		if (MeshCache_Load(key, x1, y1, z1, info)) return;
+	}
+#endif
+
 	Mem_Set(counts, 1, CHUNK_SIZE_3 * FACE_COUNT);
 	xMax = min(World.Width,  x1 + CHUNK_SIZE);
 	yMax = min(World.Height, y1 + CHUNK_SIZE);
 	zMax = min(World.Length, z1 + CHUNK_SIZE);
 
-	Builder_ChunkEndX = xMax; Builder_ChunkEndZ = zMax;
+	Builder_ChunkEndX = xMax; Builder_ChunkEndY = yMax; Builder_ChunkEndZ = zMax;
 	PrepareChunk(x1, y1, z1);
 
 	totalVerts = Builder_TotalVerticesCount();
+#ifdef CC_BUILD_MESHCACHE
+	if (!totalVerts && key) MeshCache_Save(key, info, NULL, 0);
+#endif
 	if (!totalVerts) return;
 	
 	OutputChunkPartsMeta(x1, y1, z1, info);
@@ -425,6 +835,13 @@ void Builder_MakeChunk(struct ChunkInfo* info) {
 	info->vb = Gfx_CreateVb(VERTEX_FORMAT_TEXTURED, totalVerts + 1);
 	Builder_Vertices = (struct VertexTextured*)Gfx_LockVb(info->vb,
 													VERTEX_FORMAT_TEXTURED, totalVerts + 1);
+#ifdef CC_BUILD_MESHCACHE
+	/* Build into system memory instead, so the vertices can also be written to the cache */
+	if (key && MeshCache_GetVertices(totalVerts)) {
+		vertices         = Builder_Vertices;
+		Builder_Vertices = meshCache_vertices;
+	}
+#endif
 #else
 	/* NOTE: Relies on assumption vb is ignored by GL11 Gfx_LockVb implementation */
 	Builder_Vertices = (struct VertexTextured*)Gfx_LockVb(0, 
@@ -458,6 +875,12 @@ void Builder_MakeChunk(struct ChunkInfo* info) {
 		BuildPartVbs(&MapRenderer_PartsTranslucent[curIdx]);
 	}
 #else
+#ifdef CC_BUILD_MESHCACHE
+	if (vertices) {
+		Mem_Copy(vertices, meshCache_vertices, totalVerts * sizeof(struct VertexTextured));
+		MeshCache_Save(key, info, meshCache_vertices, totalVerts);
+	}
+#endif
 	Gfx_UnlockVb(info->vb);
 #endif
 }
@@ -771,6 +1194,152 @@ static void NormalBuilder_SetActive(void) {
 }
 
 
+/*########################################################################################################################*
+*--------------------------------------------------Greedy mesh builder----------------------------------------------------*
+*#########################################################################################################################*/
+#ifndef CC_BUILD_LOWMEM
+/* Number of rows each stretched face was merged across, along the face's second axis */
+static CC_BIG_VAR cc_uint8 Greedy_Rows[CHUNK_SIZE_3 * FACE_COUNT];
+/* Whether merged faces can repeat their texture vertically (i.e. 1D atlases contain copies of each tile) */
+static cc_bool greedy_active;
+
+static cc_bool Greedy_BorderHidden(int x, int y, int z, BlockID block, Face face) {
+	cc_bool belowEdge = y < Builder_SidesLevel || 
+		(block >= BLOCK_WATER && block <= BLOCK_STILL_LAVA && y < Builder_EdgeLevel);
+
+	switch (face) {
+	case FACE_XMIN: return x == 0          && belowEdge;
+	case FACE_XMAX: return x == World.MaxX && belowEdge;
+	case FACE_ZMIN: return z == 0          && belowEdge;
+	case FACE_ZMAX: return z == World.MaxZ && belowEdge;
+	case FACE_YMIN: return y == 0;
+	}
+	return false;
+}
+
+/* Whether the given face can be merged into the face currently being stretched */
+static cc_bool Greedy_CanMerge(BlockID block, int chunkIndex, int countIndex, int x, int y, int z, Face face) {
+	/* Face might have already been merged into a face from an earlier row */
+	if (!Builder_Counts[countIndex]) return false;
+	if (!Normal_CanStretch(block, chunkIndex, x, y, z, face)) return false;
+
+	if (face == FACE_YMAX && block >= BLOCK_WATER && block <= BLOCK_STILL_LAVA
+		&& Builder_OccludedLiquid(chunkIndex)) return false;
+	return !Greedy_BorderHidden(x, y, z, block, face);
+}
+
+/* Stretches a face along X (or Z for X faces), then merges following rows along Z (Y faces) or Y (side faces) */
+static int Greedy_Stretch(int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
+	int rx = face >= FACE_ZMIN, rz = !rx;
+	int ey = face < FACE_YMIN,  ez = !ey;
+	int runChunk = rx + rz * EXTCHUNK_SIZE;
+	int runCount = (rx + rz * CHUNK_SIZE) * FACE_COUNT;
+	int rowChunk = ez * EXTCHUNK_SIZE + ey * EXTCHUNK_SIZE_2;
+	int rowCount = (ez * CHUNK_SIZE + ey * CHUNK_SIZE * CHUNK_SIZE) * FACE_COUNT;
+	int count = 1, rows = 1, i;
+	cc_bool stretchTile, merge;
+
+	stretchTile = (Blocks.CanStretch[block] & (1 << face)) != 0;
+	while (stretchTile) {
+		if (x + rx * count >= Builder_ChunkEndX || z + rz * count >= Builder_ChunkEndZ) break;
+		if (!Greedy_CanMerge(block, chunkIndex + runChunk * count, countIndex + runCount * count,
+							x + rx * count, y, z + rz * count, face)) break;
+
+		Builder_Counts[countIndex + runCount * count] = 0;
+		count++;
+	}
+
+	/* Side faces can only be merged vertically when they span the full height of the block */
+	/*  (and similarly for top/bottom faces along the Z axis) */
+	if (ey) {
+		merge = Blocks.MinBB[block].y == 0.0f && Blocks.MaxBB[block].y == 1.0f;
+	} else {
+		merge = Blocks.MinBB[block].z == 0.0f && Blocks.MaxBB[block].z == 1.0f;
+	}
+	merge &= stretchTile && greedy_active;
+
+	/* Merged faces can only repeat the texture as many times as there are copies of the tile */
+	while (merge && rows < Atlas1D.Repeats && y + ey * rows < Builder_ChunkEndY && z + ez * rows < Builder_ChunkEndZ) {
+		for (i = 0; i < count; i++) {
+			if (!Greedy_CanMerge(block, chunkIndex + rowChunk * rows + runChunk * i, 
+								countIndex + rowCount * rows + runCount * i,
+								x + rx * i, y + ey * rows, z + ez * rows + rz * i, face)) break;
+		}
+		if (i < count) break;
+
+		for (i = 0; i < count; i++) {
+			Builder_Counts[countIndex + rowCount * rows + runCount * i] = 0;
+		}
+		rows++;
+	}
+
+	Greedy_Rows[countIndex] = rows;
+	AddVertices(block, face);
+	return count;
+}
+
+static int GreedyBuilder_StretchXLiquid(int countIndex, int x, int y, int z, int chunkIndex, BlockID block) {
+	if (Builder_OccludedLiquid(chunkIndex)) return 0;
+	return Greedy_Stretch(countIndex, x, y, z, chunkIndex, block, FACE_YMAX);
+}
+
+static int GreedyBuilder_StretchX(int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
+	return Greedy_Stretch(countIndex, x, y, z, chunkIndex, block, face);
+}
+
+static int GreedyBuilder_StretchZ(int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
+	return Greedy_Stretch(countIndex, x, y, z, chunkIndex, block, face);
+}
+
+static void GreedyBuilder_RenderBlock(int index, int x, int y, int z) {
+	struct Builder1DPart* part;
+	struct VertexTextured* v;
+	int baseOffset, face, rows, i;
+	float span;
+
+	NormalBuilder_RenderBlock(index, x, y, z);
+	if (Blocks.Draw[Builder_Block] == DRAW_SPRITE) return;
+	baseOffset = (Blocks.Draw[Builder_Block] == DRAW_TRANSLUCENT) * ATLAS1D_MAX_ATLASES;
+
+	/* Extend the quads just output across the merged rows, spanning the following copies of the tile */
+	for (face = 0; face < FACE_COUNT; face++) {
+		if (!Builder_Counts[index + face]) continue;
+		rows = Greedy_Rows[index + face] - 1;
+		if (!rows) continue;
+
+		part = &Builder_Parts[baseOffset + Atlas1D_Index(Block_Tex(Builder_Block, face))];
+		v    = part->faces.vertices[face] - 4;
+		span = rows * Atlas1D.InvTileSize;
+
+		for (i = 0; i < 4; i++, v++) {
+			if (face >= FACE_YMIN) {
+				if (v->z == Drawer.Z2) { v->z += rows; v->V += span; }
+			} else {
+				/* Top of side faces uses the first copy of the tile */
+				if (v->y == Drawer.Y2) { v->y += rows; } else { v->V += span; }
+			}
+		}
+	}
+}
+
+static void Greedy_PrePrepareChunk(void) {
+	DefaultPrePrepateChunk();
+	greedy_active = Atlas1D.Repeats > 1;
+}
+
+static void GreedyBuilder_SetActive(void) {
+	Builder_SetDefault();
+	Builder_StretchXLiquid  = GreedyBuilder_StretchXLiquid;
+	Builder_StretchX        = GreedyBuilder_StretchX;
+	Builder_StretchZ        = GreedyBuilder_StretchZ;
+	Builder_RenderBlock     = GreedyBuilder_RenderBlock;
+	Builder_PrePrepareChunk = Greedy_PrePrepareChunk;
+}
+#else
+static void GreedyBuilder_SetActive(void) { NormalBuilder_SetActive(); }
+#endif
+
+
 /*########################################################################################################################*
 *-------------------------------------------------Advanced mesh builder---------------------------------------------------*
 *#########################################################################################################################*/
@@ -1625,10 +2194,221 @@ static void ModernBuilder_SetActive(void) {
 static void ModernBuilder_SetActive(void) { NormalBuilder_SetActive(); }
 #endif
 
+/*########################################################################################################################*
+*---------------------------------------------------Low detail builder----------------------------------------------------*
+*#########################################################################################################################*/
+#ifdef CC_BUILD_LODMESHES
+#define LOD_STRIDE (LODMESH_MAX_SIZE + 2)
+/* Height of the topmost surface and topmost block of each column of blocks */
+/* NOTE: Includes the columns just outside the area, for sealing gaps at the edges */
+static cc_uint16 lod_heights[LOD_STRIDE * LOD_STRIDE];
+static BlockID   lod_blocks[LOD_STRIDE * LOD_STRIDE];
+/* Height of the topmost surface of each cell */
+static cc_uint16 lod_tops[LODMESH_MAX_SIZE * LODMESH_MAX_SIZE];
+static int lod_counts[ATLAS1D_MAX_ATLASES];
+static struct VertexTextured* lod_vertices[ATLAS1D_MAX_ATLASES];
+
+static int lod_width, lod_length, lod_cellsX, lod_cellsZ, lod_scale;
+static int lod_x1, lod_z1;
+
+static void Lod_CalcHeights(void) {
+	int x, y, z, i = 0;
+	BlockID b;
+
+	for (z = lod_z1 - 1; z <= lod_z1 + lod_length; z++) {
+		for (x = lod_x1 - 1; x <= lod_x1 + lod_width; x++, i++) {
+			/* Area outside the map is hidden below the map sides */
+			lod_heights[i] = Builder_SidesLevel;
+			lod_blocks[i]  = BLOCK_AIR;
+			if (!World_ContainsXZ(x, z)) continue;
+
+			lod_heights[i] = 0;
+			for (y = World.MaxY; y >= 0; y--) {
+				b = World_GetBlock(x, y, z);
+				if (Blocks.Draw[b] == DRAW_GAS || Blocks.Draw[b] == DRAW_SPRITE) continue;
+
+				lod_heights[i] = y + 1;
+				lod_blocks[i]  = b;
+				break;
+			}
+		}
+	}
+}
+
+/* Calculates the height of each cell, which is the height of the highest column in that cell */
+static void Lod_CalcCells(void) {
+	int cx, cz, x, z, i, maxX, maxZ;
+	int top;
+
+	for (cz = 0; cz < lod_cellsZ; cz++) {
+		for (cx = 0; cx < lod_cellsX; cx++) {
+			maxX = min((cx + 1) * lod_scale, lod_width);
+			maxZ = min((cz + 1) * lod_scale, lod_length);
+			top  = 0;
+
+			for (z = cz * lod_scale; z < maxZ; z++) {
+				for (x = cx * lod_scale; x < maxX; x++) {
+					i   = (z + 1) * LOD_STRIDE + (x + 1);
+					top = max(top, lod_heights[i]);
+				}
+			}
+			lod_tops[cz * lod_cellsX + cx] = top;
+		}
+	}
+}
+
+/* Returns the block of the highest column in the given cell */
+static BlockID Lod_CellBlock(int cx, int cz, int top) {
+	int x, z, i, maxX, maxZ;
+	maxX = min((cx + 1) * lod_scale, lod_width);
+	maxZ = min((cz + 1) * lod_scale, lod_length);
+
+	for (z = cz * lod_scale; z < maxZ; z++) {
+		for (x = cx * lod_scale; x < maxX; x++) {
+			i = (z + 1) * LOD_STRIDE + (x + 1);
+			if (lod_heights[i] == top) return lod_blocks[i];
+		}
+	}
+	return BLOCK_AIR;
+}
+
+/* Returns the lowest column height in the given strip of columns */
+static int Lod_MinHeight(int x1, int z1, int x2, int z2) {
+	int x, z, height = World.Height;
+
+	for (z = z1; z < z2; z++) {
+		for (x = x1; x < x2; x++) {
+			height = min(height, lod_heights[(z + 1) * LOD_STRIDE + (x + 1)]);
+		}
+	}
+	return height;
+}
+
+/* Returns the height that the wall on the given side of a cell extends down to */
+static int Lod_NeighbourHeight(int cx, int cz, Face face) {
+	int x1 = cx * lod_scale, x2 = min(x1 + lod_scale, lod_width);
+	int z1 = cz * lod_scale, z2 = min(z1 + lod_scale, lod_length);
+
+	/* Walls on the edges of the area extend down to the lowest neighbouring column, */
+	/*  so that no gaps are visible regardless of how the neighbouring area is drawn */
+	switch (face) {
+	case FACE_XMIN:
+		if (cx > 0) return lod_tops[cz * lod_cellsX + cx - 1];
+		return Lod_MinHeight(-1, z1, 0, z2);
+	case FACE_XMAX:
+		if (cx < lod_cellsX - 1) return lod_tops[cz * lod_cellsX + cx + 1];
+		return Lod_MinHeight(lod_width, z1, lod_width + 1, z2);
+	case FACE_ZMIN:
+		if (cz > 0) return lod_tops[(cz - 1) * lod_cellsX + cx];
+		return Lod_MinHeight(x1, -1, x2, 0);
+	case FACE_ZMAX:
+		if (cz < lod_cellsZ - 1) return lod_tops[(cz + 1) * lod_cellsX + cx];
+		return Lod_MinHeight(x1, lod_length, x2, lod_length + 1);
+	}
+	return 0;
+}
+
+static void Lod_AddFace(BlockID block, Face face, PackedCol col, cc_bool draw) {
+	TextureLoc loc = Block_Tex(block, face);
+	int batch      = Atlas1D_Index(loc);
+
+	if (!draw) { lod_counts[batch] += 4; return; }
+
+	switch (face) {
+	case FACE_XMIN:
+		Drawer_XMin(1, col, loc, &lod_vertices[batch]); break;
+	case FACE_XMAX:
+		Drawer_XMax(1, col, loc, &lod_vertices[batch]); break;
+	case FACE_ZMIN:
+		Drawer_ZMin(1, col, loc, &lod_vertices[batch]); break;
+	case FACE_ZMAX:
+		Drawer_ZMax(1, col, loc, &lod_vertices[batch]); break;
+	case FACE_YMAX:
+		Drawer_YMax(1, col, loc, &lod_vertices[batch]); break;
+	}
+}
+
+/* Counts or outputs the vertices of the top face and side walls of every cell */
+static void Lod_AddCells(cc_bool draw) {
+	int cx, cz, top, height;
+	BlockID block;
+	Face face;
+
+	for (cz = 0; cz < lod_cellsZ; cz++) {
+		for (cx = 0; cx < lod_cellsX; cx++) {
+			top = lod_tops[cz * lod_cellsX + cx];
+			if (!top) continue;
+			block = Lod_CellBlock(cx, cz, top);
+
+			/* Each face of the cell is stretched over the entire cell */
+			Drawer.X1 = (float)(lod_x1 + cx * lod_scale); 
+			Drawer.X2 = (float)(lod_x1 + min((cx + 1) * lod_scale, lod_width));
+			Drawer.Z1 = (float)(lod_z1 + cz * lod_scale);
+			Drawer.Z2 = (float)(lod_z1 + min((cz + 1) * lod_scale, lod_length));
+			Drawer.Y2 = (float)top;
+
+			Drawer.Tinted  = Blocks.Tinted[block];
+			Drawer.TintCol = Blocks.FogCol[block];
+			Lod_AddFace(block, FACE_YMAX, Env.SunCol, draw);
+
+			for (face = FACE_XMIN; face <= FACE_ZMAX; face++) {
+				height = Lod_NeighbourHeight(cx, cz, face);
+				if (height >= top) continue;
+
+				Drawer.Y1 = (float)height;
+				Lod_AddFace(block, face, face <= FACE_XMAX ? Env.SunXSide : Env.SunZSide, draw);
+			}
+		}
+	}
+}
+
+void Builder_MakeLodMesh(struct LodMesh* mesh, int x1, int z1, int x2, int z2, int scale) {
+	int i, total, batches = MapRenderer_1DUsedCount;
+	struct VertexTextured* data;
+
+	lod_x1     = x1; lod_width  = x2 - x1;
+	lod_z1     = z1; lod_length = z2 - z1;
+	lod_scale  = scale;
+	lod_cellsX = Math_CeilDiv(lod_width,  scale);
+	lod_cellsZ = Math_CeilDiv(lod_length, scale);
+
+	Lod_CalcHeights();
+	Lod_CalcCells();
+
+	Drawer.MinBB = Vec3_Create3(0.0f, 1.0f, 0.0f);
+	Drawer.MaxBB = Vec3_Create3(1.0f, 0.0f, 1.0f);
+	Mem_Set(lod_counts, 0, sizeof(lod_counts));
+	Lod_AddCells(false);
+
+	mesh->offsets = (int*)Mem_Alloc(batches + 1, sizeof(int), "LOD mesh offsets");
+	mesh->batches = batches;
+	mesh->scale   = scale;
+
+	for (i = 0, total = 0; i < batches; i++) {
+		mesh->offsets[i] = total;
+		total += lod_counts[i];
+	}
+	mesh->offsets[batches] = total;
+	if (!total) return;
+
+	/* add an extra element to fix crashing on some GPUs */
+	mesh->vb = Gfx_CreateVb(VERTEX_FORMAT_TEXTURED, total + 1);
+	data     = (struct VertexTextured*)Gfx_LockVb(mesh->vb, VERTEX_FORMAT_TEXTURED, total + 1);
+
+	for (i = 0; i < batches; i++) {
+		lod_vertices[i] = data + mesh->offsets[i];
+	}
+	Lod_AddCells(true);
+	Gfx_UnlockVb(mesh->vb);
+}
+#endif
+
+
 /*########################################################################################################################*
 *---------------------------------------------------Builder interface-----------------------------------------------------*
 *#########################################################################################################################*/
 cc_bool Builder_SmoothLighting;
+cc_bool Builder_GreedyMeshing;
 void Builder_ApplyActive(void) {
 	if (Builder_SmoothLighting) {
 		if (Lighting_Mode != LIGHTING_MODE_CLASSIC) {
@@ -1637,9 +2417,13 @@ void Builder_ApplyActive(void) {
 		else {
 			AdvBuilder_SetActive();
 		}
+	} else if (Builder_GreedyMeshing) {
+		GreedyBuilder_SetActive();
 	} else {
 		NormalBuilder_SetActive();
 	}
+	/* Only the greedy builder needs copies of tiles in the 1D atlases */
+	Atlas1D_SetRepeatTiles(!Builder_SmoothLighting && Builder_GreedyMeshing);
 }
 
 static void OnInit(void) {
@@ -1651,7 +2435,20 @@ static void OnInit(void) {
 	Builder_Offsets[FACE_YMAX] =  EXTCHUNK_SIZE_2;
 
 	if (!Game_ClassicMode) Builder_SmoothLighting = Options_GetBool(OPT_SMOOTH_LIGHTING, false);
+	Builder_GreedyMeshing = Options_GetBool(OPT_GREEDY_MESHING, false);
 	Builder_ApplyActive();
+
+#ifdef CC_BUILD_MESHCACHE
+	MeshCache_Init();
+	Event_Register_(&BlockEvents.BlockDefChanged, NULL, MeshCache_InvalidateBlocks);
+	Event_Register_(&TextureEvents.AtlasChanged,  NULL, MeshCache_InvalidateBlocks);
+#endif
+}
+
+static void OnFree(void) {
+#ifdef CC_BUILD_MESHCACHE
+	MeshCache_Free();
+#endif
 }
 
 static void OnNewMapLoaded(void) {
@@ -1661,7 +2458,7 @@ static void OnNewMapLoaded(void) {
 
 struct IGameComponent Builder_Component = {
 	OnInit, /* Init */
-	NULL, /* Free */
+	OnFree, /* Free */
 	NULL, /* Reset */
 	NULL, /* OnNewMap */
 	OnNewMapLoaded /* OnNewMapLoaded */
@@ -18,11 +18,19 @@ extern struct IGameComponent Builder_Component;
 extern int Builder_SidesLevel, Builder_EdgeLevel;
 /* Whether smooth/advanced lighting mesh builder is used. */
 extern cc_bool Builder_SmoothLighting;
+/* Whether faces are merged across both axes of their plane (non smooth lighting only). */
+/* NOTE: Requires one tile per 1D atlas, as otherwise textures cannot repeat vertically. */
+extern cc_bool Builder_GreedyMeshing;
 
 /* Builds the mesh of vertices for the given chunk. */
 void Builder_MakeChunk(struct ChunkInfo* info);
 
 void Builder_ApplyActive(void);
 
+struct LodMesh;
+/* Builds a low detail mesh of the surface of the given area, */
+/*  with each cell of the mesh covering scale x scale columns of blocks */
+void Builder_MakeLodMesh(struct LodMesh* mesh, int x1, int z1, int x2, int z2, int scale);
+
 CC_END_HEADER
 #endif
@@ -236,6 +236,33 @@ static struct ChatCommand ResolutionCommand = {
 	}
 };
 
+static void ScreenshotCommand_Execute(const cc_string* args, int argsCount) {
+	int cols = 1, rows;
+	if (argsCount && !Convert_ParseInt(&args[0], &cols)) {
+		Chat_AddRaw("&e/client: &cColumns must be an integer."); return;
+	}
+
+	rows = cols;
+	if (argsCount > 1 && !Convert_ParseInt(&args[1], &rows)) {
+		Chat_AddRaw("&e/client: &cRows must be an integer."); return;
+	}
+
+	if (cols < 1 || rows < 1 || cols > 16 || rows > 16) {
+		Chat_AddRaw("&e/client: &cColumns and rows must be between 1 and 16."); return;
+	}
+	Game_RequestTiledScreenshot(cols, rows);
+}
+
+static struct ChatCommand ScreenshotCommand = {
+	"Screenshot", ScreenshotCommand_Execute,
+	0,
+	{
+		"&a/client screenshot [columns] [rows]",
+		"&eTakes a screenshot of the world without the GUI, rendered as",
+		"&ecolumns x rows tiles stitched into one high resolution image.",
+	}
+};
+
 static void ModelCommand_Execute(const cc_string* args, int argsCount) {
 	if (argsCount) {
 		Entity_SetModel(&Entities.CurPlayer->Base, args);
@@ -801,6 +828,7 @@ static void OnInit(void) {
 	Commands_Register(&HelpCommand);
 	Commands_Register(&RenderTypeCommand);
 	Commands_Register(&ResolutionCommand);
+	Commands_Register(&ScreenshotCommand);
 	Commands_Register(&ModelCommand);
 	Commands_Register(&SkinCommand);
 	Commands_Register(&TeleportCommand);
@@ -95,6 +95,20 @@ Copyright 2014-2025 ClassiCube | Licensed under BSD-3
 	#define CC_ALIGNED(x) __attribute__((aligned(x)))
 #endif
 
+/* Hints to the compiler that a pointer doesn't alias any other pointers (helps with auto-vectorisation) */
+#if defined _MSC_VER && _MSC_VER >= 1400
+	#define CC_RESTRICT __restrict
+#elif defined __GNUC__
+	#define CC_RESTRICT __restrict__
+#else
+	#define CC_RESTRICT
+#endif
+
+/* Whether SSE2 intrinsics are always available (e.g. always the case on x86_64) */
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+	#define CC_BUILD_SSE2
+#endif
+
 /* Unrecognised compiler, so just go with some sensible default typdefs */
 /* Don't use <stdint.h>, as good chance such a compiler doesn't support it */
 #ifndef CC_HAS_TYPES
@@ -1140,6 +1140,11 @@ cc_result Zip_Extract(struct Stream* source, Zip_SelectEntry selector, Zip_Proce
 						struct ZipEntry* entries, int maxEntries) {
 	return ERR_NOT_SUPPORTED;
 }
+
+cc_result Zip_ExtractRaw(struct Stream* source, Zip_SelectEntry selector, Zip_ProcessEntry processor, 
+						struct ZipEntry* entries, int maxEntries) {
+	return ERR_NOT_SUPPORTED;
+}
 #else
 
 #define ZIP_MAXNAMELEN 512
@@ -1159,6 +1164,8 @@ struct ZipState {
 	int totalEntries;
 	/* Offset to central directory entries */
 	cc_uint32 centralDirBeg;
+	/* Whether entry data is passed to ProcessEntry without decompressing it */
+	cc_bool raw;
 };
 
 static cc_result Zip_ReadLocalFileHeader(struct ZipState* state, struct ZipEntry* entry) {
@@ -1196,7 +1203,15 @@ static cc_result Zip_ReadLocalFileHeader(struct ZipState* state, struct ZipEntry
 	if (!compressedSize)   compressedSize   = entry->CompressedSize;
 	if (!uncompressedSize) uncompressedSize = entry->UncompressedSize;
 
-	if (method == 0) {
+	if (state->raw && (method == 0 || method == 8)) {
+		/* Leave decompressing the data up to the caller */
+		entry->CompressionMethod = method;
+		entry->CompressedSize    = compressedSize;
+		entry->UncompressedSize  = uncompressedSize;
+
+		Stream_ReadonlyPortion(&portion, stream, method ? compressedSize : uncompressedSize);
+		res = state->ProcessEntry(&path, &portion, entry);
+	} else if (method == 0) {
 		Stream_ReadonlyPortion(&portion, stream, uncompressedSize);
 		res = state->ProcessEntry(&path, &portion, entry);
 	} else if (method == 8) {
@@ -1250,6 +1265,7 @@ static cc_result Zip_ReadCentralDirectory(struct ZipState* state) {
 	entry->CompressedSize    = Stream_GetU32_LE(&header[16]);
 	entry->UncompressedSize  = Stream_GetU32_LE(&header[20]);
 	entry->LocalHeaderOffset = Stream_GetU32_LE(&header[38]);
+	entry->CompressionMethod = Stream_GetU16_LE(&header[6]);
 	return 0;
 }
 
@@ -1271,8 +1287,8 @@ enum ZipSig {
 	ZIP_SIG_LOCALFILEHEADER = 0x04034b50
 };
 
-cc_result Zip_Extract(struct Stream* source, Zip_SelectEntry selector, Zip_ProcessEntry processor, 
-						struct ZipEntry* entries, int maxEntries) {
+static cc_result Zip_ExtractCore(struct Stream* source, Zip_SelectEntry selector, Zip_ProcessEntry processor, 
+						struct ZipEntry* entries, int maxEntries, cc_bool raw) {
 	struct ZipState state;
 	cc_uint32 stream_len;
 	cc_uint32 sig = 0;
@@ -1296,6 +1312,7 @@ cc_result Zip_Extract(struct Stream* source, Zip_SelectEntry selector, Zip_Proce
 	state.ProcessEntry = processor;
 	state.entries      = entries;
 	state.maxEntries   = maxEntries;
+	state.raw          = raw;
 
 	if (sig != ZIP_SIG_ENDOFCENTRALDIR) return ZIP_ERR_NO_END_OF_CENTRAL_DIR;
 	res = Zip_ReadEndOfCentralDirectory(&state);
@@ -1333,5 +1350,15 @@ cc_result Zip_Extract(struct Stream* source, Zip_SelectEntry selector, Zip_Proce
 	}
 	return 0;
 }
+
+cc_result Zip_Extract(struct Stream* source, Zip_SelectEntry selector, Zip_ProcessEntry processor, 
+						struct ZipEntry* entries, int maxEntries) {
+	return Zip_ExtractCore(source, selector, processor, entries, maxEntries, false);
+}
+
+cc_result Zip_ExtractRaw(struct Stream* source, Zip_SelectEntry selector, Zip_ProcessEntry processor, 
+						struct ZipEntry* entries, int maxEntries) {
+	return Zip_ExtractCore(source, selector, processor, entries, maxEntries, true);
+}
 #endif
 
@@ -122,7 +122,7 @@ CC_API  void ZLib_MakeStream(      struct Stream* stream, struct ZLibState* stat
 typedef void (*FP_ZLib_MakeStream)(struct Stream* stream, struct ZLibState* state, struct Stream* underlying);
 
 /* Minimal data needed to describe an entry in a .zip archive */
-struct ZipEntry { cc_uint32 CompressedSize, UncompressedSize, LocalHeaderOffset; };
+struct ZipEntry { cc_uint32 CompressedSize, UncompressedSize, LocalHeaderOffset, CompressionMethod; };
 /* Callback function to process the data in a .zip archive entry */
 /* Return non-zero to indicate an error and stop further processing */
 /* NOTE: data stream MAY NOT be seekable (i.e. entry data might be compressed) */
@@ -133,6 +133,11 @@ typedef cc_bool (*Zip_SelectEntry)(const cc_string* path);
 
 cc_result Zip_Extract(struct Stream* source, Zip_SelectEntry selector, Zip_ProcessEntry processor,
 						struct ZipEntry* entries, int maxEntries);
+/* Same as Zip_Extract, except that entry data is not decompressed */
+/* NOTE: entry->CompressionMethod is 0 for uncompressed data, 8 for DEFLATE compressed data */
+/* NOTE: entry->CompressedSize and entry->UncompressedSize are filled in from the local file header */
+cc_result Zip_ExtractRaw(struct Stream* source, Zip_SelectEntry selector, Zip_ProcessEntry processor,
+						struct ZipEntry* entries, int maxEntries);
 
 CC_END_HEADER
 #endif
@@ -610,6 +610,11 @@ int Drawer2D_TextHeight(struct DrawTextArgs* args) {
 	return Font_CalcHeight(args->font, args->useShadow);
 }
 
+int Font_CalcShadowOffset(const struct FontDesc* font) {
+	if (Font_IsBitmap(font)) return Drawer2D_ShadowOffset(font->size);
+	return 1;
+}
+
 int Font_CalcHeight(const struct FontDesc* font, cc_bool useShadow) {
 	int height = font->height;
 	if (Font_IsBitmap(font)) {
@@ -660,7 +665,7 @@ static void DefaultPngProcess(struct Stream* stream, const cc_string* name) {
 	struct Bitmap bmp;
 	cc_result res;
 
-	if ((res = Png_Decode(&bmp, stream))) {
+	if ((res = TexturePack_DecodePng(&bmp, stream))) {
 		Logger_SysWarn2(res, "decoding", name);
 		Mem_Free(bmp.scan0);
 	} else if (Font_SetBitmapAtlas(&bmp)) {
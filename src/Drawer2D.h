@@ -114,6 +114,8 @@ CC_API void Font_Make(struct FontDesc* desc, int size, int flags);
 CC_API void Font_Free(struct FontDesc* desc);
 /* Returns the line height for drawing text using the given font */
 int Font_CalcHeight(const struct FontDesc* font, cc_bool useShadow);
+/* Returns how far the shadow behind text is offset, when drawing text using the given font */
+int Font_CalcShadowOffset(const struct FontDesc* font);
 /* Adjusts height to be closer to system fonts */
 int Drawer2D_AdjHeight(int point);
 
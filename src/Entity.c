@@ -203,21 +203,144 @@ cc_bool Entity_TouchesAnyWater(struct Entity* e) {
 	return Entity_TouchesAny(&bounds, IsWaterCollide);
 }
 
+int Entity_GetTouches(struct Entity* e) {
+	struct AABB bounds, ropeBB, liqBB, blockBB;
+	IVec3 bbMin, bbMax;
+	BlockID block;
+	cc_uint8 collide;
+	int x, y, z, touches = 0;
+	Vec3 v;
+
+	Entity_GetBounds(e, &bounds);
+	ropeBB = bounds; ropeBB.Max.y += 0.5f / 16.0f;
+	AABB_Offset(&liqBB, &bounds, &entity_liqExpand);
+
+	/* Scan the area covering both the rope and liquid bounds */
+	bounds.Min.x = min(ropeBB.Min.x, liqBB.Min.x); bounds.Max.x = max(ropeBB.Max.x, liqBB.Max.x);
+	bounds.Min.y = min(ropeBB.Min.y, liqBB.Min.y); bounds.Max.y = max(ropeBB.Max.y, liqBB.Max.y);
+	bounds.Min.z = min(ropeBB.Min.z, liqBB.Min.z); bounds.Max.z = max(ropeBB.Max.z, liqBB.Max.z);
+
+	IVec3_Floor(&bbMin, &bounds.Min);
+	IVec3_Floor(&bbMax, &bounds.Max);
+
+	bbMin.x = max(bbMin.x, 0); bbMax.x = min(bbMax.x, World.MaxX);
+	bbMin.y = max(bbMin.y, 0); bbMax.y = min(bbMax.y, World.MaxY);
+	bbMin.z = max(bbMin.z, 0); bbMax.z = min(bbMax.z, World.MaxZ);
+
+	for (y = bbMin.y; y <= bbMax.y; y++) { v.y = (float)y;
+		for (z = bbMin.z; z <= bbMax.z; z++) { v.z = (float)z;
+			for (x = bbMin.x; x <= bbMax.x; x++) { v.x = (float)x;
+
+				block   = World_GetBlock(x, y, z);
+				collide = Blocks.ExtendedCollide[block];
+				if (collide != COLLIDE_CLIMB && collide != COLLIDE_WATER && collide != COLLIDE_LAVA) continue;
+
+				Vec3_Add(&blockBB.Min, &v, &Blocks.MinBB[block]);
+				Vec3_Add(&blockBB.Max, &v, &Blocks.MaxBB[block]);
+
+				if (collide == COLLIDE_CLIMB) {
+					if (AABB_Intersects(&blockBB, &ropeBB)) touches |= TOUCHES_ROPE;
+				} else if (AABB_Intersects(&blockBB, &liqBB)) {
+					touches |= collide == COLLIDE_WATER ? TOUCHES_WATER : TOUCHES_LAVA;
+				}
+			}
+		}
+	}
+	return touches;
+}
+
+
+/*########################################################################################################################*
+*--------------------------------------------------Shared skin textures---------------------------------------------------*
+*#########################################################################################################################*/
+/* Skins with identical pixels (e.g. char.png under several names or URLs) share the same texture, */
+/*  which is deleted once the last entity referencing it stops using it */
+/* NOTE: Each entity references at most one skin texture, so this can never overflow */
+static struct SkinTexture {
+	GfxResourceID texID;
+	cc_uint32 hash; /* CRC32 of the skin's pixels */
+	int width, height, refCount;
+	float uScale, vScale;
+} skinTextures[ENTITIES_MAX_COUNT];
+static int skinTexturesCount;
+
+static int SkinTextures_Find(GfxResourceID texID) {
+	int i;
+	for (i = 0; i < skinTexturesCount; i++)
+	{
+		if (skinTextures[i].texID == texID) return i;
+	}
+	return -1;
+}
+
+static void SkinTextures_Ref(GfxResourceID texID) {
+	int i = SkinTextures_Find(texID);
+	if (i >= 0) skinTextures[i].refCount++;
+}
+
+/* Removes a reference to the given skin texture, deleting it if no longer used */
+static void SkinTextures_Unref(GfxResourceID* texID) {
+	int i;
+	if (!(*texID)) return;
+
+	i = SkinTextures_Find(*texID);
+	if (i >= 0 && --skinTextures[i].refCount > 0) { *texID = 0; return; }
+
+	Gfx_DeleteTexture(texID);
+	if (i < 0) return;
+	skinTextures[i] = skinTextures[--skinTexturesCount];
+}
+
+/* Sets entity's skin texture to a texture for the given skin, reusing an existing texture if possible */
+static void SkinTextures_Acquire(struct Entity* e, struct Bitmap* bmp) {
+	struct SkinTexture* tex;
+	cc_uint32 hash;
+	int i;
+	hash = Utils_CRC32((const cc_uint8*)bmp->scan0, Bitmap_DataSize(bmp->width, bmp->height));
+
+	for (i = 0; i < skinTexturesCount; i++)
+	{
+		tex = &skinTextures[i];
+		if (tex->hash != hash || tex->width != bmp->width || tex->height != bmp->height) continue;
+		if (tex->uScale != e->uScale || tex->vScale != e->vScale) continue;
+
+		tex->refCount++;
+		e->TextureId = tex->texID;
+		return;
+	}
+
+	e->TextureId = Gfx_CreateTexture(bmp, TEXTURE_FLAG_MANAGED, false);
+	if (!e->TextureId || skinTexturesCount == ENTITIES_MAX_COUNT) return;
+
+	tex = &skinTextures[skinTexturesCount++];
+	tex->texID    = e->TextureId;
+	tex->hash     = hash;
+	tex->width    = bmp->width;
+	tex->height   = bmp->height;
+	tex->refCount = 1;
+	tex->uScale   = e->uScale;
+	tex->vScale   = e->vScale;
+}
+
 
 /*########################################################################################################################*
 *------------------------------------------------------Entity skins-------------------------------------------------------*
 *#########################################################################################################################*/
 /* Copies skin data from another entity */
 static void Entity_CopySkin(struct Entity* dst, struct Entity* src) {
+	if (dst == src) return;
+	SkinTextures_Unref(&dst->TextureId);
+	SkinTextures_Ref(src->TextureId);
+
 	dst->TextureId	= src->TextureId;	
 	dst->SkinType	= src->SkinType;
 	dst->uScale		= src->uScale;
 	dst->vScale		= src->vScale;
 }
 
-/* Resets skin data for the given entity */
+/* Resets skin data for the given entity, releasing its skin texture */
 static void Entity_ResetSkin(struct Entity* e) {
-	e->TextureId    = 0;
+	SkinTextures_Unref(&e->TextureId);
 	e->uScale 		= 1.0f; 
 	e->vScale 		= 1.0f;
 }
@@ -341,7 +464,7 @@ static cc_result ApplySkin(struct Entity* e, struct Bitmap* bmp, struct Stream*
 	cc_result res;
 	if ((res = Png_Decode(bmp, src))) return res;
 
-	Gfx_DeleteTexture(&e->TextureId);
+	SkinTextures_Unref(&e->TextureId);
 	if ((res = EnsurePow2Skin(e, bmp))) return res;
 	e->SkinType = Utils_CalcSkinType(bmp);
 
@@ -351,7 +474,7 @@ static cc_result ApplySkin(struct Entity* e, struct Bitmap* bmp, struct Stream*
 		if (e->Model->flags & MODEL_FLAG_CLEAR_HAT)
 			Entity_ClearHat(bmp, e->SkinType);
 
-		e->TextureId = Gfx_CreateTexture(bmp, TEXTURE_FLAG_MANAGED, false);
+		SkinTextures_Acquire(e, bmp);
 		Entity_SetSkinAll(e, false);
 	}
 	return 0;
@@ -445,21 +568,7 @@ static void DerefDownloadingSkin(struct Entity* src) {
 	Http_TryCancel(src->_skinReqID);
 }
 
-/* Returns true if no other entities are sharing this skin texture */
-static cc_bool CanDeleteTexture(struct Entity* except) {
-	int i;
-	if (!except->TextureId) return false;
-
-	for (i = 0; i < ENTITIES_MAX_COUNT; i++)
-	{
-		if (!Entities.List[i] || Entities.List[i] == except)  continue;
-		if (Entities.List[i]->TextureId == except->TextureId) return false;
-	}
-	return true;
-}
-
 CC_NOINLINE static void DeleteSkin(struct Entity* e) {
-	if (CanDeleteTexture(e)) Gfx_DeleteTexture(&e->TextureId);
 	if (e->SkinFetchState == SKIN_FETCH_DOWNLOADING) DerefDownloadingSkin(e);
 
 	Entity_ResetSkin(e);
@@ -515,10 +624,26 @@ void Entities_RenderModels(float delta, float t) {
 	{
 		if (!Entities.List[i]) continue;
 		Entities.List[i]->VTABLE->RenderModel(Entities.List[i], delta, t);
+		Models.LowDetail = false;
 	}
 	Gfx_SetAlphaTest(false);
 }
 
+/* Frustum culls and then distance culls the given entity */
+/* Also selects whether the entity is drawn with a reduced detail model */
+static cc_bool Entities_CheckVisible(struct Entity* e) {
+	float dist, lodDist = Entities.LODDistance, cullDist = Entities.CullDistance;
+	if (!Model_ShouldRender(e)) return false;
+	dist = Model_RenderDistance(e);
+
+	/* Original classic only shows players up to 64 blocks away */
+	if (Game_ClassicMode && dist > 64 * 64) return false;
+	if (cullDist && dist > cullDist * cullDist) return false;
+
+	Models.LowDetail = lodDist && dist > lodDist * lodDist;
+	return true;
+}
+
 static void Entities_ContextLost(void* obj) {
 	struct Entity* entity;
 	int i;
@@ -845,6 +970,8 @@ static void LocalPlayer_OnNewMap(struct LocalPlayer* p) {
 
 static void LocalPlayers_OnNewMap(void) {
 	int i;
+	Searcher_ClearCache();
+
 	for (i = 0; i < Game_NumStates; i++)
 	{
 		LocalPlayer_OnNewMap(&LocalPlayer_Instances[i]);
@@ -1144,12 +1271,11 @@ static void NetPlayer_RenderModel(struct Entity* e, float delta, float t) {
 	Vec3_Lerp(&e->Position, &e->prev.pos, &e->next.pos, t);
 	Entity_LerpAngles(e, t);
 
-	AnimatedComp_GetCurrent(e, t);
-	e->ShouldRender = Model_ShouldRender(e);
-	/* Original classic only shows players up to 64 blocks away */
-	if (Game_ClassicMode) e->ShouldRender &= Model_RenderDistance(e) <= 64 * 64;
+	e->ShouldRender = Entities_CheckVisible(e);
+	if (!e->ShouldRender) return;
 
-	if (e->ShouldRender) Model_Render(e->Model, e);
+	AnimatedComp_GetCurrent(e, t);
+	Model_Render(e->Model, e);
 }
 
 static cc_bool NetPlayer_ShouldRenderName(struct Entity* e) {
@@ -1177,9 +1303,12 @@ void NetPlayer_Init(struct NetPlayer* p) {
 /*########################################################################################################################*
 *---------------------------------------------------Entities component----------------------------------------------------*
 *#########################################################################################################################*/
+static void Entities_BlockDefChanged(void* obj) { Searcher_ClearCache(); }
+
 static void Entities_Init(void) {
 	int i;
-	Event_Register_(&GfxEvents.ContextLost, NULL, Entities_ContextLost);
+	Event_Register_(&GfxEvents.ContextLost,      NULL, Entities_ContextLost);
+	Event_Register_(&BlockEvents.BlockDefChanged, NULL, Entities_BlockDefChanged);
 
 	Entities.NamesMode = Options_GetEnum(OPT_NAMES_MODE, NAME_MODE_HOVERED,
 		NameMode_Names, Array_Elems(NameMode_Names));
@@ -1189,6 +1318,9 @@ static void Entities_Init(void) {
 		ShadowMode_Names, Array_Elems(ShadowMode_Names));
 	if (Game_ClassicMode) Entities.ShadowsMode = SHADOW_MODE_NONE;
 
+	Entities.LODDistance  = (float)Options_GetInt(OPT_ENTITY_LOD_DISTANCE,  0, 4096, 64);
+	Entities.CullDistance = (float)Options_GetInt(OPT_ENTITY_CULL_DISTANCE, 0, 4096,  0);
+
 	for (i = 0; i < Game_NumStates; i++)
 	{
 		LocalPlayer_Init(&LocalPlayer_Instances[i], i);
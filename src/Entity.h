@@ -169,6 +169,13 @@ cc_bool Entity_TouchesAnyRope(struct Entity* e);
 cc_bool Entity_TouchesAnyLava(struct Entity* e);
 cc_bool Entity_TouchesAnyWater(struct Entity* e);
 
+#define TOUCHES_ROPE  0x01
+#define TOUCHES_WATER 0x02
+#define TOUCHES_LAVA  0x04
+/* Checks whether the given entity is touching any rope, water, or lava blocks */
+/* NOTE: Equivalent to Entity_TouchesAnyRope/Water/Lava, but only scans nearby blocks once */
+int Entity_GetTouches(struct Entity* e);
+
 /* Sets the nametag above the given entity's head */
 void Entity_SetName(struct Entity* e, const cc_string* name);
 /* Sets the skin name of the given entity. */
@@ -181,6 +188,10 @@ CC_VAR extern struct _EntitiesData {
 	struct Entity* List[ENTITIES_MAX_COUNT];
 	cc_uint8 NamesMode, ShadowsMode;
 	struct LocalPlayer* CurPlayer;
+	/* Distance beyond which entities are drawn with reduced detail models (0 = never) */
+	float LODDistance;
+	/* Distance beyond which entities are not drawn at all (0 = no limit) */
+	float CullDistance;
 } Entities;
 
 /* Ticks all entities */
@@ -730,9 +730,12 @@ void PhysicsComp_UpdateVelocityState(struct PhysicsComp* comp) {
 
 	cc_bool touchWater, touchLava;
 	cc_bool liquidFeet, liquidRest;
-	int feetY, bodyY, headY;
+	int feetY, bodyY, headY, touches;
 	cc_bool pastJumpPoint;
 
+	/* Nearby rope and liquid blocks only matter when jumping */
+	touches = comp->Jumping ? Entity_GetTouches(entity) : 0;
+
 	if (hacks->Floating) {
 		entity->Velocity.y = 0.0f; /* eliminate the effect of gravity */
 		dir = (hacks->FlyingUp || comp->Jumping) ? 1 : (hacks->FlyingDown ? -1 : 0);
@@ -740,13 +743,13 @@ void PhysicsComp_UpdateVelocityState(struct PhysicsComp* comp) {
 		entity->Velocity.y += 0.12f * dir;
 		if (hacks->Speeding     && hacks->CanSpeed) entity->Velocity.y += 0.12f * dir;
 		if (hacks->HalfSpeeding && hacks->CanSpeed) entity->Velocity.y += 0.06f * dir;
-	} else if (comp->Jumping && Entity_TouchesAnyRope(entity) && entity->Velocity.y > 0.02f) {
+	} else if ((touches & TOUCHES_ROPE) && entity->Velocity.y > 0.02f) {
 		entity->Velocity.y = 0.02f;
 	}
 
 	if (!comp->Jumping) { comp->CanLiquidJump = false; return; }
-	touchWater = Entity_TouchesAnyWater(entity);
-	touchLava  = Entity_TouchesAnyLava(entity);
+	touchWater = touches & TOUCHES_WATER;
+	touchLava  = touches & TOUCHES_LAVA;
 
 	if (touchWater || touchLava) {
 		Entity_GetBounds(entity, &bounds);
@@ -780,7 +783,7 @@ void PhysicsComp_UpdateVelocityState(struct PhysicsComp* comp) {
 		if (hacks->Speeding     && hacks->CanSpeed) entity->Velocity.y += 0.04f;
 		if (hacks->HalfSpeeding && hacks->CanSpeed) entity->Velocity.y += 0.02f;
 		comp->CanLiquidJump = false;
-	} else if (Entity_TouchesAnyRope(entity)) {
+	} else if (touches & TOUCHES_ROPE) {
 		entity->Velocity.y += (hacks->Speeding && hacks->CanSpeed) ? 0.15f : 0.10f;
 		comp->CanLiquidJump = false;
 	} else if (entity->OnGround) {
@@ -935,6 +938,7 @@ void PhysicsComp_PhysicsTick(struct PhysicsComp* comp, Vec3 vel) {
 	float baseSpeed, verSpeed, horSpeed;
 	float factor, gravity;
 	cc_bool womSpeedBoost;
+	int touches;
 
 	if (hacks->Noclip) entity->OnGround = false;
 	baseSpeed = PhysicsComp_GetBaseSpeed(comp);
@@ -954,13 +958,15 @@ void PhysicsComp_PhysicsTick(struct PhysicsComp* comp, Vec3 vel) {
 		else if (comp->MultiJumps > 1) { horSpeed *= 93.0f; verSpeed *= 10.0f; }
 	}
 
-	if (Entity_TouchesAnyWater(entity) && !hacks->Floating) {
+	touches = hacks->Floating ? 0 : Entity_GetTouches(entity);
+
+	if (touches & TOUCHES_WATER) {
 		Vec3 waterDrag = { 0.8f, 0.8f, 0.8f };
 		PhysicsComp_MoveNormal(comp, vel, 0.02f * horSpeed, waterDrag, LIQUID_GRAVITY, verSpeed);
-	} else if (Entity_TouchesAnyLava(entity) && !hacks->Floating) {
+	} else if (touches & TOUCHES_LAVA) {
 		Vec3 lavaDrag = { 0.5f, 0.5f, 0.5f };
 		PhysicsComp_MoveNormal(comp, vel, 0.02f * horSpeed, lavaDrag, LIQUID_GRAVITY, verSpeed);
-	} else if (Entity_TouchesAnyRope(entity) && !hacks->Floating) {
+	} else if (touches & TOUCHES_ROPE) {
 		Vec3 ropeDrag = { 0.5f, 0.85f, 0.5f };
 		PhysicsComp_MoveNormal(comp, vel, 0.02f * 1.7f, ropeDrag, ROPE_GRAVITY, verSpeed);
 	} else {
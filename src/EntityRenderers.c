@@ -12,6 +12,7 @@
 #include "Particle.h"
 #include "Drawer2D.h"
 #include "Server.h"
+#include "Platform.h"
 
 /*########################################################################################################################*
 *------------------------------------------------------Entity Shadow------------------------------------------------------*
@@ -283,6 +284,91 @@ static GfxResourceID names_VB;
 #define NAME_IS_EMPTY -30000
 #define NAME_OFFSET 3 /* offset of back layer of name above an entity */
 
+/* Nametags are packed into rows of a shared atlas texture, so that all the */
+/*  visible names can then be drawn using only one texture bind and draw call */
+#define NAMES_ATLAS_SIZE 1024
+static GfxResourceID names_atlas;
+static int names_atlasX, names_atlasY, names_rowHeight;
+static cc_bool names_noAtlas;
+
+static struct VertexTextured names_batch[ENTITIES_MAX_COUNT * 4];
+static int names_batchCount;
+
+static void FlushNamesBatch(void) {
+	if (!names_batchCount) return;
+	Gfx_BindTexture(names_atlas);
+
+	Gfx_SetDynamicVbData(names_VB, names_batch, names_batchCount * 4);
+	Gfx_DrawVb_IndexedTris(names_batchCount * 4);
+	names_batchCount = 0;
+}
+
+static void ResetNamesAtlas(void) {
+	struct Entity* e;
+	int i;
+	/* Pending names in the batch might refer to parts of the atlas about to be replaced */
+	FlushNamesBatch();
+
+	for (i = 0; i < ENTITIES_MAX_COUNT; i++) 
+	{
+		e = Entities.List[i];
+		if (e && e->NameTex.ID == names_atlas) e->NameTex.ID = 0;
+	}
+	names_atlasX = 0; names_atlasY = 0; names_rowHeight = 0;
+}
+
+static cc_bool CreateNamesAtlas(void) {
+	struct Bitmap bmp;
+	int flags = TEXTURE_FLAG_DYNAMIC | TEXTURE_FLAG_LOWRES;
+
+	if (names_noAtlas) return false;
+	names_noAtlas = (Gfx.Limitations & GFX_LIMIT_NO_UV_SUPPORT) ||
+		!Gfx_CheckTextureSize(NAMES_ATLAS_SIZE, NAMES_ATLAS_SIZE, flags);
+	if (names_noAtlas) return false;
+
+	bmp.width  = NAMES_ATLAS_SIZE;
+	bmp.height = NAMES_ATLAS_SIZE;
+	bmp.scan0  = (BitmapCol*)Mem_TryAllocCleared(NAMES_ATLAS_SIZE * NAMES_ATLAS_SIZE, BITMAPCOLOR_SIZE);
+	if (!bmp.scan0) { names_noAtlas = true; return false; }
+
+	names_atlas = Gfx_CreateTexture(&bmp, flags, false);
+	Mem_Free(bmp.scan0);
+	names_atlasX = 0; names_atlasY = 0; names_rowHeight = 0;
+	return names_atlas != 0;
+}
+
+/* Attempts to copy the rendered name into a free area of the names atlas */
+static cc_bool AddToNamesAtlas(struct Entity* e, struct Context2D* ctx) {
+	struct Bitmap part;
+	int width = ctx->width, height = ctx->height;
+	if (width > NAMES_ATLAS_SIZE || height > NAMES_ATLAS_SIZE) return false;
+	if (!names_atlas && !CreateNamesAtlas()) return false;
+
+	/* Move onto next row when no more space left in current row */
+	if (names_atlasX + width > NAMES_ATLAS_SIZE) {
+		names_atlasX     = 0;
+		names_atlasY    += names_rowHeight;
+		names_rowHeight  = 0;
+	}
+	/* Atlas is full, so reuse it from scratch (visible names get re-added when next drawn) */
+	if (names_atlasY + height > NAMES_ATLAS_SIZE) ResetNamesAtlas();
+
+	Bitmap_Init(part, width, height, ctx->bmp.scan0);
+	Gfx_UpdateTexture(names_atlas, names_atlasX, names_atlasY, &part, ctx->bmp.width, false);
+
+	e->NameTex.ID     = names_atlas;
+	e->NameTex.width  = width;
+	e->NameTex.height = height;
+	e->NameTex.uv.u1  = names_atlasX            / (float)NAMES_ATLAS_SIZE;
+	e->NameTex.uv.v1  = names_atlasY            / (float)NAMES_ATLAS_SIZE;
+	e->NameTex.uv.u2  = (names_atlasX + width)  / (float)NAMES_ATLAS_SIZE;
+	e->NameTex.uv.v2  = (names_atlasY + height) / (float)NAMES_ATLAS_SIZE;
+
+	names_atlasX   += width;
+	names_rowHeight = max(names_rowHeight, height);
+	return true;
+}
+
 static void MakeNameTexture(struct Entity* e) {
 	cc_string colorlessName; char colorlessBuffer[STRING_SIZE];
 	BitmapCol shadowColor = BitmapCol_Make(80, 80, 80, 255);
@@ -324,7 +410,7 @@ static void MakeNameTexture(struct Entity* e) {
 			args.text = name;
 			Context2D_DrawText(&ctx, &args, 0, 0);
 		}
-		Context2D_MakeTexture(&e->NameTex, &ctx);
+		if (!AddToNamesAtlas(e, &ctx)) Context2D_MakeTexture(&e->NameTex, &ctx);
 		Context2D_Free(&ctx);
 	}
 }
@@ -340,10 +426,9 @@ static void DrawName(struct Entity* e) {
 	if (!e->VTABLE->ShouldRenderName(e)) return;
 	if (e->NameTex.x == NAME_IS_EMPTY)   return;
 	if (!e->NameTex.ID) MakeNameTexture(e);
-	Gfx_BindTexture(e->NameTex.ID);
 
 	if (!names_VB)
-		names_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, 4);
+		names_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, ENTITIES_MAX_COUNT * 4);
 
 	model = e->Model;
 	Model_GetEntityTransform(model, e, &transform);
@@ -360,7 +445,16 @@ static void DrawName(struct Entity* e) {
 		size.x *= scale * 0.2f; size.y *= scale * 0.2f;
 	}
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
+	if (names_atlas && e->NameTex.ID == names_atlas) {
+		vertices = &names_batch[names_batchCount * 4];
+		Particle_DoRender(&size, &pos, &e->NameTex.uv, PACKEDCOL_WHITE, vertices);
+		names_batchCount++;
+		return;
+	}
+
+	/* Name didn't fit into the atlas, so has to be drawn separately */
+	FlushNamesBatch();
+	Gfx_BindTexture(e->NameTex.ID);
 
 	vertices = (struct VertexTextured*)Gfx_LockDynamicVb(names_VB, VERTEX_FORMAT_TEXTURED, 4);
 	Particle_DoRender(&size, &pos, &e->NameTex.uv, PACKEDCOL_WHITE, vertices);
@@ -370,7 +464,12 @@ static void DrawName(struct Entity* e) {
 }
 
 void EntityNames_Delete(struct Entity* e) {
-	Gfx_DeleteTexture(&e->NameTex.ID);
+	/* Atlas space isn't reclaimed, it just gets reused when the atlas is next reset */
+	if (names_atlas && e->NameTex.ID == names_atlas) {
+		e->NameTex.ID = 0;
+	} else {
+		Gfx_DeleteTexture(&e->NameTex.ID);
+	}
 	e->NameTex.x = 0; /* X is used as an 'empty name' flag */
 }
 
@@ -395,11 +494,13 @@ void EntityNames_Render(void) {
 	hadFog = Gfx_GetFog();
 	if (hadFog) Gfx_SetFog(false);
 
+	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
 	for (i = 0; i < ENTITIES_MAX_COUNT; i++) 
 	{
 		if (!Entities.List[i]) continue;
 		if (i != closestEntityId) DrawName(Entities.List[i]);
 	}
+	FlushNamesBatch();
 
 	Gfx_SetAlphaTest(false);
 	if (hadFog) Gfx_SetFog(true);
@@ -433,11 +534,13 @@ void EntityNames_RenderHovered(void) {
 			setupState = true;
 			hadFog = Gfx_GetFog();
 			if (hadFog) Gfx_SetFog(false);
+			Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
 		}
 		DrawName(e);
 	}
 
 	if (!setupState) return;
+	FlushNamesBatch();
 	Gfx_SetAlphaTest(false);
 	Gfx_SetDepthTest(true);
 	Gfx_SetDepthWrite(true);
@@ -467,6 +570,7 @@ static void EntityRenderers_ContextLost(void* obj) {
 	
 	Gfx_DeleteDynamicVb(&names_VB);
 	DeleteAllNameTextures();
+	Gfx_DeleteTexture(&names_atlas);
 }
 
 static void EntityRenderers_Init(void) {
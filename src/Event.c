@@ -64,6 +64,7 @@ void Event_UnregisterAll(void) {
 	TextureEvents.AtlasChanged.Count = 0;
 	TextureEvents.PackChanged.Count  = 0;
 	TextureEvents.FileChanged.Count  = 0;
+	TextureEvents.IconsChanged.Count = 0;
 
 	GfxEvents.ViewDistanceChanged.Count = 0;
 	GfxEvents.LowVRAMDetected.Count     = 0;
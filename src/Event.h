@@ -152,6 +152,7 @@ CC_VAR extern struct _TextureEventsList {
 	struct Event_Void  AtlasChanged; /* Terrain atlas (terrain.png) is changed */
 	struct Event_Void  PackChanged;  /* Texture pack is changed */
 	struct Event_Entry FileChanged;  /* File in a texture pack is changed (terrain.png, rain.png) */
+	struct Event_Void  IconsChanged; /* Cached block icons used by isometric drawer are discarded */
 } TextureEvents;
 
 CC_VAR extern struct _GfxEventsList {
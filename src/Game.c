@@ -30,6 +30,7 @@
 #include "AxisLinesRenderer.h"
 #include "EnvRenderer.h"
 #include "HeldBlockRenderer.h"
+#include "IsometricDrawer.h"
 #include "SelOutlineRenderer.h"
 #include "Menus.h"
 #include "Audio.h"
@@ -41,6 +42,8 @@
 #include "SystemFonts.h"
 #include "Formats.h"
 #include "EntityRenderers.h"
+#include "Bitmap.h"
+#include "Errors.h"
 
 struct _GameData Game;
 static cc_uint64 frameStart;
@@ -166,8 +169,110 @@ cc_bool Game_ReduceVRAM(void) {
 }
 
 
+/* Automatic quality measures the distribution of frame times, and then reduces (or restores) */
+/*  view distance, particle limit and entity detail to try to keep frames at the target time */
+#define AUTOQ_BUCKETS 128 /* Frame time histogram, with 0.5 ms buckets */
+#define AUTOQ_MAX_LEVEL 6
+#define AUTOQ_MIN_RAISE_WINDOWS 3
+#define AUTOQ_MAX_RAISE_WINDOWS 48
+int   Game_AutoQualityLevel = -1;
+float Game_AutoQualityFrameTime;
+
+static float autoQ_targetMs, autoQ_windowTime, autoQ_userLodDistance;
+static cc_uint16 autoQ_frameTimes[AUTOQ_BUCKETS];
+static int autoQ_frames, autoQ_goodWindows, autoQ_raiseWindows, autoQ_windowsSinceRaise;
+/* Percentage of user's settings used at each quality level */
+static const cc_uint8 autoQ_scales[AUTOQ_MAX_LEVEL + 1] = { 100, 85, 70, 55, 45, 35, 25 };
+
+static void AutoQuality_Init(void) {
+	int fps = Options_GetInt(OPT_AUTO_QUALITY_FPS, 0, 240, 0);
+	if (!fps) return;
+
+	autoQ_targetMs          = 1000.0f / fps;
+	autoQ_raiseWindows      = AUTOQ_MIN_RAISE_WINDOWS;
+	autoQ_windowsSinceRaise = AUTOQ_MAX_RAISE_WINDOWS;
+	autoQ_userLodDistance   = Entities.LODDistance;
+	Game_AutoQualityLevel   = 0;
+
+	/* Keep building more chunks per frame while under target frame time */
+	MapRenderer_ChunkTargetTime = autoQ_targetMs * 1.1f / 1000.0f;
+}
+
+static int AutoQuality_ViewDistance(void) {
+	int dist = Game_UserViewDistance * autoQ_scales[Game_AutoQualityLevel] / 100;
+	return max(16, dist);
+}
+
+static void AutoQuality_Apply(void) {
+	int scale = autoQ_scales[Game_AutoQualityLevel];
+	/* Entity LOD might be disabled by the user */
+	float lodDist = autoQ_userLodDistance ? autoQ_userLodDistance : 64.0f;
+
+	Particles_ScaleLimit(scale);
+	Entities.LODDistance = Game_AutoQualityLevel ? lodDist * scale / 100 : autoQ_userLodDistance;
+	Game_SetViewDistance(Game_UserViewDistance);
+}
+
+/* Calculates frame time (in milliseconds) that 90% of frames in the last window were under */
+static float AutoQuality_CalcFrameTime(void) {
+	int i, total = 0, threshold = autoQ_frames * 9 / 10;
+
+	for (i = 0; i < AUTOQ_BUCKETS - 1; i++) {
+		total += autoQ_frameTimes[i];
+		if (total > threshold) break;
+	}
+	return (i + 1) * 0.5f;
+}
+
+static void AutoQuality_Update(float delta, float frameMs) {
+	/* Frames can't be quicker than the FPS limit anyway, so no point targeting less than that */
+	float targetMs = max(autoQ_targetMs, gfx_minFrameMs);
+	float frameTime;
+	autoQ_frameTimes[min((int)(frameMs * 2), AUTOQ_BUCKETS - 1)]++;
+	autoQ_frames++;
+
+	autoQ_windowTime += delta;
+	if (autoQ_windowTime < 1.0f) return;
+
+	frameTime = AutoQuality_CalcFrameTime();
+	Game_AutoQualityFrameTime = frameTime;
+	autoQ_windowTime = 0.0f;
+	autoQ_frames     = 0;
+	Mem_Set(autoQ_frameTimes, 0, sizeof(autoQ_frameTimes));
+
+	/* Gradually become willing to raise quality quickly again */
+	if (++autoQ_windowsSinceRaise >= AUTOQ_MAX_RAISE_WINDOWS * 2) {
+		autoQ_raiseWindows = AUTOQ_MIN_RAISE_WINDOWS;
+	}
+
+	if (frameTime > targetMs * 1.2f) {
+		autoQ_goodWindows = 0;
+		if (Game_AutoQualityLevel == AUTOQ_MAX_LEVEL) return;
+
+		/* Quality was raised too eagerly, so wait longer before raising it again */
+		if (autoQ_windowsSinceRaise <= AUTOQ_MIN_RAISE_WINDOWS) {
+			autoQ_raiseWindows = min(autoQ_raiseWindows * 2, AUTOQ_MAX_RAISE_WINDOWS);
+		}
+		Game_AutoQualityLevel++;
+		AutoQuality_Apply();
+	} else if (frameTime <= targetMs * 1.05f) {
+		if (!Game_AutoQualityLevel) return;
+		if (++autoQ_goodWindows < autoQ_raiseWindows) return;
+
+		autoQ_goodWindows       = 0;
+		autoQ_windowsSinceRaise = 0;
+		Game_AutoQualityLevel--;
+		AutoQuality_Apply();
+	} else {
+		/* Frame times are close enough to target, so keep current quality */
+		autoQ_goodWindows = 0;
+	}
+}
+
+
 void Game_SetViewDistance(int distance) {
 	distance = min(distance, Game_MaxViewDistance);
+	if (Game_AutoQualityLevel > 0) distance = min(distance, AutoQuality_ViewDistance());
 	if (distance == Game_ViewDistance) return;
 	Game_ViewDistance = distance;
 
@@ -205,6 +310,7 @@ void Game_UpdateBlock(int x, int y, int z, BlockID block) {
 	}
 	Lighting.OnBlockChanged(x, y, z, old, block);
 	MapRenderer_OnBlockChanged(x, y, z, block);
+	Searcher_OnBlockChanged(x, y, z);
 }
 
 void Game_ChangeBlock(int x, int y, int z, BlockID block) {
@@ -225,7 +331,7 @@ cc_bool Game_UpdateTexture(GfxResourceID* texId, struct Stream* src, const cc_st
 	cc_bool success;
 	cc_result res;
 	
-	res = Png_Decode(&bmp, src);
+	res = TexturePack_DecodePng(&bmp, src);
 	if (res) { Logger_SysWarn2(res, "decoding", file); }
 	
 	/* E.g. gui.png only need top half of the texture loaded */
@@ -457,6 +563,7 @@ static void Game_Load(void) {
 	Game_AddComponent(&Gui_Component);
 	Game_AddComponent(&Selections_Component);
 	Game_AddComponent(&HeldBlockRenderer_Component);
+	Game_AddComponent(&IsometricDrawer_Component);
 	/* Gfx_SetDepthWrite(true) */
 	Game_AddComponent(&SelOutlineRenderer_Component);
 	Game_AddComponent(&Audio_Component);
@@ -469,6 +576,7 @@ static void Game_Load(void) {
 		if (comp->Init) comp->Init();
 	}
 
+	AutoQuality_Init();
 	TexturePack_ExtractCurrent(true);
 	if (TexturePack_DefaultMissing) {
 		Window_ShowDialog("Missing file",
@@ -590,6 +698,225 @@ static void PerformScheduledTasks(double time) {
 	}
 }
 
+/* Screenshot is rendered as columns x rows tiles, and then stitched into one large image */
+static int tiled_cols, tiled_rows;
+
+void Game_RequestTiledScreenshot(int columns, int rows) {
+	tiled_cols = max(1, columns);
+	tiled_rows = max(1, rows);
+	Game_ScreenshotRequested = true;
+}
+
+#ifdef CC_BUILD_GFXREADBACK
+struct TiledCapture {
+	struct Matrix proj;
+	BitmapCol* strip; /* Pixels of the current row of tiles */
+	int cols, rows, tileWidth, tileHeight, stripRow;
+	float t;
+	cc_result res;
+};
+
+/* Renders the given tile, by scaling and offsetting clip space so only that part of the view fills the viewport */
+static cc_result TiledCapture_RenderTile(struct TiledCapture* c, int col, int row) {
+	float ox = (float)(c->cols - 1 - 2 * col);
+	float oy = (float)(2 * row - (c->rows - 1));
+	struct Vec4* rows = &Gfx.Projection.row1;
+	struct Bitmap tile;
+	cc_result res;
+	int i, y;
+
+	Gfx.Projection = c->proj;
+	for (i = 0; i < 4; i++) {
+		rows[i].x = rows[i].x * c->cols + rows[i].w * ox;
+		rows[i].y = rows[i].y * c->rows + rows[i].w * oy;
+	}
+	Gfx_LoadMatrix(MATRIX_PROJ, &Gfx.Projection);
+
+	Gfx_ClearBuffers(GFX_BUFFER_COLOR | GFX_BUFFER_DEPTH);
+	Render3DFrame(0.0f, c->t);
+
+	res = Gfx_ReadScreenshot(&tile);
+	if (res) return res;
+
+	if (tile.width != c->tileWidth || tile.height != c->tileHeight) res = ERR_NOT_SUPPORTED;
+	if (!res) {
+		for (y = 0; y < tile.height; y++) {
+			Mem_Copy(c->strip + (y * c->cols + col) * c->tileWidth, Bitmap_GetRow(&tile, y), 
+					c->tileWidth * BITMAPCOLOR_SIZE);
+		}
+	}
+	Mem_Free(tile.scan0);
+	return res;
+}
+
+static BitmapCol* TiledCapture_GetRow(struct Bitmap* bmp, int y, void* ctx) {
+	struct TiledCapture* c = (struct TiledCapture*)ctx;
+	int col, row = y / c->tileHeight;
+
+	/* Rows are encoded in order, so only one row of tiles needs to be kept in memory */
+	if (row != c->stripRow) {
+		c->stripRow = row;
+		for (col = 0; col < c->cols && !c->res; col++) {
+			c->res = TiledCapture_RenderTile(c, col, row);
+		}
+	}
+	return c->strip + (y % c->tileHeight) * c->cols * c->tileWidth;
+}
+
+static cc_result TiledCapture_Save(struct Stream* stream, int cols, int rows) {
+	struct TiledCapture c;
+	struct Bitmap bmp;
+	cc_bool hideGui;
+	cc_result res;
+
+	c.cols = cols; c.rows = rows;
+	c.tileWidth  = Game.Width;
+	c.tileHeight = Game.Height;
+	c.stripRow   = -1;
+	c.proj       = Gfx.Projection;
+	c.t          = (float)(tasks[entTaskI].accumulator / tasks[entTaskI].interval);
+	c.res        = 0;
+
+	if (c.cols * c.tileWidth  > PNG_MAX_DIMS) return PNG_ERR_TOO_WIDE;
+	if (c.rows * c.tileHeight > PNG_MAX_DIMS) return PNG_ERR_TOO_TALL;
+	c.strip = (BitmapCol*)Mem_TryAlloc(c.cols * c.tileWidth * c.tileHeight, BITMAPCOLOR_SIZE);
+	if (!c.strip) return ERR_OUT_OF_MEMORY;
+
+	/* Held block and selection outline would otherwise appear in every tile */
+	hideGui      = Game_HideGui;
+	Game_HideGui = true;
+
+	Bitmap_Init(bmp, c.cols * c.tileWidth, c.rows * c.tileHeight, c.strip);
+	res = Png_Encode(&bmp, stream, TiledCapture_GetRow, false, &c);
+	if (!res) res = c.res;
+
+	Game_HideGui = hideGui;
+	Camera_UpdateProjection();
+	Mem_Free(c.strip);
+	return res;
+}
+#endif
+
+#if defined CC_BUILD_GFXREADBACK && !defined CC_BUILD_WEB && !defined CC_BUILD_COOPTHREADED
+#define CC_BUILD_ASYNCSCREENSHOTS
+#endif
+
+#ifdef CC_BUILD_ASYNCSCREENSHOTS
+/* Screenshots are read back on the main thread, but then encoded and saved on a worker thread */
+#define SCREENSHOTS_MAX_PENDING 4
+
+struct ScreenshotJob {
+	struct Bitmap bmp;
+	cc_filepath path;
+	cc_string filename; char filenameBuffer[STRING_SIZE];
+	cc_result res;
+	struct ScreenshotJob* next;
+};
+
+static void* screenshots_mutex;
+static struct ScreenshotJob* screenshots_queue;
+static struct ScreenshotJob* screenshots_done;
+static cc_bool screenshots_working;
+static int screenshots_pending;
+
+static void ScreenshotWorker_Run(void) {
+	struct ScreenshotJob* job;
+	struct Stream stream;
+	cc_result res;
+
+	for (;;) {
+		Mutex_Lock(screenshots_mutex);
+		job = screenshots_queue;
+		if (job) { screenshots_queue = job->next; } 
+		else     { screenshots_working = false; }
+		Mutex_Unlock(screenshots_mutex);
+		if (!job) return;
+
+		res = Stream_CreatePath(&stream, &job->path);
+		if (!res) {
+			res = Png_Encode(&job->bmp, &stream, NULL, false, NULL);
+			if (res) { stream.Close(&stream); } 
+			else     { res = stream.Close(&stream); }
+		}
+		job->res = res;
+		Mem_Free(job->bmp.scan0);
+		job->bmp.scan0 = NULL;
+
+		Mutex_Lock(screenshots_mutex);
+		job->next        = screenshots_done;
+		screenshots_done = job;
+		Mutex_Unlock(screenshots_mutex);
+	}
+}
+
+static cc_bool Screenshot_TryQueue(const cc_string* filename, const cc_filepath* path) {
+	struct ScreenshotJob* job;
+	struct ScreenshotJob** tail;
+	cc_bool startWorker;
+	void* thread = NULL;
+	cc_result res;
+
+	if (screenshots_pending >= SCREENSHOTS_MAX_PENDING) return false;
+	job = (struct ScreenshotJob*)Mem_TryAllocCleared(1, sizeof(struct ScreenshotJob));
+	if (!job) return false;
+
+	/* Only reads back the framebuffer, without encoding it */
+	res = Gfx_ReadScreenshot(&job->bmp);
+
+	/* Fallback to saving synchronously */
+	if (res) { Mem_Free(job); return false; }
+
+	String_InitArray(job->filename, job->filenameBuffer);
+	String_Copy(&job->filename, filename);
+	job->path = *path;
+
+	if (!screenshots_mutex) screenshots_mutex = Mutex_Create("Screenshots");
+	screenshots_pending++;
+
+	Mutex_Lock(screenshots_mutex);
+	for (tail = &screenshots_queue; *tail; tail = &(*tail)->next) { }
+	*tail = job;
+
+	startWorker = !screenshots_working;
+	screenshots_working = true;
+	Mutex_Unlock(screenshots_mutex);
+
+	if (startWorker) {
+		Thread_Run(&thread, ScreenshotWorker_Run, 256 * 1024, "Screenshot");
+
+		/* Encode inline if the worker couldn't be started, so screenshots_working gets reset */
+		if (thread) { Thread_Detach(thread); }
+		else        { ScreenshotWorker_Run(); }
+	}
+	return true;
+}
+
+static void Screenshots_Deliver(void) {
+	struct ScreenshotJob* job;
+	struct ScreenshotJob* next;
+
+	Mutex_Lock(screenshots_mutex);
+	job = screenshots_done;
+	screenshots_done = NULL;
+	Mutex_Unlock(screenshots_mutex);
+
+	for (; job; job = next) {
+		next = job->next;
+		screenshots_pending--;
+
+		if (job->res) {
+			Logger_IOWarn2(job->res, "saving to", &job->path);
+		} else {
+			Chat_Add1("&eTaken screenshot as: %s", &job->filename);
+#ifdef CC_BUILD_MOBILE
+			Platform_ShareScreenshot(&job->filename);
+#endif
+		}
+		Mem_Free(job);
+	}
+}
+#endif
+
 void Game_TakeScreenshot(void) {
 	cc_string filename; char fileBuffer[STRING_SIZE];
 	cc_string path;     char pathBuffer[FILENAME_SIZE];
@@ -599,6 +926,8 @@ void Game_TakeScreenshot(void) {
 
 #ifndef CC_BUILD_WEB
 	struct Stream stream;
+	int cols = tiled_cols, rows = tiled_rows;
+	tiled_cols = 0; tiled_rows = 0;
 #endif
 	Game_ScreenshotRequested = false;
 	DateTime_CurrentLocal(&now);
@@ -615,12 +944,21 @@ void Game_TakeScreenshot(void) {
 	if (!Utils_EnsureDirectory("screenshots")) return;
 	String_InitArray(path, pathBuffer);
 	String_Format1(&path, "screenshots/%s", &filename);
-
 	Platform_EncodePath(&raw_path, &path);
+
+#ifdef CC_BUILD_ASYNCSCREENSHOTS
+	if (!cols && Screenshot_TryQueue(&filename, &raw_path)) return;
+#endif
+
 	res = Stream_CreatePath(&stream, &raw_path);
 	if (res) { Logger_IOWarn2(res, "creating", &raw_path); return; }
 
+#ifdef CC_BUILD_GFXREADBACK
+	res = cols ? TiledCapture_Save(&stream, cols, rows) : Gfx_TakeScreenshot(&stream);
+#else
+	/* Tiles can't be read back individually, so just save a normal screenshot */
 	res = Gfx_TakeScreenshot(&stream);
+#endif
 	if (res) {
 		Logger_IOWarn2(res, "saving to", &raw_path); stream.Close(&stream); return;
 	}
@@ -840,12 +1178,27 @@ void Game_RenderFrame(void) {
 #endif
 
 	if (Game_ScreenshotRequested) Game_TakeScreenshot();
+
+	/* Frame time excludes waiting for VSync in Gfx_EndFrame and sleeping to limit FPS */
+	if (Game_AutoQualityLevel >= 0 && !Gui_GetBlocksWorld()) {
+		elapsed = Stopwatch_ElapsedMicroseconds(frameStart, Stopwatch_Measure());
+		if (elapsed > 5000000) elapsed = 5000000;
+		AutoQuality_Update(delta, (int)elapsed / 1000.0f);
+	}
+
 	Gfx_EndFrame();
+#ifdef CC_BUILD_ASYNCSCREENSHOTS
+	if (screenshots_pending) Screenshots_Deliver();
+#endif
 	if (gfx_minFrameMs != 0.0f) LimitFPS();
 }
 
 void Game_Free(void) {
 	struct IGameComponent* comp;
+#ifdef CC_BUILD_ASYNCSCREENSHOTS
+	/* Don't leave partially written screenshots behind */
+	while (screenshots_pending) { Thread_Sleep(10); Screenshots_Deliver(); }
+#endif
 	/* Most components will call OnContextLost in their Free functions */
 	/* Set to false so components will always free managed textures too */
 	Gfx.ManagedTextures = false;
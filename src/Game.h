@@ -51,6 +51,10 @@ extern cc_string Game_Mppass;
 extern int Game_ViewDistance;
 extern int Game_MaxViewDistance;
 extern int Game_UserViewDistance;
+/* Current automatic quality level (0 = user's settings, higher = lower quality), -1 if disabled */
+extern int   Game_AutoQualityLevel;
+/* Frame time (in milliseconds) 90% of recent frames were under, as measured by automatic quality */
+extern float Game_AutoQualityFrameTime;
 
 /* Strategy used to limit FPS (see FpsLimitMethod enum) */
 extern int     Game_FpsLimit;
@@ -68,6 +72,8 @@ extern cc_bool Game_ViewBobbing;
 extern cc_bool Game_BreakableLiquids;
 /* Whether a screenshot should be taken at the end of this frame */
 extern cc_bool Game_ScreenshotRequested;
+/* Requests a screenshot rendered as columns x rows tiles, which are stitched into one large image */
+void Game_RequestTiledScreenshot(int columns, int rows);
 extern cc_bool Game_HideGui;
 
 enum GAME_VERSION_ {
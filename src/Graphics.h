@@ -443,6 +443,13 @@ CC_API void Gfx_SetScissor (int x, int y, int w, int h);
 *#########################################################################################################################*/
 /* Outputs a .png screenshot of the backbuffer */
 cc_result Gfx_TakeScreenshot(struct Stream* output);
+#if CC_GFX_BACKEND_IS_GL() || CC_GFX_BACKEND == CC_GFX_BACKEND_D3D9 || CC_GFX_BACKEND == CC_GFX_BACKEND_D3D11 || \
+	CC_GFX_BACKEND == CC_GFX_BACKEND_SOFTGPU || CC_GFX_BACKEND == CC_GFX_BACKEND_SOFTMIN || CC_GFX_BACKEND == CC_GFX_BACKEND_SOFTFP
+#define CC_BUILD_GFXREADBACK
+/* Reads the backbuffer into a newly allocated top-down bitmap */
+/* NOTE: bmp->scan0 must be freed by the caller */
+cc_result Gfx_ReadScreenshot(struct Bitmap* bmp);
+#endif
 /* Warns in chat if the graphics backend has problems with the user's GPU */
 /* Returns whether legacy rendering mode for borders/sky/clouds is needed */
 cc_bool Gfx_WarnIfNecessary(void);
@@ -1150,15 +1150,23 @@ void Gfx_DepthOnlyRendering(cc_bool depthOnly) {
 /*########################################################################################################################*
 *-----------------------------------------------------------Misc----------------------------------------------------------*
 *#########################################################################################################################*/
-static BitmapCol* D3D11_GetRow(struct Bitmap* bmp, int y, void* ctx) {
-	D3D11_MAPPED_SUBRESOURCE* buffer = (D3D11_MAPPED_SUBRESOURCE*)ctx;
-	char* row = (char*)buffer->pData + y * buffer->RowPitch;
-	return (BitmapCol*)row;
+static cc_result D3D11_CopyRows(struct Bitmap* bmp, D3D11_TEXTURE2D_DESC* desc, D3D11_MAPPED_SUBRESOURCE* buffer) {
+	int y;
+	bmp->width  = desc->Width;
+	bmp->height = desc->Height;
+
+	bmp->scan0  = (BitmapCol*)Mem_TryAlloc(bmp->width * bmp->height, BITMAPCOLOR_SIZE);
+	if (!bmp->scan0) return ERR_OUT_OF_MEMORY;
+
+	for (y = 0; y < bmp->height; y++)
+	{
+		Mem_Copy(Bitmap_GetRow(bmp, y), (char*)buffer->pData + y * buffer->RowPitch, bmp->width * BITMAPCOLOR_SIZE);
+	}
+	return 0;
 }
 
-cc_result Gfx_TakeScreenshot(struct Stream* output) {
+cc_result Gfx_ReadScreenshot(struct Bitmap* bmp) {
 	ID3D11Texture2D* tmp = NULL;
-	struct Bitmap bmp;
 	HRESULT hr;
 
 	ID3D11Resource* backbuffer_res;
@@ -1184,8 +1192,7 @@ cc_result Gfx_TakeScreenshot(struct Stream* output) {
 	hr = ID3D11DeviceContext_Map(context, tmp, 0, D3D11_MAP_READ, 0, &buffer);
 	if (hr) goto finished;
 	{
-		Bitmap_Init(bmp, desc.Width, desc.Height, NULL);
-		hr = Png_Encode(&bmp, output, D3D11_GetRow, false, &buffer);
+		hr = D3D11_CopyRows(bmp, &desc, &buffer);
 	}
 	ID3D11DeviceContext_Unmap(context, tmp, 0);
 
@@ -809,12 +809,26 @@ void Gfx_CalcPerspectiveMatrix(struct Matrix* matrix, float fov, float aspect, f
 /*########################################################################################################################*
 *-----------------------------------------------------------Misc----------------------------------------------------------*
 *#########################################################################################################################*/
-cc_result Gfx_TakeScreenshot(struct Stream* output) {
+static cc_result D3D9_CopyRows(struct Bitmap* bmp, D3DSURFACE_DESC* desc, D3DLOCKED_RECT* rect) {
+	int y;
+	bmp->width  = desc->Width;
+	bmp->height = desc->Height;
+
+	bmp->scan0  = (BitmapCol*)Mem_TryAlloc(bmp->width * bmp->height, BITMAPCOLOR_SIZE);
+	if (!bmp->scan0) return ERR_OUT_OF_MEMORY;
+
+	for (y = 0; y < bmp->height; y++)
+	{
+		Mem_Copy(Bitmap_GetRow(bmp, y), (cc_uint8*)rect->pBits + y * rect->Pitch, bmp->width * BITMAPCOLOR_SIZE);
+	}
+	return 0;
+}
+
+cc_result Gfx_ReadScreenshot(struct Bitmap* bmp) {
 	IDirect3DSurface9* backbuffer = NULL;
 	IDirect3DSurface9* temp = NULL;
 	D3DSURFACE_DESC desc;
 	D3DLOCKED_RECT rect;
-	struct Bitmap bmp;
 	cc_result res;
 
 	res = IDirect3DDevice9_GetBackBuffer(device, 0, 0, D3DBACKBUFFER_TYPE_MONO, &backbuffer);
@@ -830,12 +844,11 @@ cc_result Gfx_TakeScreenshot(struct Stream* output) {
 	res = IDirect3DSurface9_LockRect(temp, &rect, NULL, D3DLOCK_READONLY | D3DLOCK_NO_DIRTY_UPDATE);
 	if (res) goto finished;
 	{
-		Bitmap_Init(bmp, desc.Width, desc.Height, (BitmapCol*)rect.pBits);
-		res = Png_Encode(&bmp, output, NULL, false, NULL);
+		res = D3D9_CopyRows(bmp, &desc, &rect);
 		if (res) { IDirect3DSurface9_UnlockRect(temp); goto finished; }
 	}
 	res = IDirect3DSurface9_UnlockRect(temp);
-	if (res) goto finished;
+	if (res) { Mem_Free(bmp->scan0); goto finished; }
 
 finished:
 	D3D9_FreeResource(backbuffer);
@@ -1036,14 +1036,19 @@ void Gfx_DrawIndexedTris_T2fC4b(int verticesCount, int startVertex) {
 /*########################################################################################################################*
 *---------------------------------------------------------Other/Misc------------------------------------------------------*
 *#########################################################################################################################*/
-static BitmapCol* CB_GetRow(struct Bitmap* bmp, int y, void* ctx) {
-	return colorBuffer + cb_stride * y;
-}
+cc_result Gfx_ReadScreenshot(struct Bitmap* bmp) {
+	int y;
+	bmp->width  = fb_width;
+	bmp->height = fb_height;
 
-cc_result Gfx_TakeScreenshot(struct Stream* output) {
-	struct Bitmap bmp;
-	Bitmap_Init(bmp, fb_width, fb_height, NULL);
-	return Png_Encode(&bmp, output, CB_GetRow, false, NULL);
+	bmp->scan0  = (BitmapCol*)Mem_TryAlloc(fb_width * fb_height, BITMAPCOLOR_SIZE);
+	if (!bmp->scan0) return ERR_OUT_OF_MEMORY;
+
+	for (y = 0; y < fb_height; y++)
+	{
+		Mem_Copy(Bitmap_GetRow(bmp, y), colorBuffer + cb_stride * y, fb_width * BITMAPCOLOR_SIZE);
+	}
+	return 0;
 }
 
 cc_bool Gfx_WarnIfNecessary(void) { return false; }
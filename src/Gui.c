@@ -353,6 +353,43 @@ static void ShowCinematicBars() {
 	Gfx_DrawVb_IndexedTris(count);
 }
 
+/*########################################################################################################################*
+*-----------------------------------------------------Draw batching-------------------------------------------------------*
+*#########################################################################################################################*/
+static struct GuiDrawBatch {
+	GfxResourceID texID;
+	int offset, count, hints;
+} gui_batch;
+static int gui_drawsSaved;
+
+void Gui_DrawRange(GfxResourceID texID, int verticesCount, int startVertex, int hints) {
+	struct GuiDrawBatch* b = &gui_batch;
+
+	if (b->count && b->texID == texID && b->offset + b->count == startVertex) {
+		b->count += verticesCount;
+		/* Merged vertices must only use hints that apply to all of them */
+		if (b->hints != hints) b->hints = (b->hints && hints) ? DRAW_HINT_SPRITE : DRAW_HINT_NONE;
+
+		gui_drawsSaved++;
+		return;
+	}
+
+	Gui_FlushDraws();
+	b->texID  = texID;
+	b->offset = startVertex;
+	b->count  = verticesCount;
+	b->hints  = hints;
+}
+
+void Gui_FlushDraws(void) {
+	struct GuiDrawBatch* b = &gui_batch;
+	if (!b->count) return;
+
+	Gfx_BindTexture(b->texID);
+	Gfx_DrawVb_IndexedTris_Range(b->count, b->offset, (DrawHints)b->hints);
+	b->count = 0;
+}
+
 void Gui_RenderGui(float delta) {
 	struct Screen* s;
 	int i;
@@ -372,9 +409,12 @@ void Gui_RenderGui(float delta) {
 
 		if (s->dirty) { s->VTABLE->BuildMesh(s); s->dirty = false; }
 		s->VTABLE->Render(s, delta);
+		Gui_FlushDraws();
 	}
 
 	Gfx_3DS_SetRenderScreen(TOP_SCREEN);
+	Gui.DrawsSaved = gui_drawsSaved;
+	gui_drawsSaved = 0;
 }
 
 
@@ -453,6 +493,161 @@ void TextAtlas_AddInt(struct TextAtlas* atlas, int value, struct VertexTextured*
 }
 
 
+/*########################################################################################################################*
+*-------------------------------------------------------GlyphAtlas--------------------------------------------------------*
+*#########################################################################################################################*/
+#define GLYPHATLAS_WIDTH 512
+
+static void GlyphAtlas_Measure(struct GlyphAtlas* atlas, struct FontDesc* font) {
+	struct DrawTextArgs args;
+	char pair[2];
+	int i, width;
+	DrawTextArgs_MakeEmpty(&args, font, false);
+
+	for (i = 0; i < GLYPHATLAS_MAX_GLYPHS; i++)
+	{
+		pair[0] = (char)i; pair[1] = (char)i;
+		args.text = String_Init(pair, 1, 1);
+		width     = Drawer2D_TextWidth(&args);
+
+		/* Measuring two glyphs accounts for padding between glyphs */
+		args.text = String_Init(pair, 2, 2);
+		atlas->widths[i]   = width;
+		atlas->advances[i] = max(0, Drawer2D_TextWidth(&args) - width);
+	}
+}
+/* Pointless to draw quads for spaces */
+#define GlyphAtlas_HasQuad(atlas, c) ((atlas)->widths[c] && (c) != ' ')
+
+cc_bool GlyphAtlas_Make(struct GlyphAtlas* atlas, struct FontDesc* font, cc_bool useShadow) {
+	struct DrawTextArgs args;
+	struct Context2D ctx;
+	BitmapCol oldWhite;
+	char glyph;
+	int i, x, y, height;
+
+	GlyphAtlas_Free(atlas);
+	if (Gfx.LostContext || (Gfx.Limitations & GFX_LIMIT_NO_UV_SUPPORT)) return false;
+	if (font->flags & FONT_FLAGS_UNDERLINE) return false;
+
+	GlyphAtlas_Measure(atlas, font);
+	atlas->cellHeight   = Font_CalcHeight(font, false);
+	atlas->lineHeight   = Font_CalcHeight(font, useShadow);
+	atlas->shadowOffset = useShadow ? Font_CalcShadowOffset(font) : 0;
+
+	/* Pack glyphs into rows */
+	x = 0; y = 0;
+	for (i = 0; i < GLYPHATLAS_MAX_GLYPHS; i++)
+	{
+		if (x + atlas->widths[i] > GLYPHATLAS_WIDTH) { x = 0; y += atlas->cellHeight; }
+		atlas->x[i] = x;
+		atlas->y[i] = y;
+		x += atlas->widths[i] + 1;
+	}
+	height = y + atlas->cellHeight;
+
+	/* Glyphs are drawn in white, then tinted by vertex colour when drawing */
+	oldWhite = Drawer2D.Colors['f'];
+	Drawer2D.Colors['f'] = BITMAPCOLOR_WHITE;
+	DrawTextArgs_MakeEmpty(&args, font, false);
+
+	Context2D_Alloc(&ctx, GLYPHATLAS_WIDTH, height);
+	{
+		for (i = 0; i < GLYPHATLAS_MAX_GLYPHS; i++)
+		{
+			if (!GlyphAtlas_HasQuad(atlas, i)) continue;
+			glyph     = (char)i;
+			args.text = String_Init(&glyph, 1, 1);
+			Context2D_DrawText(&ctx, &args, atlas->x[i], atlas->y[i]);
+		}
+		Gfx_RecreateTexture(&atlas->texID, &ctx.bmp, TEXTURE_FLAG_NONPOW2 | TEXTURE_FLAG_LOWRES, false);
+	}
+	Context2D_Free(&ctx);
+	Drawer2D.Colors['f'] = oldWhite;
+
+	atlas->uScale = Context2D_CalcUV(1, ctx.bmp.width);
+	atlas->vScale = Context2D_CalcUV(1, ctx.bmp.height);
+	return atlas->texID != 0;
+}
+
+void GlyphAtlas_Free(struct GlyphAtlas* atlas) { Gfx_DeleteTexture(&atlas->texID); }
+
+int GlyphAtlas_TextWidth(struct GlyphAtlas* atlas, const cc_string* text) {
+	cc_string left = *text, part;
+	char colorCode = 'f';
+	int i, width = 0, last = -1;
+
+	while (Drawer2D_UNSAFE_NextPart(&left, &part, &colorCode))
+	{
+		for (i = 0; i < part.length; i++)
+		{
+			last   = (cc_uint8)part.buffer[i];
+			width += atlas->advances[last];
+		}
+	}
+
+	if (last == -1) return 0;
+	/* Last glyph has no padding after it */
+	return width - atlas->advances[last] + atlas->widths[last] + atlas->shadowOffset;
+}
+
+int GlyphAtlas_CountQuads(struct GlyphAtlas* atlas, const cc_string* text) {
+	cc_string left = *text, part;
+	char colorCode = 'f';
+	int i, count = 0;
+
+	while (Drawer2D_UNSAFE_NextPart(&left, &part, &colorCode))
+	{
+		for (i = 0; i < part.length; i++)
+		{
+			if (GlyphAtlas_HasQuad(atlas, (cc_uint8)part.buffer[i])) count++;
+		}
+	}
+	return atlas->shadowOffset ? count * 2 : count;
+}
+
+static void GlyphAtlas_AddPass(struct GlyphAtlas* atlas, const cc_string* text, int x, int y, 
+								cc_bool shadow, struct VertexTextured** vertices) {
+	cc_string left = *text, part;
+	char colorCode = 'f';
+	struct Texture tex;
+	BitmapCol color;
+	PackedCol col;
+	int i, c;
+
+	tex.x = x; tex.y = y;
+	tex.height = atlas->cellHeight;
+
+	while (Drawer2D_UNSAFE_NextPart(&left, &part, &colorCode))
+	{
+		color = Drawer2D_GetColor(colorCode);
+		if (shadow) color = GetShadowColor(color);
+		col = PackedCol_Make(BitmapCol_R(color), BitmapCol_G(color), BitmapCol_B(color), BitmapCol_A(color));
+
+		for (i = 0; i < part.length; i++)
+		{
+			c = (cc_uint8)part.buffer[i];
+			if (GlyphAtlas_HasQuad(atlas, c)) {
+				tex.width  = atlas->widths[c];
+				tex.uv.u1  = atlas->x[c] * atlas->uScale;
+				tex.uv.u2  = (atlas->x[c] + tex.width)  * atlas->uScale;
+				tex.uv.v1  = atlas->y[c] * atlas->vScale;
+				tex.uv.v2  = (atlas->y[c] + tex.height) * atlas->vScale;
+				Gfx_Make2DQuad(&tex, col, vertices);
+			}
+			tex.x += atlas->advances[c];
+		}
+	}
+}
+
+void GlyphAtlas_AddText(struct GlyphAtlas* atlas, const cc_string* text, int x, int y, struct VertexTextured** vertices) {
+	int offset = atlas->shadowOffset;
+	/* Shadows are drawn first, so they always end up behind all of the text */
+	if (offset) GlyphAtlas_AddPass(atlas, text, x + offset, y + offset, true, vertices);
+	GlyphAtlas_AddPass(atlas, text, x, y, false, vertices);
+}
+
+
 /*########################################################################################################################*
 *-------------------------------------------------------Widget base-------------------------------------------------------*
 *#########################################################################################################################*/
@@ -525,6 +720,7 @@ void Screen_Render2Widgets(void* screen, float delta) {
 		if (!widgets[i]) continue;
 		offset = Widget_Render2(widgets[i], offset);
 	}
+	Gui_FlushDraws();
 }
 
 void Screen_UpdateVb(void* screen) {
@@ -69,6 +69,8 @@ CC_VAR extern struct _GuiData {
 	float BarSize;
 	/* The color of the cinematic bars, if enabled. */
 	PackedCol CinematicBarColor;
+	/* Number of 2D draw calls that were merged together in the last frame. */
+	int DrawsSaved;
 } Gui;
 
 #ifdef CC_BUILD_TOUCH
@@ -137,6 +139,13 @@ struct Screen { Screen_Body };
 /* Calls Widget_Render2 on each widget in the screen. */
 void Screen_Render2Widgets(void* screen, float delta);
 void Screen_UpdateVb(void* screen);
+
+/* Queues drawing a range of vertices from the currently bound vertex buffer using the given texture */
+/* Consecutive ranges drawn with the same texture are merged into a single draw call */
+/* NOTE: Gui_FlushDraws must be called before binding another vertex buffer or drawing directly */
+void Gui_DrawRange(GfxResourceID texID, int verticesCount, int startVertex, int hints);
+/* Issues the draw call for any queued vertices */
+void Gui_FlushDraws(void);
 struct VertexTextured* Screen_LockVb(void* screen);
 int Screen_DoPointerDown(void* screen, int id, int x, int y);
 int Screen_CalcDefaultMaxVertices(void* screen);
@@ -300,6 +309,27 @@ void TextAtlas_Free(struct TextAtlas* atlas);
 void TextAtlas_Add(struct TextAtlas* atlas, int charI, struct VertexTextured** vertices);
 void TextAtlas_AddInt(struct TextAtlas* atlas, int value, struct VertexTextured** vertices);
 
+#define GLYPHATLAS_MAX_GLYPHS 256
+/* Caches every glyph of a font in a single texture, so that text can be drawn */
+/*  as quads from that texture instead of creating a new texture per string */
+struct GlyphAtlas {
+	GfxResourceID texID;
+	int cellHeight, lineHeight, shadowOffset;
+	float uScale, vScale;
+	cc_uint16 x[GLYPHATLAS_MAX_GLYPHS], y[GLYPHATLAS_MAX_GLYPHS];
+	cc_uint16 widths[GLYPHATLAS_MAX_GLYPHS], advances[GLYPHATLAS_MAX_GLYPHS];
+};
+/* Rasterises all glyphs of the given font into the atlas */
+/* Returns false if text must instead be drawn using Drawer2D_MakeTextTexture */
+cc_bool GlyphAtlas_Make(struct GlyphAtlas* atlas, struct FontDesc* font, cc_bool useShadow);
+void GlyphAtlas_Free(struct GlyphAtlas* atlas);
+/* Returns how wide the given text is when drawn using the atlas */
+int  GlyphAtlas_TextWidth(struct GlyphAtlas* atlas, const cc_string* text);
+/* Returns how many quads are needed to draw the given text */
+int  GlyphAtlas_CountQuads(struct GlyphAtlas* atlas, const cc_string* text);
+/* Adds quads for drawing the given text (and its shadow) at the given coordinates */
+void GlyphAtlas_AddText(struct GlyphAtlas* atlas, const cc_string* text, int x, int y, struct VertexTextured** vertices);
+
 #define Elem_Render(elem, delta) (elem)->VTABLE->Render(elem, delta)
 #define Elem_Free(elem)          (elem)->VTABLE->Free(elem)
 #define Elem_HandlesKeyPress(elem, key) (elem)->VTABLE->HandlesKeyPress(elem, key)
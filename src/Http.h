@@ -14,8 +14,16 @@ struct ScheduledTask;
 struct StringsBuffer;
 
 #define URL_MAX_SIZE (STRING_SIZE * 2)
+/* Request is started before all other pending requests in the same priority class */
 #define HTTP_FLAG_PRIORITY 0x01
 #define HTTP_FLAG_NOCACHE  0x02
+/* Priority classes - pending requests in a higher class are always started first */
+/*  (requests without any of these flags are between map env and skin requests) */
+#define HTTP_FLAG_TEXTURE_PACK 0x04 /* Highest priority */
+#define HTTP_FLAG_MAP_ENV      0x08
+#define HTTP_FLAG_SKIN         0x10 /* Lowest priority */
+/* Response is saved to the disk cache, and revalidated against it on later requests */
+#define HTTP_FLAG_CACHE        0x20
 
 extern struct IGameComponent Http_Component;
 
@@ -44,6 +52,8 @@ struct HttpRequest {
 	char lastModified[STRING_SIZE]; /* Time item cached at (if at all) */
 	char etag[STRING_SIZE];         /* ETag of cached item (if any) */
 	cc_uint8 requestType;           /* See the various REQUEST_TYPE_ */
+	cc_uint8 priority;              /* Priority class of this request (lower is started first) */
+	cc_uint8 flags;                 /* HTTP_FLAG_ flags the request was made with */
 	cc_bool success;                /* Whether Result is 0, status is 200, and data is not NULL */
 	struct StringsBuffer* cookies;  /* Cookie list sent in requests. May be modified by the response. */
 };
@@ -268,46 +268,81 @@ static cc_result HttpConnection_Write(struct HttpConnection* conn, const cc_uint
 /*########################################################################################################################*
 *-----------------------------------------------------Connection Pool-----------------------------------------------------*
 *#########################################################################################################################*/
+/* NOTE: Pool is shared between all the worker threads, so entries are marked */
+/*  as in use to ensure each connection is only used by one request at a time */
 static struct ConnectionPoolEntry {
 	struct HttpConnection conn;
 	cc_string addr;
 	char addrBuffer[STRING_SIZE];
 	cc_bool https;
+	cc_bool inUse;
 } connection_pool[10];
+static void* poolMutex;
 
-static cc_result ConnectionPool_Insert(int i, struct HttpConnection** conn, const struct HttpUrl* url) {
-	struct ConnectionPoolEntry* e = &connection_pool[i];
-	*conn = &e->conn;
-
-	String_InitArray(e->addr, e->addrBuffer);
-	String_Copy(&e->addr, &url->address);
-	e->https = url->https;
-	return HttpConnection_Open(&e->conn, url);
-}
-
-static cc_result ConnectionPool_Open(struct HttpConnection** conn, const struct HttpUrl* url) {
+/* NOTE: Must be called while poolMutex is locked */
+static int ConnectionPool_Find(const struct HttpUrl* url) {
 	struct ConnectionPoolEntry* e;
-	int i;
+	int i, evict = -1;
 
+	/* Reuse an idle keep-alive connection to the same host if possible */
 	for (i = 0; i < Array_Elems(connection_pool); i++)
 	{
 		e = &connection_pool[i];
-		if (e->conn.valid && e->https == url->https && String_Equals(&e->addr, &url->address)) {
-			*conn = &connection_pool[i].conn;
-			return 0;
-		}
+		if (e->inUse || !e->conn.valid) continue;
+		if (e->https == url->https && String_Equals(&e->addr, &url->address)) return i;
 	}
 
 	for (i = 0; i < Array_Elems(connection_pool); i++)
 	{
 		e = &connection_pool[i];
-		if (!e->conn.valid) return ConnectionPool_Insert(i, conn, url);
+		if (e->inUse) continue;
+		if (!e->conn.valid) return i;
+		evict = i;
 	}
 
 	/* TODO: Should we be consistent in which entry gets evicted? */
-	i = (cc_uint8)Stopwatch_Measure() % Array_Elems(connection_pool);
-	HttpConnection_Close(&connection_pool[i].conn);
-	return ConnectionPool_Insert(i, conn, url);
+	if (evict >= 0) HttpConnection_Close(&connection_pool[evict].conn);
+	return evict;
+}
+
+static cc_result ConnectionPool_Open(struct HttpConnection** conn, const struct HttpUrl* url) {
+	struct ConnectionPoolEntry* e;
+	cc_bool reused;
+	int i;
+
+	Mutex_Lock(poolMutex);
+	{
+		i = ConnectionPool_Find(url);
+		if (i >= 0) {
+			e = &connection_pool[i];
+			e->inUse = true;
+			reused   = e->conn.valid;
+
+			String_InitArray(e->addr, e->addrBuffer);
+			String_Copy(&e->addr, &url->address);
+			e->https = url->https;
+		}
+	}
+	Mutex_Unlock(poolMutex);
+
+	/* Should never happen, as there are more pool entries than worker threads */
+	if (i < 0) return ERR_INVALID_ARGUMENT;
+
+	*conn = &e->conn;
+	if (reused) return 0;
+	return HttpConnection_Open(&e->conn, url);
+}
+
+static void ConnectionPool_Release(struct HttpConnection* conn) {
+	int i;
+	Mutex_Lock(poolMutex);
+	{
+		for (i = 0; i < Array_Elems(connection_pool); i++)
+		{
+			if (&connection_pool[i].conn == conn) connection_pool[i].inUse = false;
+		}
+	}
+	Mutex_Unlock(poolMutex);
 }
 
 
@@ -660,6 +695,7 @@ static cc_result HttpClient_HandleRedirect(struct HttpClientState* state) {
 *#########################################################################################################################*/
 static void HttpBackend_Init(void) {
 	SSLBackend_Init(httpsVerify);
+	poolMutex = Mutex_Create("HTTP connections");
 }
 
 static void Http_AddHeader(struct HttpRequest* req, const char* key, const cc_string* value) {
@@ -669,15 +705,15 @@ static void Http_AddHeader(struct HttpRequest* req, const char* key, const cc_st
 static cc_result HttpBackend_PerformRequest(struct HttpClientState* state) {
 	cc_result res;
 
+	state->conn = NULL;
 	res = ConnectionPool_Open(&state->conn, &state->url);
-	if (res) { HttpConnection_Close(state->conn); return res; }
+	if (!state->conn) return res;
 
-	res = HttpClient_SendRequest(state);
-	if (res) { HttpConnection_Close(state->conn); return res; }
+	if (!res) res = HttpClient_SendRequest(state);
+	if (!res) res = HttpClient_ParseResponse(state);
 
-	res = HttpClient_ParseResponse(state);
 	if (res) HttpConnection_Close(state->conn);
-
+	ConnectionPool_Release(state->conn);
 	return res;
 }
 static const char* verbs[] = { "GET", "HEAD", "POST" };
@@ -727,14 +763,29 @@ static cc_bool HttpBackend_DescribeError(cc_result res, cc_string* dst) {
 #endif
 
 
-static void* workerWaitable;
-static void* workerThread;
+/* Requests are performed by several worker threads at once, so one slow server */
+/*  doesn't delay every other request (e.g. texture packs waiting behind skins) */
+#ifdef CC_BUILD_LOWMEM
+	#define HTTP_MAX_WORKERS 1
+#else
+	#define HTTP_MAX_WORKERS 4
+#endif
+/* Maximum number of requests performed at once to the same host */
+#define HTTP_MAX_HOST_WORKERS 2
+
+static struct HttpWorker {
+	void* thread;
+	void* waitable;
+	struct HttpRequest req; /* Request currently being performed (id is 0 if none) */
+	cc_string host;         /* Host of current request (protected by pendingMutex) */
+	char _hostBuffer[STRING_SIZE];
+} http_workers[HTTP_MAX_WORKERS];
+static int http_numWorkers;
 
 static void* pendingMutex;
 static struct RequestList pendingReqs;
 
 static void* curRequestMutex;
-static struct HttpRequest http_curRequest;
 
 
 /*########################################################################################################################*
@@ -753,20 +804,37 @@ cc_bool Http_GetResult(int reqID, struct HttpRequest* item) {
 }
 
 cc_bool Http_GetCurrent(int* reqID, int* progress) {
+	int i;
+	*reqID    = 0;
+	*progress = HTTP_PROGRESS_NOT_WORKING_ON;
+
 	Mutex_Lock(curRequestMutex);
 	{
-		*reqID    = http_curRequest.id;
-		*progress = http_curRequest.progress;
+		/* Report the oldest request still being performed */
+		for (i = 0; i < http_numWorkers; i++)
+		{
+			if (!http_workers[i].req.id) continue;
+			if (*reqID && http_workers[i].req.id > *reqID) continue;
+
+			*reqID    = http_workers[i].req.id;
+			*progress = http_workers[i].req.progress;
+		}
 	}
 	Mutex_Unlock(curRequestMutex);
 	return *reqID != 0;
 }
 
 int Http_CheckProgress(int reqID) {
-	int curReqID, progress;
-	Http_GetCurrent(&curReqID, &progress);
+	int i, progress = HTTP_PROGRESS_NOT_WORKING_ON;
 
-	if (reqID != curReqID) progress = HTTP_PROGRESS_NOT_WORKING_ON;
+	Mutex_Lock(curRequestMutex);
+	{
+		for (i = 0; i < http_numWorkers; i++)
+		{
+			if (http_workers[i].req.id == reqID) progress = http_workers[i].req.progress;
+		}
+	}
+	Mutex_Unlock(curRequestMutex);
 	return progress;
 }
 
@@ -793,15 +861,427 @@ void Http_TryCancel(int reqID) {
 }
 
 
+/*########################################################################################################################*
+*-----------------------------------------------------Http disk cache-----------------------------------------------------*
+*#########################################################################################################################*/
+/* Responses to HTTP_FLAG_CACHE requests are kept on disk, then revalidated using If-None-Match/If-Modified-Since */
+/*  on later requests. Data files are named by CRC32 and size of their contents, so identical responses are only stored once */
+#ifndef CC_BUILD_LOWMEM
+#define HTTPCACHE_DIR "texturecache/http"
+#define HTTPCACHE_MAX_ENTRIES 1024
+#define HTTPCACHE_VERSION 2
+/* Maximum size of an entry in the index file (including the length prefix of each tag) */
+#define HTTPCACHE_MAX_RECORD (16 + 3 + 2 * STRING_SIZE + URL_MAX_SIZE)
+
+struct HttpCacheEntry {
+	cc_uint32 urlKey;   /* CRC32 of the request URL */
+	cc_uint32 dataKey;  /* CRC32 of the response data */
+	cc_uint32 size;     /* Size of the response data */
+	cc_uint32 lastUsed; /* Value of httpCache_useCount when entry was last used */
+	char etag[STRING_SIZE];
+	char lastModified[STRING_SIZE];
+	char url[URL_MAX_SIZE]; /* Full URL, since different URLs may have the same CRC32 */
+};
+
+static struct HttpCacheEntry* httpCache_entries;
+static int httpCache_count;
+static cc_uint32 httpCache_totalSize, httpCache_maxSize, httpCache_useCount;
+static void* httpCacheMutex;
+/* Index is only saved when the worker is idle, rather than after every response */
+static cc_bool httpCache_dirty, httpCache_pruned;
+static const cc_string httpCache_index = String_FromConst(HTTPCACHE_DIR "/index.bin");
+
+static cc_bool HttpCache_Cacheable(struct HttpRequest* req) {
+	return httpCache_entries && (req->flags & HTTP_FLAG_CACHE) 
+		&& !(req->flags & HTTP_FLAG_NOCACHE) && req->requestType == REQUEST_TYPE_GET;
+}
+
+static cc_uint32 HttpCache_UrlKey(struct HttpRequest* req) {
+	cc_string url = String_FromRawArray(req->url);
+	return Utils_CRC32((const cc_uint8*)url.buffer, url.length);
+}
+
+static void HttpCache_GetPath(cc_uint32 dataKey, cc_uint32 size, cc_string* path) {
+	String_Format2(path, HTTPCACHE_DIR "/%h-%h.bin", &dataKey, &size);
+}
+
+static int HttpCache_Find(cc_uint32 urlKey, struct HttpRequest* req) {
+	cc_string url = String_FromRawArray(req->url);
+	cc_string entryUrl;
+	int i;
+
+	for (i = 0; i < httpCache_count; i++)
+	{
+		if (httpCache_entries[i].urlKey != urlKey) continue;
+		entryUrl = String_FromRawArray(httpCache_entries[i].url);
+		if (String_Equals(&entryUrl, &url)) return i;
+	}
+	return -1;
+}
+
+static cc_bool HttpCache_DataShared(cc_uint32 dataKey, cc_uint32 size) {
+	int i;
+	for (i = 0; i < httpCache_count; i++)
+	{
+		if (httpCache_entries[i].dataKey == dataKey && httpCache_entries[i].size == size) return true;
+	}
+	return false;
+}
+
+static void HttpCache_CopyTag(char* dst, const char* src) {
+	cc_string str = String_Init((char*)src, String_CalcLen(src, STRING_SIZE), STRING_SIZE);
+	String_CopyToRaw(dst, STRING_SIZE, &str);
+}
+
+/* Writes a u8 length prefixed tag, returning number of bytes written */
+/* NOTE: Tags which fill their buffer have no null terminator, but must still be written in full */
+static int HttpCache_WriteTag(cc_uint8* dst, const char* tag, int capacity) {
+	int len = String_CalcLen(tag, capacity);
+	dst[0]  = (cc_uint8)len;
+	Mem_Copy(dst + 1, tag, len);
+	return len + 1;
+}
+
+static void HttpCache_SaveIndex(void) {
+	struct HttpCacheEntry* e;
+	cc_uint8* data;
+	cc_uint32 len;
+	int i;
+
+	data = (cc_uint8*)Mem_TryAlloc(16 + httpCache_count * HTTPCACHE_MAX_RECORD, 1);
+	if (!data) return;
+
+	data[0] = 'C'; data[1] = 'C'; data[2] = 'H'; data[3] = 'C';
+	Stream_SetU32_LE(data +  4, HTTPCACHE_VERSION);
+	Stream_SetU32_LE(data +  8, httpCache_count);
+	Stream_SetU32_LE(data + 12, httpCache_useCount);
+	len = 16;
+
+	for (i = 0; i < httpCache_count; i++)
+	{
+		e = &httpCache_entries[i];
+		Stream_SetU32_LE(data + len +  0, e->urlKey);
+		Stream_SetU32_LE(data + len +  4, e->dataKey);
+		Stream_SetU32_LE(data + len +  8, e->size);
+		Stream_SetU32_LE(data + len + 12, e->lastUsed);
+		len += 16;
+
+		len += HttpCache_WriteTag(data + len, e->etag,         STRING_SIZE);
+		len += HttpCache_WriteTag(data + len, e->lastModified, STRING_SIZE);
+		len += HttpCache_WriteTag(data + len, e->url,          URL_MAX_SIZE);
+	}
+
+	(void)Stream_WriteAllTo(&httpCache_index, data, len);
+	Mem_Free(data);
+	httpCache_dirty = false;
+}
+
+/* Reads a u8 length prefixed tag, returning false if tag goes past end of data */
+static cc_bool HttpCache_ReadTag(const cc_uint8* data, cc_uint32 len, cc_uint32* offset, char* tag, int capacity) {
+	cc_uint32 tagLen;
+	if (*offset >= len) return false;
+
+	tagLen = data[*offset]; *offset += 1;
+	if (tagLen > (cc_uint32)capacity || *offset + tagLen > len) return false;
+
+	Mem_Copy(tag, data + *offset, tagLen);
+	if (tagLen < (cc_uint32)capacity) tag[tagLen] = '\0';
+	*offset += tagLen;
+	return true;
+}
+
+static void HttpCache_ParseIndex(const cc_uint8* data, cc_uint32 len) {
+	struct HttpCacheEntry* e;
+	cc_uint32 i, count, offset = 16;
+
+	if (len < 16 || data[0] != 'C' || data[1] != 'C' || data[2] != 'H' || data[3] != 'C') return;
+	if (Stream_GetU32_LE(data + 4) != HTTPCACHE_VERSION) return;
+
+	count = Stream_GetU32_LE(data + 8);
+	count = min(count, HTTPCACHE_MAX_ENTRIES);
+	httpCache_useCount = Stream_GetU32_LE(data + 12);
+
+	for (i = 0; i < count; i++)
+	{
+		if (offset + 16 > len) break;
+		e = &httpCache_entries[httpCache_count];
+
+		e->urlKey   = Stream_GetU32_LE(data + offset +  0);
+		e->dataKey  = Stream_GetU32_LE(data + offset +  4);
+		e->size     = Stream_GetU32_LE(data + offset +  8);
+		e->lastUsed = Stream_GetU32_LE(data + offset + 12);
+		offset += 16;
+
+		if (!HttpCache_ReadTag(data, len, &offset, e->etag,         STRING_SIZE))  break;
+		if (!HttpCache_ReadTag(data, len, &offset, e->lastModified, STRING_SIZE))  break;
+		if (!HttpCache_ReadTag(data, len, &offset, e->url,          URL_MAX_SIZE)) break;
+
+		httpCache_totalSize += e->size;
+		httpCache_count++;
+	}
+}
+
+static void HttpCache_LoadIndex(void) {
+	struct Stream stream;
+	cc_uint8* data;
+	cc_uint32 len;
+	cc_result res;
+
+	if (Stream_OpenFile(&stream, &httpCache_index)) return;
+
+	if (!(res = stream.Length(&stream, &len)) && len) {
+		data = (cc_uint8*)Mem_TryAlloc(len, 1);
+		if (data && !Stream_Read(&stream, data, len)) HttpCache_ParseIndex(data, len);
+		Mem_Free(data);
+	}
+	/* No point logging error for closing readonly file */
+	(void)stream.Close(&stream);
+}
+
+static void HttpCache_DeleteFile(const cc_string* path) {
+	cc_filepath raw;
+	Platform_EncodePath(&raw, path);
+	(void)File_Delete(&raw);
+}
+
+/* Removes the given entry, deleting its data file if no other entry uses it */
+static void HttpCache_Remove(int i) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	cc_uint32 dataKey = httpCache_entries[i].dataKey;
+	cc_uint32 size    = httpCache_entries[i].size;
+
+	httpCache_totalSize -= size;
+	for (; i < httpCache_count - 1; i++)
+	{
+		httpCache_entries[i] = httpCache_entries[i + 1];
+	}
+	httpCache_count--;
+	httpCache_dirty = true;
+	if (HttpCache_DataShared(dataKey, size)) return;
+
+	String_InitArray(path, pathBuffer);
+	HttpCache_GetPath(dataKey, size, &path);
+	HttpCache_DeleteFile(&path);
+}
+
+static int HttpCache_FindOldest(void) {
+	int i, oldest = 0;
+	for (i = 1; i < httpCache_count; i++)
+	{
+		if (httpCache_entries[i].lastUsed < httpCache_entries[oldest].lastUsed) oldest = i;
+	}
+	return oldest;
+}
+
+/* Loads the cached response data for the given entry into the request */
+static cc_bool HttpCache_ReadData(struct HttpCacheEntry* e, struct HttpRequest* req) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	struct Stream stream;
+	cc_uint32 len;
+	cc_uint8* data;
+	cc_bool valid = false;
+
+	String_InitArray(path, pathBuffer);
+	HttpCache_GetPath(e->dataKey, e->size, &path);
+	if (Stream_OpenFile(&stream, &path)) return false;
+
+	if (!stream.Length(&stream, &len) && len == e->size && len) {
+		data = (cc_uint8*)Mem_TryAlloc(len, 1);
+
+		if (data && !Stream_Read(&stream, data, len) && Utils_CRC32(data, len) == e->dataKey) {
+			HttpRequest_Free(req);
+			req->data = data; req->size = len; req->_capacity = len;
+			valid = true;
+		} else {
+			Mem_Free(data);
+		}
+	}
+	(void)stream.Close(&stream);
+	return valid;
+}
+
+/* Whether the given file contains exactly the given data */
+static cc_bool HttpCache_SameData(const cc_string* path, const cc_uint8* data, cc_uint32 size) {
+	struct Stream stream;
+	cc_uint8* existing;
+	cc_bool same = false;
+	if (Stream_OpenFile(&stream, path)) return false;
+
+	existing = (cc_uint8*)Mem_TryAlloc(size, 1);
+	if (existing && !Stream_Read(&stream, existing, size)) {
+		same = Mem_Equal(existing, data, size);
+	}
+
+	Mem_Free(existing);
+	(void)stream.Close(&stream);
+	return same;
+}
+
+static void HttpCache_Store(struct HttpRequest* req, cc_uint32 urlKey) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	struct HttpCacheEntry* e;
+	cc_uint32 dataKey;
+	int i;
+	/* Don't let one large response evict most of the cache */
+	if (req->size > httpCache_maxSize / 4) return;
+
+	dataKey = Utils_CRC32(req->data, req->size);
+	i = HttpCache_Find(urlKey, req);
+	if (i >= 0) HttpCache_Remove(i);
+
+	while (httpCache_count && (httpCache_count >= HTTPCACHE_MAX_ENTRIES 
+			|| httpCache_totalSize + req->size > httpCache_maxSize))
+	{
+		HttpCache_Remove(HttpCache_FindOldest());
+	}
+
+	String_InitArray(path, pathBuffer);
+	HttpCache_GetPath(dataKey, req->size, &path);
+
+	if (HttpCache_DataShared(dataKey, req->size)) {
+		/* Different data with the same CRC32 and size can't share the file */
+		if (!HttpCache_SameData(&path, req->data, req->size)) return;
+	} else if (Stream_WriteAllTo(&path, req->data, req->size)) {
+		return;
+	}
+
+	e = &httpCache_entries[httpCache_count++];
+	e->urlKey   = urlKey;
+	e->dataKey  = dataKey;
+	e->size     = req->size;
+	e->lastUsed = ++httpCache_useCount;
+	HttpCache_CopyTag(e->etag,         req->etag);
+	HttpCache_CopyTag(e->lastModified, req->lastModified);
+	Mem_Copy(e->url, req->url, sizeof(e->url));
+
+	httpCache_totalSize += req->size;
+	httpCache_dirty      = true;
+}
+
+/* Sets conditional request headers, if a response for the request's URL is cached */
+static void HttpCache_Begin(struct HttpRequest* req) {
+	int i;
+	if (!HttpCache_Cacheable(req)) return;
+
+	Mutex_Lock(httpCacheMutex);
+	{
+		i = HttpCache_Find(HttpCache_UrlKey(req), req);
+		if (i >= 0) {
+			HttpCache_CopyTag(req->etag,         httpCache_entries[i].etag);
+			HttpCache_CopyTag(req->lastModified, httpCache_entries[i].lastModified);
+		}
+	}
+	Mutex_Unlock(httpCacheMutex);
+}
+
+/* Updates the disk cache from the response, returning false if the request needs to be performed again */
+static cc_bool HttpCache_End(struct HttpRequest* req) {
+	cc_uint32 urlKey;
+	cc_bool valid = true;
+	int i;
+	if (!HttpCache_Cacheable(req)) return true;
+	urlKey = HttpCache_UrlKey(req);
+
+	Mutex_Lock(httpCacheMutex);
+	{
+		i = HttpCache_Find(urlKey, req);
+
+		if (!req->result && req->statusCode == 304) {
+			/* Cached copy is still valid (if it still exists on disk) */
+			valid = i >= 0 && HttpCache_ReadData(&httpCache_entries[i], req);
+			if (valid) req->statusCode = 200;
+		} else if (!req->result && req->statusCode == 200) {
+			if (req->data && req->size) HttpCache_Store(req, urlKey);
+			i = -1;
+		} else if ((req->result || req->statusCode >= 500) && i >= 0) {
+			/* Server is unreachable, so fallback to the possibly stale cached copy */
+			if (HttpCache_ReadData(&httpCache_entries[i], req)) {
+				Platform_Log1("HTTP: using cached copy of %c", req->url);
+				req->result     = 0;
+				req->statusCode = 200;
+			}
+		}
+
+		/* Index is saved later, as rewriting it on every cache hit is wasteful */
+		if (valid && i >= 0) {
+			httpCache_entries[i].lastUsed = ++httpCache_useCount;
+			httpCache_dirty = true;
+		} else if (!valid && i >= 0) {
+			HttpCache_Remove(i);
+		}
+	}
+	Mutex_Unlock(httpCacheMutex);
+
+	if (valid) return true;
+	req->etag[0]         = '\0';
+	req->lastModified[0] = '\0';
+	return false;
+}
+
+static void HttpCache_PruneFile(const cc_string* file, void* obj, int isDirectory) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	struct HttpCacheEntry* e;
+	int i;
+	if (isDirectory || String_Equals(file, &httpCache_index)) return;
+	String_InitArray(path, pathBuffer);
+
+	for (i = 0; i < httpCache_count; i++)
+	{
+		e = &httpCache_entries[i];
+		path.length = 0;
+		HttpCache_GetPath(e->dataKey, e->size, &path);
+		if (String_Equals(file, &path)) return;
+	}
+	HttpCache_DeleteFile(file);
+}
+
+/* Deletes data files not referenced by the index (e.g. when index wasn't saved before exiting) */
+static void HttpCache_Prune(void) {
+	static const cc_string dir = String_FromConst(HTTPCACHE_DIR);
+	httpCache_pruned = true;
+	Directory_Enum(&dir, NULL, HttpCache_PruneFile);
+}
+
+/* Saves the index, if any entries have changed */
+static void HttpCache_Flush(void) {
+	if (!httpCacheMutex) return;
+
+	Mutex_Lock(httpCacheMutex);
+	{
+		if (!httpCache_pruned) HttpCache_Prune();
+		if (httpCache_dirty)   HttpCache_SaveIndex();
+	}
+	Mutex_Unlock(httpCacheMutex);
+}
+
+static void HttpCache_Init(void) {
+	if (httpCacheMutex || Platform_ReadonlyFilesystem) return;
+	if (!Utils_EnsureDirectory("texturecache") || !Utils_EnsureDirectory(HTTPCACHE_DIR)) return;
+
+	httpCache_entries = (struct HttpCacheEntry*)Mem_TryAlloc(HTTPCACHE_MAX_ENTRIES, sizeof(struct HttpCacheEntry));
+	if (!httpCache_entries) return;
+
+	httpCache_maxSize = Options_GetInt(OPT_HTTP_CACHE_SIZE, 1, 1024, 64) * 1024 * 1024;
+	httpCacheMutex    = Mutex_Create("HTTP cache");
+	HttpCache_LoadIndex();
+}
+#else
+static void HttpCache_Init(void) { }
+static void HttpCache_Begin(struct HttpRequest* req) { }
+static cc_bool HttpCache_End(struct HttpRequest* req) { return true; }
+static void HttpCache_Flush(void) { }
+#endif
+
+
 /*########################################################################################################################*
 *-----------------------------------------------------Http worker---------------------------------------------------------*
 *#########################################################################################################################*/
 /* Sets up state to begin a http request */
-static void SetCurrentRequest(struct HttpRequest* req) {
+static void SetCurrentRequest(struct HttpWorker* worker, struct HttpRequest* req) {
 	Mutex_Lock(curRequestMutex);
 	{
-		HttpRequest_Copy(&http_curRequest, req);
-		http_curRequest.progress = HTTP_PROGRESS_MAKING_REQUEST;
+		HttpRequest_Copy(&worker->req, req);
+		worker->req.progress = HTTP_PROGRESS_MAKING_REQUEST;
 	}
 	Mutex_Unlock(curRequestMutex);
 }
@@ -810,8 +1290,15 @@ static void PerformRequest(struct HttpRequest* req) {
 	cc_uint64 beg, end;
 	int elapsed;
 
+	HttpCache_Begin(req);
 	beg = Stopwatch_Measure();
 	req->result = HttpBackend_Do(req);
+
+	/* Cached copy is missing or corrupted, so download it again */
+	if (!HttpCache_End(req)) {
+		req->result = HttpBackend_Do(req);
+		HttpCache_End(req);
+	}
 	end = Stopwatch_Measure();
 
 	elapsed = Stopwatch_ElapsedMS(beg, end);
@@ -821,60 +1308,113 @@ static void PerformRequest(struct HttpRequest* req) {
 	Http_FinishRequest(req);
 }
 
-static void ClearCurrentRequest(void) {
+static void ClearCurrentRequest(struct HttpWorker* worker) {
 	Mutex_Lock(curRequestMutex);
 	{
-		http_curRequest.id       = 0;
-		http_curRequest.progress = HTTP_PROGRESS_NOT_WORKING_ON;
+		worker->req.id       = 0;
+		worker->req.progress = HTTP_PROGRESS_NOT_WORKING_ON;
 	}
 	Mutex_Unlock(curRequestMutex);
 }
 
-static void DoRequest(struct HttpRequest* request) {
-	SetCurrentRequest(request);
-	PerformRequest(&http_curRequest);
-	ClearCurrentRequest();
+static void DoRequest(struct HttpWorker* worker, struct HttpRequest* request) {
+	SetCurrentRequest(worker, request);
+	PerformRequest(&worker->req);
+	ClearCurrentRequest(worker);
+}
+
+/* Returns the host part of the given request's URL (e.g. "classicube.net" for "https://classicube.net/") */
+static cc_string GetRequestHost(struct HttpRequest* req) {
+	cc_string url = String_FromRawArray(req->url);
+	int i = String_IndexOfConst(&url, "://");
+	if (i >= 0) url = String_UNSAFE_SubstringAt(&url, i + 3);
+
+	i = String_IndexOf(&url, '/');
+	if (i >= 0) url.length = i;
+	return url;
+}
+
+/* Finds the highest priority pending request whose host isn't already at its connection limit */
+/* NOTE: Must be called while pendingMutex is locked */
+static int FindNextRequest(void) {
+	cc_string host;
+	int i, j, active;
+
+	for (i = 0; i < pendingReqs.count; i++)
+	{
+		host   = GetRequestHost(&pendingReqs.entries[i]);
+		active = 0;
+
+		for (j = 0; j < http_numWorkers; j++)
+		{
+			if (String_CaselessEquals(&http_workers[j].host, &host)) active++;
+		}
+		if (active < HTTP_MAX_HOST_WORKERS) return i;
+	}
+	return -1;
 }
 
 static void WorkerLoop(void) {
+	struct HttpWorker* worker;
 	struct HttpRequest request;
 	cc_bool hasRequest;
+	cc_string host;
+	int i;
+
+	/* Claim the next worker slot for this thread */
+	Mutex_Lock(pendingMutex);
+	{
+		worker = &http_workers[http_numWorkers++];
+	}
+	Mutex_Unlock(pendingMutex);
 
 	for (;;) {
 		hasRequest = false;
 
 		Mutex_Lock(pendingMutex);
 		{
-			if (pendingReqs.count) {
-				HttpRequest_Copy(&request, &pendingReqs.entries[0]);
+			worker->host.length = 0;
+			i = FindNextRequest();
+
+			if (i >= 0) {
+				HttpRequest_Copy(&request, &pendingReqs.entries[i]);
 				hasRequest = true;
-				RequestList_RemoveAt(&pendingReqs, 0);
+				RequestList_RemoveAt(&pendingReqs, i);
+
+				host = GetRequestHost(&request);
+				String_Copy(&worker->host, &host);
 			}
 		}
 		Mutex_Unlock(pendingMutex);
 
 		if (hasRequest) {
-			DoRequest(&request);
+			DoRequest(worker, &request);
 		} else {
+			HttpCache_Flush();
 			/* Block until another thread submits a request to do */
 			Platform_LogConst("Download queue empty, going back to sleep...");
-			Waitable_Wait(workerWaitable);
+			Waitable_Wait(worker->waitable);
 		}
 	}
 }
 
-/* Adds a req to the list of pending requests, waking up worker thread if needed */
+/* Adds a req to the list of pending requests, waking up worker threads if needed */
 static void HttpBackend_Add(struct HttpRequest* req, cc_uint8 flags) {
+	int i;
 #if defined CC_BUILD_PSP || defined CC_BUILD_NDS
 	/* TODO why doesn't threading work properly on PSP */
-	DoRequest(req);
+	DoRequest(&http_workers[0], req);
 #else
 	Mutex_Lock(pendingMutex);
 	{
 		RequestList_Append(&pendingReqs, req, flags);
 	}
 	Mutex_Unlock(pendingMutex);
-	Waitable_Signal(workerWaitable);
+
+	for (i = 0; i < HTTP_MAX_WORKERS; i++)
+	{
+		Waitable_Signal(http_workers[i].waitable);
+	}
 #endif
 }
 
@@ -882,20 +1422,37 @@ static void HttpBackend_Add(struct HttpRequest* req, cc_uint8 flags) {
 *-----------------------------------------------------Http component------------------------------------------------------*
 *#########################################################################################################################*/
 static void Http_Init(void) {
+	struct HttpWorker* worker;
+	int i;
+
 	Http_InitCommon();
-	http_curRequest.progress = HTTP_PROGRESS_NOT_WORKING_ON;
 	/* Http component gets initialised multiple times on Android */
-	if (workerThread) return;
+	if (http_workers[0].waitable) return;
 
 	HttpBackend_Init();
+	HttpCache_Init();
 	RequestList_Init(&pendingReqs);
 	RequestList_Init(&processedReqs);
 
-	workerWaitable  = Waitable_Create("HTTP wakeup");
 	pendingMutex    = Mutex_Create("HTTP pending");
 	processedMutex  = Mutex_Create("HTTP processed");
 	curRequestMutex = Mutex_Create("HTTP current");
-	
-	Thread_Run(&workerThread, WorkerLoop, 128 * 1024, "HTTP");
+
+	for (i = 0; i < HTTP_MAX_WORKERS; i++)
+	{
+		worker = &http_workers[i];
+		worker->req.progress = HTTP_PROGRESS_NOT_WORKING_ON;
+		worker->waitable     = Waitable_Create("HTTP wakeup");
+		String_InitArray(worker->host, worker->_hostBuffer);
+	}
+
+#if defined CC_BUILD_PSP || defined CC_BUILD_NDS
+	http_numWorkers = 1;
+#else
+	for (i = 0; i < HTTP_MAX_WORKERS; i++)
+	{
+		Thread_Run(&http_workers[i].thread, WorkerLoop, 128 * 1024, "HTTP");
+	}
+#endif
 }
 #endif
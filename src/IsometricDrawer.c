@@ -7,15 +7,30 @@
 #include "TexturePack.h"
 #include "Block.h"
 #include "Game.h"
+#include "Gui.h"
+#include "Platform.h"
+#include "Bitmap.h"
+#include "Event.h"
+#include "Animations.h"
+#include "Funcs.h"
 
 static struct VertexTextured* iso_vertices;
 static struct VertexTextured* iso_vertices_base;
 static int* iso_state;
+/* Start of vertices/state for the current layer of blocks */
+static struct VertexTextured* iso_layer_vertices;
+static int* iso_layer_state;
 
 static cc_bool iso_cacheInited;
 static PackedCol iso_colorXSide, iso_colorZSide, iso_colorYBottom;
 static float iso_posX, iso_posY;
 
+/* States from ISO_ICON_STATE onwards refer to icon atlases instead of terrain atlases */
+#define ISO_ICON_STATE ATLAS1D_MAX_ATLASES
+#define ISO_ICON_SLOTS 2
+#define ISO_ICON_PAGES 16
+#define ISO_MAX_STATES (ISO_ICON_STATE + ISO_ICON_SLOTS * ISO_ICON_PAGES)
+
 #define iso_cosX  (0.86602540378443864f) /* cos(30  * MATH_DEG2RAD) */
 #define iso_sinX  (0.50000000000000000f) /* sin(30  * MATH_DEG2RAD) */
 #define iso_cosY  (0.70710678118654752f) /* cos(-45 * MATH_DEG2RAD) */
@@ -118,30 +133,420 @@ static void IsometricDrawer_Angled(BlockID block, float size) {
 	}
 }
 
+static void IsometricDrawer_Draw(BlockID block, float size) {
+#if CC_BUILD_FPU_MODE <= CC_FPU_MODE_MINIMAL
+	IsometricDrawer_Flat(block, size);
+#else
+	if (Blocks.Draw[block] == DRAW_SPRITE) {
+		IsometricDrawer_Flat(block, size);
+	} else {
+		IsometricDrawer_Angled(block, size);
+	}
+#endif
+}
+
+
+/*########################################################################################################################*
+*-------------------------------------------------------Icon atlas--------------------------------------------------------*
+*#########################################################################################################################*/
+/* Blocks are rasterised once into an icon atlas, after which each block is drawn using just one flat quad */
+/*  (icons are rasterised at the exact size they are drawn at, so they look the same as the 3D quads) */
+#if !defined CC_BUILD_LOWMEM && CC_BUILD_FPU_MODE > CC_FPU_MODE_MINIMAL
+/* Icons are stored in fixed size pages, so that adding icons never changes */
+/*  the texture coordinates of icons already used in other widgets' meshes */
+struct IconPage {
+	struct Bitmap bmp;
+	GfxResourceID texID;
+	int dirtyMin, dirtyMax; /* Rows of bitmap changed since it was last uploaded */
+};
+struct IconAtlas {
+	float size;       /* Size of blocks the icons were rasterised for, 0 if slot is unused */
+	int cellSize;     /* Width and height of each icon in pixels */
+	int perRow;       /* Number of icons in each row of a page */
+	int perPage;      /* Number of icons in each page */
+	int count;        /* Number of icons rasterised so far */
+	int width, height;
+	cc_uint32 lastUsed;
+	struct IconPage pages[ISO_ICON_PAGES];
+	cc_uint16 cells[BLOCK_COUNT]; /* Icon index + 1 of each block, 0 if not rasterised yet */
+};
+static struct IconAtlas iso_icons[ISO_ICON_SLOTS];
+static struct IconAtlas* iso_curIcons;
+static cc_bool iso_iconsChecked;
+static cc_uint32 iso_iconsTime;
+
+/* Icons cover a square of (size * ISO_ICON_EXTENT) pixels around the centre of the block */
+/*  (a full block extends up to (size * 1.112) pixels from the centre in Y) */
+#define ISO_ICON_EXTENT 1.125f
+
+static void IconAtlas_Clear(struct IconAtlas* atlas) {
+	struct IconPage* page;
+	int i;
+
+	for (i = 0; i < ISO_ICON_PAGES; i++)
+	{
+		page = &atlas->pages[i];
+		Gfx_DeleteTexture(&page->texID);
+		Mem_Free(page->bmp.scan0);
+
+		page->bmp.scan0 = NULL;
+		page->dirtyMin  = 0;
+		page->dirtyMax  = 0;
+	}
+	atlas->count = 0;
+	Mem_Set(atlas->cells, 0, sizeof(atlas->cells));
+}
+
+/* Returns the icon atlas for blocks of the given size, replacing the least recently used one if needed */
+static struct IconAtlas* IconAtlas_Get(float size) {
+	struct IconAtlas* atlas = &iso_icons[0];
+	int i, cellSize, width, height;
+	if (Gfx.Limitations & GFX_LIMIT_NO_UV_SUPPORT) return NULL;
+	iso_iconsTime++;
+
+	for (i = 0; i < ISO_ICON_SLOTS; i++)
+	{
+		if (iso_icons[i].size == size) {
+			iso_icons[i].lastUsed = iso_iconsTime;
+			return &iso_icons[i];
+		}
+		if (iso_icons[i].lastUsed < atlas->lastUsed) atlas = &iso_icons[i];
+	}
+
+	cellSize = Math_Ceil(size * ISO_ICON_EXTENT) * 2;
+	width    = Math_NextPowOf2(cellSize * 16);
+	height   = Math_NextPowOf2(cellSize * 4);
+	while (width > cellSize && !Gfx_CheckTextureSize(width, height, 0)) width >>= 1;
+	while (height > cellSize && !Gfx_CheckTextureSize(width, height, 0)) height >>= 1;
+	if (width < cellSize || height < cellSize) return NULL;
+
+	/* Meshes of other widgets may still be drawing icons from the replaced atlas */
+	if (atlas->size) Event_RaiseVoid(&TextureEvents.IconsChanged);
+
+	IconAtlas_Clear(atlas);
+	atlas->size     = size;
+	atlas->cellSize = cellSize;
+	atlas->perRow   = width / cellSize;
+	atlas->perPage  = atlas->perRow * (height / cellSize);
+	atlas->width    = width;
+	atlas->height   = height;
+	atlas->lastUsed = iso_iconsTime;
+	return atlas;
+}
+
+/* Whether the icon of the given block can be cached (animated textures can't) */
+static cc_bool IconAtlas_CanCache(BlockID block) {
+	if (!Atlas2D.Bmp.scan0) return false;
+
+	if (Blocks.Draw[block] == DRAW_SPRITE) {
+		return !Animations_IsAnimated(Block_Tex(block, FACE_ZMAX));
+	}
+	return !Animations_IsAnimated(Block_Tex(block, FACE_XMAX)) &&
+		   !Animations_IsAnimated(Block_Tex(block, FACE_ZMIN)) &&
+		   !Animations_IsAnimated(Block_Tex(block, FACE_YMAX));
+}
+
+/* Returns the page which the next icon is stored in, allocating its bitmap if needed */
+static struct IconPage* IconAtlas_NextPage(struct IconAtlas* atlas) {
+	int index = atlas->count / atlas->perPage;
+	struct IconPage* page;
+	if (index >= ISO_ICON_PAGES) return NULL;
+
+	page = &atlas->pages[index];
+	if (page->bmp.scan0) return page;
+
+	page->bmp.scan0 = (BitmapCol*)Mem_TryAllocCleared(atlas->width * atlas->height, BITMAPCOLOR_SIZE);
+	if (!page->bmp.scan0) return NULL;
+
+	page->bmp.width  = atlas->width;
+	page->bmp.height = atlas->height;
+	return page;
+}
+
+/* Returns the pixel in terrain.png at the given coordinates within the given 1D atlas */
+static BitmapCol IconAtlas_Sample(int index, float u, float v) {
+	int tileSize = Atlas2D.TileSize;
+	int rows     = Atlas1D.TilesPerAtlas << Atlas1D.RepeatShift;
+	int x, y, row;
+	TextureLoc loc;
+
+	v  *= rows;
+	row = (int)v;
+	row = min(row, rows - 1);
+	loc = index * Atlas1D.TilesPerAtlas + (row >> Atlas1D.RepeatShift);
+	if (Atlas2D_TileY(loc) >= Atlas2D.RowsCount) return 0;
+
+	x = (int)(u * tileSize);         x = max(0, min(x, tileSize - 1));
+	y = (int)((v - row) * tileSize); y = max(0, min(y, tileSize - 1));
+	return Bitmap_GetPixel(&Atlas2D.Bmp, Atlas2D_TileX(loc) * tileSize + x, 
+										 Atlas2D_TileY(loc) * tileSize + y);
+}
+
+/* Rasterises a projected block face, which is always a parallelogram */
+static void IconAtlas_DrawQuad(struct Bitmap* bmp, int cellX, int cellY, int cellSize,
+							struct VertexTextured* v, int index) {
+	float e1X = v[1].x - v[0].x, e1Y = v[1].y - v[0].y;
+	float e2X = v[3].x - v[0].x, e2Y = v[3].y - v[0].y;
+	float det = e1X * e2Y - e1Y * e2X;
+	float minX, minY, maxX, maxY, dx, dy, a, b, u, t;
+	int i, x, y, x1, y1, x2, y2;
+	PackedCol col = v[0].Col;
+	BitmapCol src;
+	if (Math_AbsF(det) < 0.0001f) return;
+	det = 1.0f / det;
+
+	minX = maxX = v[0].x; minY = maxY = v[0].y;
+	for (i = 1; i < 4; i++)
+	{
+		minX = min(minX, v[i].x); maxX = max(maxX, v[i].x);
+		minY = min(minY, v[i].y); maxY = max(maxY, v[i].y);
+	}
+	x1 = max(cellX, Math_Floor(minX)); x2 = min(cellX + cellSize, Math_Ceil(maxX));
+	y1 = max(cellY, Math_Floor(minY)); y2 = min(cellY + cellSize, Math_Ceil(maxY));
+
+	for (y = y1; y < y2; y++)
+	{
+		for (x = x1; x < x2; x++)
+		{
+			/* Solve (pixel centre - v0) = a * e1 + b * e2 */
+			dx = (x + 0.5f) - v[0].x; dy = (y + 0.5f) - v[0].y;
+			a  = (dx * e2Y - dy * e2X) * det;
+			b  = (e1X * dy - e1Y * dx) * det;
+			if (a < 0.0f || a > 1.0f || b < 0.0f || b > 1.0f) continue;
+
+			u   = v[0].U + a * (v[1].U - v[0].U) + b * (v[3].U - v[0].U);
+			t   = v[0].V + a * (v[1].V - v[0].V) + b * (v[3].V - v[0].V);
+			src = IconAtlas_Sample(index, u, t);
+			if (!BitmapCol_A(src)) continue;
+
+			Bitmap_GetPixel(bmp, x, y) = BitmapCol_Make(
+				BitmapCol_R(src) * PackedCol_R(col) / 255,
+				BitmapCol_G(src) * PackedCol_G(col) / 255,
+				BitmapCol_B(src) * PackedCol_B(col) / 255,
+				BitmapCol_A(src));
+		}
+	}
+}
+
+/* Rasterises the given block into a new icon, returning -1 on failure */
+static int IconAtlas_Add(struct IconAtlas* atlas, BlockID block) {
+	struct VertexTextured vertices[ISOMETRICDRAWER_MAXVERTICES];
+	int state[ISOMETRICDRAWER_MAXVERTICES / 4];
+	struct VertexTextured* oldVertices = iso_vertices;
+	int* oldState = iso_state;
+	float oldX = iso_posX, oldY = iso_posY;
+	struct IconPage* page;
+	int i, quads, x, y, icon, cell;
+
+	if (!IconAtlas_CanCache(block) || !(page = IconAtlas_NextPage(atlas))) return -1;
+	icon = atlas->count++;
+	cell = icon % atlas->perPage;
+	x    = (cell % atlas->perRow) * atlas->cellSize;
+	y    = (cell / atlas->perRow) * atlas->cellSize;
+
+	iso_vertices = vertices; iso_state = state;
+	iso_posX = x + atlas->cellSize * 0.5f;
+	iso_posY = y + atlas->cellSize * 0.5f;
+
+	IsometricDrawer_Draw(block, atlas->size);
+	quads = (int)(iso_state - state);
+	for (i = 0; i < quads; i++)
+	{
+		IconAtlas_DrawQuad(&page->bmp, x, y, atlas->cellSize, &vertices[i * 4], state[i]);
+	}
+
+	iso_vertices = oldVertices; iso_state = oldState;
+	iso_posX     = oldX;        iso_posY  = oldY;
+	atlas->cells[block] = icon + 1;
+
+	/* Only the rows of the page containing the new icon need to be uploaded again */
+	if (page->dirtyMax > page->dirtyMin) {
+		page->dirtyMin = min(page->dirtyMin, y);
+		page->dirtyMax = max(page->dirtyMax, y + atlas->cellSize);
+	} else {
+		page->dirtyMin = y;
+		page->dirtyMax = y + atlas->cellSize;
+	}
+	return icon;
+}
+
+/* Buffers a quad which draws the given block from the icon atlas */
+static cc_bool IconAtlas_AddBatch(BlockID block, float size) {
+	struct IconAtlas* atlas;
+	struct VertexTextured* v;
+	float x1, y1, x2, y2, u1, v1, u2, v2, half;
+	int icon, cell;
+
+	/* Only blocks with the same size as the first block in a batch use icons */
+	/*  (e.g. so the larger selected block in the inventory doesn't evict the other icons) */
+	if (!iso_iconsChecked) {
+		iso_curIcons     = IconAtlas_Get(size);
+		iso_iconsChecked = true;
+	}
+	atlas = iso_curIcons;
+	if (!atlas || atlas->size != size) return false;
+
+	icon = atlas->cells[block] - 1;
+	if (icon < 0) icon = IconAtlas_Add(atlas, block);
+	if (icon < 0) return false;
+
+	half = atlas->cellSize * 0.5f;
+	x1 = iso_posX - half; x2 = iso_posX + half;
+	y1 = iso_posY - half; y2 = iso_posY + half;
+
+	cell = icon % atlas->perPage;
+	u1 = (float)((cell % atlas->perRow) * atlas->cellSize) / atlas->width;
+	u2 = u1 + (float)atlas->cellSize / atlas->width;
+	v1 = (float)((cell / atlas->perRow) * atlas->cellSize) / atlas->height;
+	v2 = v1 + (float)atlas->cellSize / atlas->height;
+
+	v = iso_vertices;
+	v->x = x1; v->y = y1; v->z = 0; v->Col = PACKEDCOL_WHITE; v->U = u1; v->V = v1; v++;
+	v->x = x2; v->y = y1; v->z = 0; v->Col = PACKEDCOL_WHITE; v->U = u2; v->V = v1; v++;
+	v->x = x2; v->y = y2; v->z = 0; v->Col = PACKEDCOL_WHITE; v->U = u2; v->V = v2; v++;
+	v->x = x1; v->y = y2; v->z = 0; v->Col = PACKEDCOL_WHITE; v->U = u1; v->V = v2; v++;
+	iso_vertices = v;
+
+	*iso_state++ = ISO_ICON_STATE + (int)(atlas - iso_icons) * ISO_ICON_PAGES + icon / atlas->perPage;
+	return true;
+}
+
+static GfxResourceID IconAtlas_Bind(int state) {
+	struct IconAtlas* atlas;
+	struct IconPage* page;
+	struct Bitmap part;
+
+	state -= ISO_ICON_STATE;
+	atlas  = &iso_icons[state / ISO_ICON_PAGES];
+	page   = &atlas->pages[state % ISO_ICON_PAGES];
+	if (!page->bmp.scan0) return 0;
+
+	if (!page->texID) {
+		page->texID = Gfx_CreateTexture(&page->bmp, TEXTURE_FLAG_DYNAMIC, false);
+	} else if (page->dirtyMax > page->dirtyMin) {
+		Bitmap_Init(part, page->bmp.width, page->dirtyMax - page->dirtyMin,
+					Bitmap_GetRow(&page->bmp, page->dirtyMin));
+		Gfx_UpdateTexturePart(page->texID, 0, page->dirtyMin, &part, false);
+	}
+
+	page->dirtyMin = 0;
+	page->dirtyMax = 0;
+	return page->texID;
+}
+
+static void IconAtlas_ClearAll(void* obj) {
+	int i;
+	for (i = 0; i < ISO_ICON_SLOTS; i++) IconAtlas_Clear(&iso_icons[i]);
+}
+
+static void IconAtlas_ContextLost(void* obj) {
+	int i, j;
+	for (i = 0; i < ISO_ICON_SLOTS; i++)
+	{
+		/* Whole bitmap is uploaded again when texture is recreated */
+		for (j = 0; j < ISO_ICON_PAGES; j++) Gfx_DeleteTexture(&iso_icons[i].pages[j].texID);
+	}
+}
+
+static void IsometricDrawer_Init(void) {
+	Event_Register_(&TextureEvents.AtlasChanged,  NULL, IconAtlas_ClearAll);
+	Event_Register_(&BlockEvents.BlockDefChanged, NULL, IconAtlas_ClearAll);
+	Event_Register_(&GfxEvents.ContextLost,       NULL, IconAtlas_ContextLost);
+}
+
+static void IsometricDrawer_Free(void) {
+	int i;
+	for (i = 0; i < ISO_ICON_SLOTS; i++)
+	{
+		IconAtlas_Clear(&iso_icons[i]);
+		iso_icons[i].size = 0;
+	}
+}
+#else
+static cc_bool IconAtlas_AddBatch(BlockID block, float size) { return false; }
+static GfxResourceID IconAtlas_Bind(int state) { return 0; }
+
+static void IsometricDrawer_Init(void) { }
+static void IsometricDrawer_Free(void) { }
+#endif
+
+struct IGameComponent IsometricDrawer_Component = {
+	IsometricDrawer_Init, /* Init  */
+	IsometricDrawer_Free  /* Free  */
+};
+
+
+/*########################################################################################################################*
+*--------------------------------------------------------Batching---------------------------------------------------------*
+*#########################################################################################################################*/
 void IsometricDrawer_BeginBatch(struct VertexTextured* vertices, int* state) {
 	IsometricDrawer_InitCache();
 	iso_vertices      = vertices;
 	iso_vertices_base = vertices;
 	iso_state         = state; /* TODO just store TextureLoc ??? */
+
+	iso_layer_vertices = vertices;
+	iso_layer_state    = state;
+#if !defined CC_BUILD_LOWMEM && CC_BUILD_FPU_MODE > CC_FPU_MODE_MINIMAL
+	iso_curIcons     = NULL;
+	iso_iconsChecked = false;
+#endif
 }
 
 void IsometricDrawer_AddBatch(BlockID block, float size, float x, float y) {
 	if (Blocks.Draw[block] == DRAW_GAS) return;
 
 	iso_posX = x; iso_posY = y;
+	if (IconAtlas_AddBatch(block, size)) return;
+	IsometricDrawer_Draw(block, size);
+}
 
-#if CC_BUILD_FPU_MODE <= CC_FPU_MODE_MINIMAL
-	IsometricDrawer_Flat(block, size);
-#else
-	if (Blocks.Draw[block] == DRAW_SPRITE) {
-		IsometricDrawer_Flat(block, size);
-	} else {
-		IsometricDrawer_Angled(block, size);
+/* Sorts the quads in the current layer by atlas, so they can be drawn using fewer draw calls */
+static void IsometricDrawer_SortLayer(void) {
+	int counts[ISO_MAX_STATES] = { 0 };
+	struct VertexTextured* src;
+	int* state = iso_layer_state;
+	int i, idx, total, sorted = true;
+	int quads  = (int)(iso_state - iso_layer_state);
+
+	for (i = 0; i < quads; i++)
+	{
+		counts[state[i]]++;
+		if (i && state[i] < state[i - 1]) sorted = false;
 	}
-#endif
+	if (sorted) return;
+
+	src = (struct VertexTextured*)Mem_TryAlloc(quads * 4, sizeof(struct VertexTextured));
+	if (!src) return;
+	Mem_Copy(src, iso_layer_vertices, quads * 4 * sizeof(struct VertexTextured));
+
+	/* Convert counts into starting quad of each atlas */
+	for (i = 0, total = 0; i < ISO_MAX_STATES; i++)
+	{
+		idx = counts[i]; counts[i] = total; total += idx;
+	}
+
+	/* Stable counting sort, so painter's order is kept for quads using the same atlas */
+	for (i = 0; i < quads; i++)
+	{
+		idx = counts[state[i]]++;
+		Mem_Copy(&iso_layer_vertices[idx * 4], &src[i * 4], 4 * sizeof(struct VertexTextured));
+	}
+	for (i = 0, idx = 0; i < ISO_MAX_STATES; i++)
+	{
+		for (; idx < counts[i]; idx++) state[idx] = i;
+	}
+	Mem_Free(src);
+}
+
+void IsometricDrawer_NextLayer(void) {
+	IsometricDrawer_SortLayer();
+	iso_layer_vertices = iso_vertices;
+	iso_layer_state    = iso_state;
 }
 
 int IsometricDrawer_EndBatch(void) {
+	IsometricDrawer_SortLayer();
 	return (int)(iso_vertices - iso_vertices_base);
 }
 
@@ -151,26 +556,20 @@ int IsometricDrawer_EndBatch(void) {
 	#define ISO_DRAW_HINT DRAW_HINT_NONE
 #endif
 void IsometricDrawer_Render(int count, int offset, int* state) {
-	int i, curIdx, batchBeg, batchLen;
-
-	curIdx   = state[0];
-	batchLen = 0;
-	batchBeg = offset;
+	int i, curIdx = -1;
 
-	for (i = 0; i < count / 4; i++, batchLen += 4) 
+	for (i = 0; i < count / 4; i++, offset += 4) 
 	{
-		if (state[i] == curIdx) continue;
+		if (state[i] >= ISO_ICON_STATE) {
+			curIdx = -1;
+			Gui_DrawRange(IconAtlas_Bind(state[i]), 4, offset, DRAW_HINT_SPRITE);
+			continue;
+		}
 
-		/* Flush previous batch */
-		Atlas1D_Bind(curIdx);
-		Gfx_DrawVb_IndexedTris_Range(batchLen, batchBeg, ISO_DRAW_HINT);
+		/* Binding ensures atlas is loaded when lazily loading atlases */
+		if (state[i] != curIdx) { curIdx = state[i]; Atlas1D_Bind(curIdx); }
 
-		/* Reset for next batch */
-		curIdx   = state[i];
-		batchBeg += batchLen;
-		batchLen = 0;
+		/* Consecutive quads using the same atlas get merged into one draw call */
+		Gui_DrawRange(Atlas1D.TexIds[curIdx], 4, offset, ISO_DRAW_HINT);
 	}
-
-	Atlas1D_Bind(curIdx);
-	Gfx_DrawVb_IndexedTris_Range(batchLen, batchBeg, ISO_DRAW_HINT);
 }
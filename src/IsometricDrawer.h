@@ -7,6 +7,8 @@ CC_BEGIN_HEADER
    Copyright 2014-2025 ClassiCube | Licensed under BSD-3
 */
 struct VertexTextured;
+struct IGameComponent;
+extern struct IGameComponent IsometricDrawer_Component;
 
 /* Maximum number of vertices used to draw a block in isometric way. */
 #define ISOMETRICDRAWER_MAXVERTICES 12
@@ -15,6 +17,9 @@ struct VertexTextured;
 void IsometricDrawer_BeginBatch(struct VertexTextured* vertices, int* state);
 /* Buffers the vertices needed to draw the given block at the given position */
 void IsometricDrawer_AddBatch(BlockID block, float size, float x, float y);
+/* Starts a new layer of blocks, which are always drawn on top of blocks in earlier layers */
+/* NOTE: Blocks within a layer may be reordered, so they must not overlap each other */
+void IsometricDrawer_NextLayer(void);
 /* Returns the number of buffered vertices */
 int  IsometricDrawer_EndBatch(void);
 /* Draws the buffered vertices */
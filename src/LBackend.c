@@ -108,36 +108,34 @@ void LBackend_DrawTitle(struct Context2D* ctx, const char* title) {
 }
 
 /* Scales up flag bitmap if necessary */
-static void LBackend_ScaleFlag(struct Bitmap* bmp) {
+static cc_result LBackend_ScaleFlag(struct Bitmap* bmp) {
 	struct Bitmap scaled;
 	int width  = Display_ScaleX(bmp->width);
 	int height = Display_ScaleY(bmp->height);
 	/* at default DPI don't need to rescale it */
-	if (width == bmp->width && height == bmp->height) return;
+	if (width == bmp->width && height == bmp->height) return 0;
 
 	scaled.width  = width;
 	scaled.height = height;
 	scaled.scan0  = (BitmapCol*)Mem_TryAlloc(width * height, BITMAPCOLOR_SIZE);
-
-	if (!scaled.scan0) {
-		Logger_SysWarn(ERR_OUT_OF_MEMORY, "resizing flags bitmap"); return;
-	}
+	if (!scaled.scan0) return ERR_OUT_OF_MEMORY;
 
 	Bitmap_Scale(&scaled, bmp, 0, 0, bmp->width, bmp->height);
 	Mem_Free(bmp->scan0);
 	*bmp = scaled;
+	return 0;
 }
 
-void LBackend_DecodeFlag(struct Flag* flag, cc_uint8* data, cc_uint32 len) {
+cc_result LBackend_DecodeFlag(struct Flag* flag, cc_uint8* data, cc_uint32 len) {
 	struct Stream s;
 	cc_result res;
 
 	Stream_ReadonlyMemory(&s, data, len);
 	res = Png_Decode(&flag->bmp, &s);
-	if (res) Logger_SysWarn(res, "decoding flag");
 	flag->meta = NULL;
+	if (res) return res;
 
-	LBackend_ScaleFlag(&flag->bmp);
+	return LBackend_ScaleFlag(&flag->bmp);
 }
 
 static void OnPointerMove(void* obj, int idx);
@@ -31,7 +31,8 @@ void LBackend_CloseScreen(struct LScreen* s);
 void LBackend_UpdateTitleFont(void);
 void LBackend_DrawTitle(struct Context2D* ctx, const char* title);
 
-void LBackend_DecodeFlag(struct Flag* flag, cc_uint8* data, cc_uint32 len);
+/* NOTE: This is called from a background thread, so must not log errors itself */
+cc_result LBackend_DecodeFlag(struct Flag* flag, cc_uint8* data, cc_uint32 len);
 void LBackend_TableFlagAdded(struct LTable* w);
 
 /* Marks the entire launcher contents as needing to be redrawn */
@@ -1349,7 +1349,7 @@ static void ServersScreen_Tick(struct LScreen* s_) {
 	LScreen_Tick(s_);
 
 	flagsCount = FetchFlagsTask.count;
-	LWebTask_Tick(&FetchFlagsTask.Base, NULL);
+	FetchFlagsTask_Tick();
 	if (flagsCount != FetchFlagsTask.count) {
 		LBackend_TableFlagAdded(&s->table);
 	}
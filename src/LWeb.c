@@ -469,7 +469,18 @@ void FetchServerTask_Run(const cc_string* hash) {
 > ]}
 */
 struct FetchServersData FetchServersTask;
-static void FetchServersTask_Count(struct JsonContext* ctx) {
+static int serversCapacity;
+
+/* Returns an upper bound on the number of servers in the JSON */
+/*  (much faster than parsing the JSON twice to count the servers) */
+static int FetchServersTask_MaxServers(const cc_uint8* data, cc_uint32 len) {
+	int count = 0;
+	cc_uint32 i;
+	for (i = 0; i < len; i++) { count += data[i] == '{'; }
+	return count;
+}
+
+static void FetchServersTask_Next(struct JsonContext* ctx) {
 	/* JSON is expected in this format: */
 	/*  { "servers" :      (depth = 1)  */
 	/*    [                (depth = 2)  */
@@ -477,12 +488,10 @@ static void FetchServersTask_Count(struct JsonContext* ctx) {
 	/*		 { server2 },  (depth = 3)  */
 	/*          ...                     */
 	if (ctx->depth != 3) return;
-	FetchServersTask.numServers++;
-}
+	/* Should never happen, but redirect any extra servers into the last one just in case */
+	if (FetchServersTask.numServers < serversCapacity) FetchServersTask.numServers++;
 
-static void FetchServersTask_Next(struct JsonContext* ctx) {
-	if (ctx->depth != 3) return;
-	curServer++;
+	curServer = &FetchServersTask.servers[FetchServersTask.numServers - 1];
 	ServerInfo_Init(curServer);
 }
 
@@ -499,17 +508,19 @@ static void FetchServersTask_Handle(cc_uint8* data, cc_uint32 len) {
 	FetchServersTask.servers    = NULL;
 	FetchServersTask.orders     = NULL;
 
-	FetchServersTask.numServers = 0;
-	success = Json_Handle(data, len, NULL, NULL, FetchServersTask_Count);
-	count   = FetchServersTask.numServers;
+	count = FetchServersTask_MaxServers(data, len);
+	if (count <= 0) { Logger_WarnFunc(&err_msg); return; }
 
-	if (!success) Logger_WarnFunc(&err_msg);
-	if (count <= 0) return;
 	FetchServersTask.servers = (struct ServerInfo*)Mem_Alloc(count, sizeof(struct ServerInfo), "servers list");
 	FetchServersTask.orders  = (cc_uint16*)Mem_Alloc(count, 2, "servers order");
+	serversCapacity = count;
 
-	curServer = FetchServersTask.servers - 1;
-	Json_Handle(data, len, ServerInfo_Parse, NULL, FetchServersTask_Next);
+	/* Outer JSON object is also counted above, so servers list always has room for a dummy server */
+	curServer = FetchServersTask.servers;
+	ServerInfo_Init(curServer);
+
+	success = Json_Handle(data, len, ServerInfo_Parse, NULL, FetchServersTask_Next);
+	if (!success) Logger_WarnFunc(&err_msg);
 }
 
 void FetchServersTask_Run(void) {
@@ -627,28 +638,257 @@ struct FetchFlagsData FetchFlagsTask;
 static int flagsCount, flagsCapacity;
 static struct Flag* flags;
 
-static void FetchFlagsTask_DownloadNext(void);
-static void FetchFlagsTask_Handle(cc_uint8* data, cc_uint32 len) {
-	struct Flag* flag = &flags[FetchFlagsTask.count];
-	LBackend_DecodeFlag(flag, data, len);
-	
-	FetchFlagsTask.count++;
-	FetchFlagsTask_DownloadNext();
+/* Flags are downloaded using several concurrent requests, then decoded on a background thread */
+/*  (downloaded flags are also saved to disk, so they can just be loaded from there next time) */
+#define FLAGS_MAX_ACTIVE 8
+#define FLAGS_CACHE_DIR  "texturecache/flags"
+
+enum FlagState { FLAG_STATE_QUEUED, FLAG_STATE_FETCHING, FLAG_STATE_DECODING, FLAG_STATE_READY };
+enum FlagJobState { FLAG_JOB_FREE, FLAG_JOB_QUEUED, FLAG_JOB_DONE };
+
+struct FlagJob {
+	volatile int state; /* See FLAG_JOB_ enum */
+	int index;          /* Index of the flag in flags list */
+	char country[2];
+	cc_uint8* data;     /* PNG data of the flag, NULL to load it from the disk cache instead */
+	cc_uint32 size;
+	cc_result res;      /* Result of decoding the flag */
+	struct Flag flag;   /* Decoded flag */
+};
+static struct FlagJob flagJobs[FLAGS_MAX_ACTIVE];
+static void* flagsThread;
+static void* flagsMutex;
+static void* flagsWaitable;
+static volatile cc_bool flagsStopping;
+static cc_bool flagsCanCache, flagsCacheChecked;
+
+static void FlagJob_GetCachePath(struct FlagJob* job, cc_string* path) {
+	String_Format2(path, FLAGS_CACHE_DIR "/%r%r.png", &job->country[0], &job->country[1]);
+}
+
+static cc_result FlagJob_ReadCache(struct FlagJob* job) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	struct Stream stream;
+	cc_uint32 size;
+	cc_result res;
+
+	String_InitArray(path, pathBuffer);
+	FlagJob_GetCachePath(job, &path);
+	if ((res = Stream_OpenFile(&stream, &path))) return res;
+
+	if (!(res = stream.Length(&stream, &size))) {
+		job->data = (cc_uint8*)Mem_TryAlloc(size, 1);
+		job->size = size;
+
+		if (!job->data) {
+			res = ERR_OUT_OF_MEMORY;
+		} else if ((res = Stream_Read(&stream, job->data, size))) {
+			Mem_Free(job->data); job->data = NULL;
+		}
+	}
+	/* No point logging error for closing readonly file */
+	(void)stream.Close(&stream);
+	return res;
+}
+
+/* Decodes the flag, first loading it from the disk cache if necessary */
+/* NOTE: data is left as NULL when the flag wasn't cached on disk */
+static void FlagJob_Process(struct FlagJob* job) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+	cc_bool cached = !job->data;
+
+	Bitmap_Init(job->flag.bmp, 0, 0, NULL);
+	job->flag.meta = NULL;
+	job->res       = 0;
+	if (cached && FlagJob_ReadCache(job)) return;
+
+	job->res = LBackend_DecodeFlag(&job->flag, job->data, job->size);
+	if (cached) {
+		/* Corrupted cache file, so just download flag again */
+		if (!job->res) return;
+		/* Bitmap must be cleared, as FetchFlagsTask_StopWorker frees it for completed jobs */
+		Mem_Free(job->flag.bmp.scan0);
+		Bitmap_Init(job->flag.bmp, 0, 0, NULL);
+		Mem_Free(job->data); job->data = NULL;
+	} else if (!job->res && flagsCanCache) {
+		String_InitArray(path, pathBuffer);
+		FlagJob_GetCachePath(job, &path);
+		(void)Stream_WriteAllTo(&path, job->data, job->size);
+	}
+}
+
+static void FetchFlagsTask_RunWorker(void) {
+	struct FlagJob* job;
+	int i;
+
+	while (!flagsStopping)
+	{
+		job = NULL;
+		Mutex_Lock(flagsMutex);
+		{
+			for (i = 0; i < FLAGS_MAX_ACTIVE; i++)
+			{
+				if (flagJobs[i].state == FLAG_JOB_QUEUED) { job = &flagJobs[i]; break; }
+			}
+		}
+		Mutex_Unlock(flagsMutex);
+
+		/* Block until main thread submits more flags to decode */
+		if (!job) { Waitable_Wait(flagsWaitable); continue; }
+		FlagJob_Process(job);
+
+		Mutex_Lock(flagsMutex);
+		job->state = FLAG_JOB_DONE;
+		Mutex_Unlock(flagsMutex);
+	}
+}
+
+static void FetchFlagsTask_StartWorker(void) {
+	flagsStopping = false;
+	flagsMutex    = Mutex_Create("Flags jobs");
+	flagsWaitable = Waitable_Create("Flags wakeup");
+	Thread_Run(&flagsThread, FetchFlagsTask_RunWorker, 128 * 1024, "Flags decoder");
+}
+
+static void FetchFlagsTask_StopWorker(void) {
+	int i;
+	if (!flagsMutex) return;
+
+	flagsStopping = true;
+	Waitable_Signal(flagsWaitable);
+	if (flagsThread) Thread_Join(flagsThread);
+	flagsThread = NULL;
+
+	for (i = 0; i < FLAGS_MAX_ACTIVE; i++)
+	{
+		if (flagJobs[i].state == FLAG_JOB_DONE) Mem_Free(flagJobs[i].flag.bmp.scan0);
+		Mem_Free(flagJobs[i].data);
+
+		flagJobs[i].data  = NULL;
+		flagJobs[i].state = FLAG_JOB_FREE;
+	}
+
+	Mutex_Free(flagsMutex);       flagsMutex    = NULL;
+	Waitable_Free(flagsWaitable); flagsWaitable = NULL;
 }
 
-static void FetchFlagsTask_DownloadNext(void) {
+/* Queues the given flag to be decoded (or to be loaded from disk cache if data is NULL) */
+static void FetchFlagsTask_Decode(int index, cc_uint8* data, cc_uint32 size) {
+	struct FlagJob* job = flagJobs;
+	/* There's always a free job, as at most FLAGS_MAX_ACTIVE flags are being fetched/decoded */
+	while (job->state != FLAG_JOB_FREE) job++;
+
+	job->index = index;
+	job->data  = data;
+	job->size  = size;
+	job->country[0] = flags[index].country[0];
+	job->country[1] = flags[index].country[1];
+	flags[index]._state = FLAG_STATE_DECODING;
+
+	if (!flagsMutex) FetchFlagsTask_StartWorker();
+	/* Platform doesn't support threads, so decode flag now */
+	if (!flagsThread) {
+		FlagJob_Process(job);
+		job->state = FLAG_JOB_DONE;
+		return;
+	}
+
+	Mutex_Lock(flagsMutex);
+	job->state = FLAG_JOB_QUEUED;
+	Mutex_Unlock(flagsMutex);
+	Waitable_Signal(flagsWaitable);
+}
+
+static void FetchFlagsTask_Download(int index) {
 	cc_string url; char urlBuffer[URL_MAX_SIZE];
 	String_InitArray(url, urlBuffer);
 
-	if (FetchFlagsTask.Base.working)        return;
-	if (FetchFlagsTask.count == flagsCount) return;
-
-	LWebTask_Reset(&FetchFlagsTask.Base);
 	String_Format2(&url, RESOURCE_SERVER "/img/flags/%r%r.png",
-			&flags[FetchFlagsTask.count].country[0], &flags[FetchFlagsTask.count].country[1]);
+			&flags[index].country[0], &flags[index].country[1]);
 
-	FetchFlagsTask.Base.Handle = FetchFlagsTask_Handle;
-	FetchFlagsTask.Base.reqID  = Http_AsyncGetData(&url, 0);
+	flags[index]._state = FLAG_STATE_FETCHING;
+	flags[index]._reqID = Http_AsyncGetData(&url, 0);
+}
+
+static void FetchFlagsTask_Finish(int index) {
+	flags[index]._state = FLAG_STATE_READY;
+	FetchFlagsTask.count++;
+}
+
+static void FetchFlagsTask_CompleteJob(struct FlagJob* job) {
+	struct Flag* flag = &flags[job->index];
+
+	if (!job->data) {
+		/* Wasn't in disk cache */
+		FetchFlagsTask_Download(job->index);
+	} else {
+		if (job->res) Logger_SysWarn(job->res, "decoding flag");
+		flag->bmp  = job->flag.bmp;
+		flag->meta = job->flag.meta;
+		FetchFlagsTask_Finish(job->index);
+	}
+
+	Mem_Free(job->data);
+	job->data  = NULL;
+	job->state = FLAG_JOB_FREE;
+}
+
+static void FetchFlagsTask_StartNext(void) {
+	int i, active = 0;
+	if (!flagsCacheChecked) {
+		flagsCacheChecked = true;
+		flagsCanCache     = !Platform_ReadonlyFilesystem &&
+			Utils_EnsureDirectory("texturecache") && Utils_EnsureDirectory(FLAGS_CACHE_DIR);
+	}
+
+	for (i = 0; i < flagsCount; i++)
+	{
+		if (flags[i]._state == FLAG_STATE_FETCHING || flags[i]._state == FLAG_STATE_DECODING) active++;
+	}
+
+	for (i = 0; i < flagsCount && active < FLAGS_MAX_ACTIVE; i++)
+	{
+		if (flags[i]._state != FLAG_STATE_QUEUED) continue;
+		active++;
+
+		if (flagsCanCache) {
+			FetchFlagsTask_Decode(i, NULL, 0);
+		} else {
+			FetchFlagsTask_Download(i);
+		}
+	}
+}
+
+void FetchFlagsTask_Tick(void) {
+	struct HttpRequest item;
+	int i;
+
+	for (i = 0; i < flagsCount; i++)
+	{
+		if (flags[i]._state != FLAG_STATE_FETCHING) continue;
+		if (!Http_GetResult(flags[i]._reqID, &item)) continue;
+
+		if (item.success) {
+			/* Decode job takes ownership of the downloaded data */
+			FetchFlagsTask_Decode(i, item.data, item.size);
+			item.data = NULL;
+		} else {
+			FetchFlagsTask_Finish(i);
+		}
+		HttpRequest_Free(&item);
+	}
+
+	if (flagsMutex) {
+		Mutex_Lock(flagsMutex);
+		{
+			for (i = 0; i < FLAGS_MAX_ACTIVE; i++)
+			{
+				if (flagJobs[i].state == FLAG_JOB_DONE) FetchFlagsTask_CompleteJob(&flagJobs[i]);
+			}
+		}
+		Mutex_Unlock(flagsMutex);
+	}
+	FetchFlagsTask_StartNext();
 }
 
 static void FetchFlagsTask_Ensure(void) {
@@ -676,16 +916,18 @@ void FetchFlagsTask_Add(const struct ServerInfo* server) {
 	Bitmap_Init(flags[flagsCount].bmp, 0, 0, NULL);
 	flags[flagsCount].country[0] = server->country[0];
 	flags[flagsCount].country[1] = server->country[1];
-	flags[flagsCount].meta = NULL;
+	flags[flagsCount].meta   = NULL;
+	flags[flagsCount]._state = FLAG_STATE_QUEUED;
 
 	flagsCount++;
-	FetchFlagsTask_DownloadNext();
+	FetchFlagsTask_StartNext();
 }
 
 struct Flag* Flags_Get(const struct ServerInfo* server) {
 	int i;
-	for (i = 0; i < FetchFlagsTask.count; i++) 
+	for (i = 0; i < flagsCount; i++) 
 	{
+		if (flags[i]._state != FLAG_STATE_READY) continue;
 		if (flags[i].country[0] != server->country[0]) continue;
 		if (flags[i].country[1] != server->country[1]) continue;
 		return &flags[i];
@@ -695,8 +937,11 @@ struct Flag* Flags_Get(const struct ServerInfo* server) {
 
 void Flags_Free(void) {
 	int i;
-	for (i = 0; i < FetchFlagsTask.count; i++) {
-		Mem_Free(flags[i].bmp.scan0);
+	FetchFlagsTask_StopWorker();
+
+	for (i = 0; i < flagsCount; i++) {
+		if (flags[i]._state == FLAG_STATE_FETCHING) Http_TryCancel(flags[i]._reqID);
+		if (flags[i]._state == FLAG_STATE_READY)    Mem_Free(flags[i].bmp.scan0);
 	}
 
     flagsCount = 0;
@@ -50,6 +50,8 @@ struct Flag {
 	struct Bitmap bmp;
 	char country[2]; /* ISO 3166-1 alpha-2 */
 	void* meta; /* Backend specific meta */
+	cc_uint8 _state; /* (internal) download/decode state of this flag */
+	int _reqID;      /* (internal) ID of the request downloading this flag */
 };
 
 struct LWebTask {
@@ -121,13 +123,15 @@ void FetchUpdateTask_Run(cc_bool release, int buildIndex);
 
 
 extern struct FetchFlagsData { 
-	struct LWebTask Base;
-	/* Number of flags downloaded. */
+	/* Number of flags which have finished loading. */
 	int count;
 } FetchFlagsTask;
 
 /* Asynchronously downloads the flag associated with the given server's country. */
+/* NOTE: Flags are also cached on disk, so usually only need to be downloaded once. */
 void FetchFlagsTask_Add(const struct ServerInfo* server);
+/* Processes any finished flag downloads/decodes, then starts loading more flags. */
+void FetchFlagsTask_Tick(void);
 /* Gets the country flag associated with the given server's country. */
 struct Flag* Flags_Get(const struct ServerInfo* server);
 /* Frees all flag bitmaps. */
@@ -20,33 +20,120 @@ struct ChunkPartInfo* MapRenderer_PartsNormal;
 struct ChunkPartInfo* MapRenderer_PartsTranslucent;
 
 static cc_bool inTranslucent;
-static IVec3 chunkPos;
 
 /* The number of non-empty Normal/Translucent ChunkPartInfos (across entire world) for each 1D atlas batch. */
 /* 1D atlas batches that do not have any ChunkPartInfos can be entirely skipped. */
 static int normPartsCount[ATLAS1D_MAX_ATLASES], tranPartsCount[ATLAS1D_MAX_ATLASES];
-/* Whether there are any visible Normal/Translucent ChunkPartInfos for each 1D atlas batch. */
-/* 1D atlas batches that do not have any visible ChunkPartInfos can be skipped. */
-static cc_bool hasNormParts[ATLAS1D_MAX_ATLASES], hasTranParts[ATLAS1D_MAX_ATLASES];
-/* Whether renderer should check if there are any visible Normal/Translucent ChunkPartInfos for each 1D atlas batch. */
-static cc_bool checkNormParts[ATLAS1D_MAX_ATLASES], checkTranParts[ATLAS1D_MAX_ATLASES];
 
 /* Render info for all chunks in the world. Unsorted. */
 static struct ChunkInfo* mapChunks;
-/* Pointers to render info for all chunks in the world, sorted by distance from the camera. */
-static struct ChunkInfo** sortedChunks;
-/* Pointers to render info for all chunks in the world, sorted by distance from the camera. */
-/* Only chunks that can be rendered (i.e. not empty and are visible) are included in this.  */
-static struct ChunkInfo** renderChunks;
-/* Number of actually used pointers in the renderChunks array. Entries past this are ignored and skipped. */
-static int renderChunksCount;
-/* Distance of each chunk from the camera. */
-static cc_uint32* distances;
 /* Maximum number of chunk updates that can be performed in one frame. */
 static int maxChunkUpdates;
 /* Cached number of chunks in the world */
 static int chunksCount;
 
+/* Chunks are grouped into regions of 8x8x8 chunks, so that distance and frustum culling */
+/*  can skip over whole regions at once instead of checking every chunk in the world */
+#define REGION_SHIFT 3
+struct ChunkRegion {
+	/* Bounds of the centre coordinates of the chunks in this region */
+	cc_uint16 minX, minY, minZ, maxX, maxY, maxZ;
+	float centreX, centreY, centreZ, radius;
+	int offset, count; /* Range of this region's chunks in regionChunks */
+	int dirty;         /* Number of chunks pending being rebuilt */
+	int loaded;        /* Number of chunks which currently have mesh data */
+	cc_uint32 minDist, maxDist; /* Distance of nearest/furthest chunk centre from the nearest camera */
+	int column;        /* Index of the column of regions this region is in */
+	cc_bool lod;       /* Whether this region's column should be drawn at low detail */
+};
+static struct ChunkRegion* regions;
+static int regionsX, regionsY, regionsZ, regionsCount;
+/* Pointers to render info for all chunks in the world, grouped by region */
+static struct ChunkInfo** regionChunks;
+
+/* Chunks found to be visible, before being sorted by distance */
+static struct ChunkInfo** visibleChunks;
+/* Chunks pending being built that are wanted by any viewport, shared by all viewports */
+static struct ChunkInfo** pendingChunks;
+static int pendingCount;
+/* Distance ring (i.e. distance from camera in blocks) of each entry in visibleChunks, then pendingChunks */
+/* For pendingChunks, this is the distance from the nearest camera */
+static cc_uint16* chunkRings;
+
+#ifdef CC_BUILD_LODMESHES
+/* Low detail meshes for each column of regions, indexed by (rz * regionsX + rx) */
+static struct LodMesh* lodMeshes;
+static int lodMeshesCount;
+#endif
+
+/* Draw lists contain the ranges of vertices to draw for each 1D atlas batch, */
+/*  so that rendering doesn't have to check every visible chunk for every batch each frame */
+/* Draw lists are only recompiled when visible chunks or chunk meshes change */
+struct DrawRange {
+	GfxResourceID vb;
+	int offset, count;
+	cc_bool cull; /* Whether face culling should be enabled */
+};
+
+struct DrawList {
+	struct DrawRange* ranges;
+	int count, capacity;
+	int first;   /* Index of first range in the batch currently being compiled */
+	cc_bool dirty;
+	cc_bool inTranslucent; /* Value of inTranslucent when list was compiled */
+	int offsets[ATLAS1D_MAX_ATLASES + 1]; /* Index of first range for each batch */
+};
+
+/* Visibility and sort state of a viewport (i.e. each local player in splitscreen), */
+/*  as each viewport has its own camera while chunk meshes are shared by all viewports */
+struct MapView {
+	IVec3 chunkPos; /* Centre coordinates of the chunk the camera is in */
+	Vec3 lastCamPos;
+	float lastYaw, lastPitch;
+	/* Whether any chunk has been built, deleted or marked as needing rebuilding since visibility was last updated */
+	cc_bool chunksChanged;
+	/* Pointers to render info for all chunks in the world, sorted by distance from the camera. */
+	/* Only chunks that can be rendered (i.e. not empty and are visible) are included in this.  */
+	struct ChunkInfo** renderChunks;
+	/* Number of actually used pointers in the renderChunks array. Entries past this are ignored and skipped. */
+	int renderChunksCount;
+	/* Indices of all regions, sorted by distance from the camera to nearest chunk centre */
+	int* sortedRegions;
+	/* Distance of each region in sortedRegions. */
+	cc_uint32* regionDists;
+#ifdef CC_BUILD_LODMESHES
+	/* Indices of low detail meshes that are currently visible */
+	int* lodVisible;
+	int lodVisibleCount;
+#endif
+	struct DrawList normList, tranList;
+};
+static struct MapView views[MAX_LOCAL_PLAYERS];
+static struct MapView* curView = &views[0];
+
+static void InvalidateDrawLists(void) {
+	int i;
+	for (i = 0; i < Game_NumStates; i++) {
+		views[i].normList.dirty = true;
+		views[i].tranList.dirty = true;
+	}
+}
+
+/* Marks that every viewport needs to recalculate which chunks are visible */
+static void MarkChunksChanged(void) {
+	int i;
+	for (i = 0; i < Game_NumStates; i++) {
+		views[i].chunksChanged = true;
+	}
+}
+
+static CC_INLINE struct ChunkRegion* ChunkInfo_Region(struct ChunkInfo* chunk) {
+	int rx = chunk->centreX >> (CHUNK_SHIFT + REGION_SHIFT);
+	int ry = chunk->centreY >> (CHUNK_SHIFT + REGION_SHIFT);
+	int rz = chunk->centreZ >> (CHUNK_SHIFT + REGION_SHIFT);
+	return &regions[(rz * regionsY + ry) * regionsX + rx];
+}
+
 static void ChunkInfo_Init(struct ChunkInfo* chunk, int x, int y, int z) {
 	chunk->centreX = x + HALF_CHUNK_SIZE; chunk->centreY = y + HALF_CHUNK_SIZE; 
 	chunk->centreZ = z + HALF_CHUNK_SIZE;
@@ -59,6 +146,7 @@ static void ChunkInfo_Init(struct ChunkInfo* chunk, int x, int y, int z) {
 	chunk->allAir  = false;
 	chunk->noData  = true;
 	chunk->dirty   = true;
+	chunk->queued  = false;
 
 	chunk->drawXMin = false; chunk->drawXMax = false; chunk->drawZMin = false;
 	chunk->drawZMax = false; chunk->drawYMin = false; chunk->drawYMax = false;
@@ -69,9 +157,11 @@ static void ChunkInfo_Init(struct ChunkInfo* chunk, int x, int y, int z) {
 
 static CC_INLINE void ChunkInfo_Refresh(struct ChunkInfo* chunk) {
 	if (chunk->allAir) return; /* do not recreate chunks completely air */
+	if (!chunk->dirty) ChunkInfo_Region(chunk)->dirty++;
 
-	chunk->empty = false;
-	chunk->dirty = true;
+	chunk->empty  = false;
+	chunk->dirty  = true;
+	MarkChunksChanged();
 }
 
 /* Index of maximum used 1D atlas + 1 */
@@ -106,97 +196,253 @@ static void CheckWeather(float delta) {
 	Gfx_SetAlphaBlending(false);
 }
 
+
+static void DrawList_Free(struct DrawList* list) {
+	Mem_Free(list->ranges);
+	list->ranges   = NULL;
+	list->count    = 0;
+	list->capacity = 0;
+}
+
+static void DrawList_Add(struct DrawList* list, GfxResourceID vb, int offset, int count, cc_bool cull) {
+	struct DrawRange* last;
+	if (!count) return;
+
+	/* Merge with previous range if contiguous, which avoids a draw call */
+#if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
+	if (list->count > list->first) {
+		last = &list->ranges[list->count - 1];
+		if (last->vb == vb && last->cull == cull && last->offset + last->count == offset) {
+			last->count += count; return;
+		}
+	}
+#endif
+
+	if (list->count == list->capacity) {
+		Utils_Resize((void**)&list->ranges, &list->capacity,
+					sizeof(struct DrawRange), 0, 512);
+	}
+	last = &list->ranges[list->count++];
+
+	last->vb     = vb;
+	last->offset = offset;
+	last->count  = count;
+	last->cull   = cull;
+}
+
 #if CC_GFX_BACKEND == CC_GFX_BACKEND_GL11
-	#define DrawFace(face, ign)    Gfx_BindVb(part.vbs[face]); Gfx_DrawIndexedTris_T2fC4b(0, 0);
-	#define DrawFaces(f1, f2, ign) DrawFace(f1, ign); DrawFace(f2, ign);
+	#define AddFace(list, face, ign, cull) DrawList_Add(list, part->vbs[face], 0, part->counts[face], cull);
+	#define AddFaces(list, f1, f2, offset) AddFace(list, f1, offset, true); AddFace(list, f2, offset, true);
 #else
-	#define DrawFace(face, offset)    Gfx_DrawIndexedTris_T2fC4b(part.counts[face], offset);
-	#define DrawFaces(f1, f2, offset) Gfx_DrawIndexedTris_T2fC4b(part.counts[f1] + part.counts[f2], offset);
+	#define AddFace(list, face, offset, cull) DrawList_Add(list, info->vb, offset, part->counts[face], cull);
+	#define AddFaces(list, f1, f2, offset)    DrawList_Add(list, info->vb, offset, part->counts[f1] + part->counts[f2], true);
 #endif
 
-#define DrawNormalFaces(minFace, maxFace) \
+/* When both sides of a chunk are visible, face culling is used to skip the faces pointing away */
+#define AddNormalFaces(minFace, maxFace) \
 if (drawMin && drawMax) { \
-	Gfx_SetFaceCulling(true); \
-	DrawFaces(minFace, maxFace, offset); \
-	Gfx_SetFaceCulling(false); \
-	Game_Vertices += (part.counts[minFace] + part.counts[maxFace]); \
+	AddFaces(&curView->normList, minFace, maxFace, offset); \
 } else if (drawMin) { \
-	DrawFace(minFace, offset); \
-	Game_Vertices += part.counts[minFace]; \
+	AddFace(&curView->normList, minFace, offset, false); \
 } else if (drawMax) { \
-	DrawFace(maxFace, offset + part.counts[minFace]); \
-	Game_Vertices += part.counts[maxFace]; \
+	AddFace(&curView->normList, maxFace, offset + part->counts[minFace], false); \
 }
 
-static void RenderNormalBatch(int batch) {
-	int batchOffset = chunksCount * batch;
-	struct ChunkInfo* info;
-	struct ChunkPartInfo part;
+static void CompileNormalChunk(struct ChunkInfo* info, struct ChunkPartInfo* part) {
 	cc_bool drawMin, drawMax;
-	int i, offset, count;
+	int offset, count;
 
-	for (i = 0; i < renderChunksCount; i++) {
-		info = renderChunks[i];
-		if (!info->normalParts) continue;
+	/* Sprites are at start of the chunk's vertices */
+	if (part->spriteCount) {
+		offset = part->offset;
+		count  = part->spriteCount >> 2; /* 4 per sprite */
+#if CC_GFX_BACKEND == CC_GFX_BACKEND_GL11
+		/* TODO: fix to not render them all */
+		DrawList_Add(&curView->normList, part->vbs[FACE_COUNT], 0, count * 4, true);
+#else
+		if (info->drawXMax || info->drawZMin) DrawList_Add(&curView->normList, info->vb, offset, count, true);
+		offset += count;
+		if (info->drawXMin || info->drawZMax) DrawList_Add(&curView->normList, info->vb, offset, count, true);
+		offset += count;
+		if (info->drawXMin || info->drawZMin) DrawList_Add(&curView->normList, info->vb, offset, count, true);
+		offset += count;
+		if (info->drawXMax || info->drawZMax) DrawList_Add(&curView->normList, info->vb, offset, count, true);
+#endif
+	}
 
-		part = info->normalParts[batchOffset];
-		if (part.offset < 0) continue;
-		hasNormParts[batch] = true;
+	offset  = part->offset + part->spriteCount;
+	drawMin = info->drawXMin && part->counts[FACE_XMIN];
+	drawMax = info->drawXMax && part->counts[FACE_XMAX];
+	AddNormalFaces(FACE_XMIN, FACE_XMAX);
 
-#if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
-		Gfx_BindVb_Textured(info->vb);
+	offset  += part->counts[FACE_XMIN] + part->counts[FACE_XMAX];
+	drawMin = info->drawZMin && part->counts[FACE_ZMIN];
+	drawMax = info->drawZMax && part->counts[FACE_ZMAX];
+	AddNormalFaces(FACE_ZMIN, FACE_ZMAX);
+
+	offset  += part->counts[FACE_ZMIN] + part->counts[FACE_ZMAX];
+	drawMin = info->drawYMin && part->counts[FACE_YMIN];
+	drawMax = info->drawYMax && part->counts[FACE_YMAX];
+	AddNormalFaces(FACE_YMIN, FACE_YMAX);
+}
+
+#define AddTranslucentFaces(minFace, maxFace) \
+if (drawMin && drawMax) { \
+	AddFace(&curView->tranList, minFace, offset, false); \
+	AddFace(&curView->tranList, maxFace, offset + part->counts[minFace], false); \
+} else if (drawMin) { \
+	AddFace(&curView->tranList, minFace, offset, false); \
+} else if (drawMax) { \
+	AddFace(&curView->tranList, maxFace, offset + part->counts[minFace], false); \
+}
+
+static void CompileTranslucentChunk(struct ChunkInfo* info, struct ChunkPartInfo* part) {
+	cc_bool drawMin, drawMax;
+	int offset;
+
+	offset  = part->offset;
+	drawMin = (inTranslucent || info->drawXMin) && part->counts[FACE_XMIN];
+	drawMax = (inTranslucent || info->drawXMax) && part->counts[FACE_XMAX];
+	AddTranslucentFaces(FACE_XMIN, FACE_XMAX);
+
+	offset  += part->counts[FACE_XMIN] + part->counts[FACE_XMAX];
+	drawMin = (inTranslucent || info->drawZMin) && part->counts[FACE_ZMIN];
+	drawMax = (inTranslucent || info->drawZMax) && part->counts[FACE_ZMAX];
+	AddTranslucentFaces(FACE_ZMIN, FACE_ZMAX);
+
+	offset  += part->counts[FACE_ZMIN] + part->counts[FACE_ZMAX];
+	drawMin = (inTranslucent || info->drawYMin) && part->counts[FACE_YMIN];
+	drawMax = (inTranslucent || info->drawYMax) && part->counts[FACE_YMAX];
+	AddTranslucentFaces(FACE_YMIN, FACE_YMAX);
+}
+
+/* Determines which faces of the visible chunks can be seen from this viewport's camera */
+/* NOTE: Done here instead of when determining visibility, as chunks are shared by all viewports */
+static void CalcDrawFaces(void) {
+	struct ChunkInfo* info;
+	int i, dx, dy, dz;
+
+	for (i = 0; i < curView->renderChunksCount; i++) 
+	{
+		info = curView->renderChunks[i];
+		dx = info->centreX - curView->chunkPos.x; 
+		dy = info->centreY - curView->chunkPos.y; 
+		dz = info->centreZ - curView->chunkPos.z;
+
+		/* Consider these 3 chunks: */
+		/* |       X-1      |        X        |       X+1      | */
+		/* |################|########@########|################| */
+		/* Assume the player is standing at @, then DrawXMin/XMax is calculated as this */
+		/*    X-1: DrawXMin = false, DrawXMax = true  */
+		/*    X  : DrawXMin = true,  DrawXMax = true  */
+		/*    X+1: DrawXMin = true,  DrawXMax = false */
+		info->drawXMin = dx >= 0; info->drawXMax = dx <= 0;
+		info->drawZMin = dz >= 0; info->drawZMax = dz <= 0;
+		info->drawYMin = dy >= 0; info->drawYMax = dy <= 0;
+	}
+}
+
+static void CompileNormalList(void) {
+	struct ChunkInfo* info;
+	struct ChunkPartInfo* part;
+	int batch, i;
+#ifdef CC_BUILD_LODMESHES
+	struct LodMesh* mesh;
 #endif
 
-		offset  = part.offset + part.spriteCount;
-		drawMin = info->drawXMin && part.counts[FACE_XMIN];
-		drawMax = info->drawXMax && part.counts[FACE_XMAX];
-		DrawNormalFaces(FACE_XMIN, FACE_XMAX);
+	CalcDrawFaces();
+	curView->normList.count = 0;
+	curView->normList.dirty = false;
 
-		offset  += part.counts[FACE_XMIN] + part.counts[FACE_XMAX];
-		drawMin = info->drawZMin && part.counts[FACE_ZMIN];
-		drawMax = info->drawZMax && part.counts[FACE_ZMAX];
-		DrawNormalFaces(FACE_ZMIN, FACE_ZMAX);
+	for (batch = 0; batch < MapRenderer_1DUsedCount; batch++)
+	{
+		curView->normList.offsets[batch] = curView->normList.count;
+		curView->normList.first          = curView->normList.count;
 
-		offset  += part.counts[FACE_ZMIN] + part.counts[FACE_ZMAX];
-		drawMin = info->drawYMin && part.counts[FACE_YMIN];
-		drawMax = info->drawYMax && part.counts[FACE_YMAX];
-		DrawNormalFaces(FACE_YMIN, FACE_YMAX);
+		for (i = 0; i < curView->renderChunksCount && normPartsCount[batch] > 0; i++) 
+		{
+			info = curView->renderChunks[i];
+			if (!info->normalParts) continue;
 
-		if (!part.spriteCount) continue;
-		offset = part.offset;
-		count  = part.spriteCount >> 2; /* 4 per sprite */
+			part = &info->normalParts[chunksCount * batch];
+			if (part->offset >= 0) CompileNormalChunk(info, part);
+		}
 
-		Gfx_SetFaceCulling(true);
-		/* TODO: fix to not render them all */
-#if CC_GFX_BACKEND == CC_GFX_BACKEND_GL11
-		Gfx_BindVb(part.vbs[FACE_COUNT]);
-		Gfx_DrawIndexedTris_T2fC4b(0, 0);
-		Game_Vertices += count * 4;
-		Gfx_SetFaceCulling(false);
-		continue;
+#ifdef CC_BUILD_LODMESHES
+		/* Low detail meshes are further away than all chunks, so are drawn last */
+		for (i = 0; i < curView->lodVisibleCount; i++)
+		{
+			mesh = &lodMeshes[curView->lodVisible[i]];
+			if (batch >= mesh->batches) continue;
+
+			DrawList_Add(&curView->normList, mesh->vb, mesh->offsets[batch], 
+						mesh->offsets[batch + 1] - mesh->offsets[batch], true);
+		}
 #endif
-		if (info->drawXMax || info->drawZMin) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
-		} offset += count;
+	}
+	curView->normList.offsets[batch] = curView->normList.count;
+}
+
+static void CompileTranslucentList(void) {
+	struct ChunkInfo* info;
+	struct ChunkPartInfo* part;
+	int batch, i;
+
+	CalcDrawFaces();
+	curView->tranList.count = 0;
+	curView->tranList.dirty = false;
+	curView->tranList.inTranslucent = inTranslucent;
+
+	for (batch = 0; batch < MapRenderer_1DUsedCount; batch++)
+	{
+		curView->tranList.offsets[batch] = curView->tranList.count;
+		curView->tranList.first          = curView->tranList.count;
+		if (tranPartsCount[batch] <= 0) continue;
 
-		if (info->drawXMin || info->drawZMax) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
-		} offset += count;
+		for (i = 0; i < curView->renderChunksCount; i++) 
+		{
+			info = curView->renderChunks[i];
+			if (!info->translucentParts) continue;
 
-		if (info->drawXMin || info->drawZMin) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
-		} offset += count;
+			part = &info->translucentParts[chunksCount * batch];
+			if (part->offset >= 0) CompileTranslucentChunk(info, part);
+		}
+	}
+	curView->tranList.offsets[batch] = curView->tranList.count;
+}
 
-		if (info->drawXMax || info->drawZMax) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
+static void RenderBatch(struct DrawList* list, int batch) {
+	struct DrawRange* range = &list->ranges[list->offsets[batch]];
+	struct DrawRange* end   = &list->ranges[list->offsets[batch + 1]];
+	GfxResourceID vb = 0;
+	cc_bool cull     = false;
+
+	for (; range < end; range++)
+	{
+		if (range->cull != cull) {
+			cull = range->cull; Gfx_SetFaceCulling(cull);
 		}
-		Gfx_SetFaceCulling(false);
+#if CC_GFX_BACKEND == CC_GFX_BACKEND_GL11
+		Gfx_BindVb(range->vb);
+		Gfx_DrawIndexedTris_T2fC4b(0, 0);
+#else
+		if (range->vb != vb) {
+			vb = range->vb; Gfx_BindVb_Textured(vb);
+		}
+		Gfx_DrawIndexedTris_T2fC4b(range->count, range->offset);
+#endif
+		Game_Vertices += range->count;
 	}
+	if (cull) Gfx_SetFaceCulling(false);
 }
 
+#define DrawList_HasBatch(list, batch) ((list)->offsets[(batch) + 1] > (list)->offsets[batch])
+
 void MapRenderer_RenderNormal(float delta) {
 	int batch;
 	if (!mapChunks) return;
+	curView = &views[Game.CurrentState];
+	if (curView->normList.dirty) CompileNormalList();
 
 	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
 	Gfx_SetAlphaTest(true);
@@ -204,12 +450,9 @@ void MapRenderer_RenderNormal(float delta) {
 	Gfx_EnableMipmaps();
 	for (batch = 0; batch < MapRenderer_1DUsedCount; batch++) 
 	{
-		if (normPartsCount[batch] <= 0) continue;
-		if (hasNormParts[batch] || checkNormParts[batch]) {
-			Atlas1D_Bind(batch);
-			RenderNormalBatch(batch);
-			checkNormParts[batch] = false;
-		}
+		if (!DrawList_HasBatch(&curView->normList, batch)) continue;
+		Atlas1D_Bind(batch);
+		RenderBatch(&curView->normList, batch);
 	}
 	Gfx_DisableMipmaps();
 
@@ -220,57 +463,11 @@ void MapRenderer_RenderNormal(float delta) {
 #endif
 }
 
-#define DrawTranslucentFaces(minFace, maxFace) \
-if (drawMin && drawMax) { \
-	DrawFaces(minFace, maxFace, offset); \
-	Game_Vertices += (part.counts[minFace] + part.counts[maxFace]); \
-} else if (drawMin) { \
-	DrawFace(minFace, offset); \
-	Game_Vertices += part.counts[minFace]; \
-} else if (drawMax) { \
-	DrawFace(maxFace, offset + part.counts[minFace]); \
-	Game_Vertices += part.counts[maxFace]; \
-}
-
-static void RenderTranslucentBatch(int batch) {
-	int batchOffset = chunksCount * batch;
-	struct ChunkInfo* info;
-	struct ChunkPartInfo part;
-	cc_bool drawMin, drawMax;
-	int i, offset;
-
-	for (i = 0; i < renderChunksCount; i++) {
-		info = renderChunks[i];
-		if (!info->translucentParts) continue;
-
-		part = info->translucentParts[batchOffset];
-		if (part.offset < 0) continue;
-		hasTranParts[batch] = true;
-
-#if CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
-		Gfx_BindVb_Textured(info->vb);
-#endif
-
-		offset  = part.offset;
-		drawMin = (inTranslucent || info->drawXMin) && part.counts[FACE_XMIN];
-		drawMax = (inTranslucent || info->drawXMax) && part.counts[FACE_XMAX];
-		DrawTranslucentFaces(FACE_XMIN, FACE_XMAX);
-
-		offset  += part.counts[FACE_XMIN] + part.counts[FACE_XMAX];
-		drawMin = (inTranslucent || info->drawZMin) && part.counts[FACE_ZMIN];
-		drawMax = (inTranslucent || info->drawZMax) && part.counts[FACE_ZMAX];
-		DrawTranslucentFaces(FACE_ZMIN, FACE_ZMAX);
-
-		offset  += part.counts[FACE_ZMIN] + part.counts[FACE_ZMAX];
-		drawMin = (inTranslucent || info->drawYMin) && part.counts[FACE_YMIN];
-		drawMax = (inTranslucent || info->drawYMax) && part.counts[FACE_YMAX];
-		DrawTranslucentFaces(FACE_YMIN, FACE_YMAX);
-	}
-}
-
 void MapRenderer_RenderTranslucent(float delta) {
 	int vertices, batch;
 	if (!mapChunks) return;
+	curView = &views[Game.CurrentState];
+	if (curView->tranList.dirty || curView->tranList.inTranslucent != inTranslucent) CompileTranslucentList();
 
 	/* First fill depth buffer */
 	vertices = Game_Vertices;
@@ -280,11 +477,8 @@ void MapRenderer_RenderTranslucent(float delta) {
 
 	for (batch = 0; batch < MapRenderer_1DUsedCount; batch++) 
 	{
-		if (tranPartsCount[batch] <= 0) continue;
-		if (hasTranParts[batch] || checkTranParts[batch]) {
-			RenderTranslucentBatch(batch);
-			checkTranParts[batch] = false;
-		}
+		if (!DrawList_HasBatch(&curView->tranList, batch)) continue;
+		RenderBatch(&curView->tranList, batch);
 	}
 	Game_Vertices = vertices;
 
@@ -296,11 +490,9 @@ void MapRenderer_RenderTranslucent(float delta) {
 	Gfx_EnableMipmaps();
 	for (batch = 0; batch < MapRenderer_1DUsedCount; batch++) 
 	{
-		if (tranPartsCount[batch] <= 0) continue;
-		if (!hasTranParts[batch]) continue;
-
+		if (!DrawList_HasBatch(&curView->tranList, batch)) continue;
 		Atlas1D_Bind(batch);
-		RenderTranslucentBatch(batch);
+		RenderBatch(&curView->tranList, batch);
 	}
 	Gfx_DisableMipmaps();
 
@@ -320,6 +512,7 @@ void MapRenderer_RenderTranslucent(float delta) {
 *#########################################################################################################################*/
 /* Deletes vertex buffer associated with the given chunk and updates internal state */
 static void DeleteChunk(struct ChunkInfo* info) {
+	struct ChunkRegion* region = ChunkInfo_Region(info);
 	struct ChunkPartInfo* ptr;
 	int i;
 #if CC_GFX_BACKEND == CC_GFX_BACKEND_GL11
@@ -328,6 +521,11 @@ static void DeleteChunk(struct ChunkInfo* info) {
 	Gfx_DeleteVb(&info->vb);
 #endif
 
+	if (!info->dirty)  region->dirty++;
+	if (!info->noData) region->loaded--;
+	MarkChunksChanged();
+	InvalidateDrawLists();
+
 	info->empty  = false; 
 	info->allAir = false;
 	info->noData = true;
@@ -365,6 +563,7 @@ static void DeleteChunk(struct ChunkInfo* info) {
 
 /* Builds the mesh (hence vertex buffer) for the given chunk, and updates internal state */
 static void BuildChunk(struct ChunkInfo* info, int* chunkUpdates) {
+	struct ChunkRegion* region = ChunkInfo_Region(info);
 	struct ChunkPartInfo* ptr;
 	int i;
 
@@ -372,10 +571,16 @@ static void BuildChunk(struct ChunkInfo* info, int* chunkUpdates) {
 	(*chunkUpdates)++;
 	Builder_MakeChunk(info);
 
+	if (info->dirty) region->dirty--;
+	MarkChunksChanged();
+	InvalidateDrawLists();
+
 	info->dirty  = false;
 	info->noData = !info->normalParts && !info->translucentParts;
 	info->empty  = info->noData;
 	if (info->empty) return;
+
+	region->loaded++;
 	
 	if (info->normalParts) {
 		ptr = info->normalParts;
@@ -393,6 +598,123 @@ static void BuildChunk(struct ChunkInfo* info, int* chunkUpdates) {
 }
 
 
+/*########################################################################################################################*
+*---------------------------------------------------Low detail meshes-----------------------------------------------------*
+*#########################################################################################################################*/
+#ifdef CC_BUILD_LODMESHES
+/* Distance from camera beyond which columns of regions are drawn using 2x/4x low detail meshes */
+/* 0 if low detail meshes are disabled */
+static cc_uint32 lodDistSquared, lodFarDistSquared;
+/* Max memory that can be used by low detail meshes, and how much is currently used */
+static cc_uint32 lodMemLimit, lodMemUsed;
+/* Distance at which low detail meshes were last evicted due to exceeding the memory budget */
+/* Meshes at or beyond this distance aren't built, to avoid repeatedly building and evicting them */
+#define LOD_NO_BUDGET_DIST ((cc_uint32)-1)
+static cc_uint32 lodBudgetDist = LOD_NO_BUDGET_DIST;
+/* Minimum seconds between rebuilds of a low detail mesh due to block changes */
+/* e.g. so water/lava constantly flowing far away doesn't rebuild a whole region every frame */
+#define LOD_DIRTY_DELAY 5.0f
+/* Time at which the earliest pending rebuild of a dirty low detail mesh is due */
+/* NOTE: Meshes are only rebuilt after a visibility update, so one is forced at this time */
+#define LOD_NONE_DUE 1e30f
+static float lodDirtyDue = LOD_NONE_DUE;
+
+static cc_uint32 LodMesh_Memory(struct LodMesh* mesh) {
+	if (!mesh->scale) return 0;
+	return mesh->offsets[mesh->batches] * sizeof(struct VertexTextured) + (mesh->batches + 1) * sizeof(int);
+}
+
+static void LodMesh_Free(struct LodMesh* mesh) {
+	lodMemUsed -= LodMesh_Memory(mesh);
+	Gfx_DeleteVb(&mesh->vb);
+	Mem_Free(mesh->offsets);
+
+	mesh->offsets = NULL;
+	mesh->batches = 0;
+	mesh->scale   = 0;
+	mesh->dirty   = false;
+	MarkChunksChanged();
+	InvalidateDrawLists();
+}
+
+static void FreeLodMeshes(void) {
+	int i;
+	for (i = 0; i < lodMeshesCount; i++) 
+	{
+		LodMesh_Free(&lodMeshes[i]);
+	}
+
+	for (i = 0; i < MAX_LOCAL_PLAYERS; i++) views[i].lodVisibleCount = 0;
+	lodBudgetDist = LOD_NO_BUDGET_DIST;
+}
+
+static void MarkLodMeshesDirty(void) {
+	int i;
+	for (i = 0; i < lodMeshesCount; i++) 
+	{
+		/* Rebuild these straight away */
+		lodMeshes[i].dirty     = true;
+		lodMeshes[i].dirtyTime = -LOD_DIRTY_DELAY;
+	}
+}
+
+static void MarkLodMeshDirty(int x, int z) {
+	int rx = x >> (CHUNK_SHIFT + REGION_SHIFT);
+	int rz = z >> (CHUNK_SHIFT + REGION_SHIFT);
+	struct LodMesh* mesh = &lodMeshes[rz * regionsX + rx];
+
+	if (mesh->dirty) return;
+	mesh->dirty     = true;
+	mesh->dirtyTime = (float)Game.Time;
+	lodDirtyDue     = min(lodDirtyDue, mesh->dirtyTime + LOD_DIRTY_DELAY);
+}
+
+/* Forces a visibility update once dirty meshes are due to be rebuilt */
+/* e.g. so far away block changes still appear when the camera isn't moving */
+static void CheckLodMeshesDue(void) {
+	struct LodMesh* mesh;
+	float due;
+	int i;
+	if (Game.Time < lodDirtyDue) return;
+
+	MarkChunksChanged();
+	lodDirtyDue = LOD_NONE_DUE;
+
+	/* Meshes already due are rebuilt by the visibility update */
+	for (i = 0; i < lodMeshesCount; i++) 
+	{
+		mesh = &lodMeshes[i];
+		if (!mesh->dirty) continue;
+
+		due = mesh->dirtyTime + LOD_DIRTY_DELAY;
+		if (due > Game.Time) lodDirtyDue = min(lodDirtyDue, due);
+	}
+}
+
+static void InitLodMeshes(void) {
+	struct LodMesh* mesh;
+	float dx, dy, dz;
+	int i, rx, rz, x1, z1, x2, z2;
+
+	for (rz = 0; rz < regionsZ; rz++) {
+		for (rx = 0; rx < regionsX; rx++) {
+			mesh = &lodMeshes[rz * regionsX + rx];
+			x1 = rx * LODMESH_MAX_SIZE; x2 = min(x1 + LODMESH_MAX_SIZE, World.Width);
+			z1 = rz * LODMESH_MAX_SIZE; z2 = min(z1 + LODMESH_MAX_SIZE, World.Length);
+
+			dx = (x2 - x1) * 0.5f; mesh->centreX = x1 + dx;
+			dy = World.Height * 0.5f; mesh->centreY = dy;
+			dz = (z2 - z1) * 0.5f; mesh->centreZ = z1 + dz;
+			mesh->radius = Math_SqrtF(dx * dx + dy * dy + dz * dz);
+		}
+	}
+	for (i = 0; i < MAX_LOCAL_PLAYERS; i++) views[i].lodVisibleCount = 0;
+	lodBudgetDist = LOD_NO_BUDGET_DIST;
+	lodDirtyDue   = LOD_NONE_DUE;
+}
+#endif
+
+
 /*########################################################################################################################*
 *----------------------------------------------------Chunks mangagement---------------------------------------------------*
 *#########################################################################################################################*/
@@ -402,16 +724,51 @@ static void FreeParts(void) {
 	MapRenderer_PartsTranslucent = NULL;
 }
 
+static void FreeView(struct MapView* view) {
+	Mem_Free(view->renderChunks);
+	Mem_Free(view->sortedRegions);
+	Mem_Free(view->regionDists);
+#ifdef CC_BUILD_LODMESHES
+	Mem_Free(view->lodVisible);
+	view->lodVisible      = NULL;
+	view->lodVisibleCount = 0;
+#endif
+
+	DrawList_Free(&view->normList);
+	DrawList_Free(&view->tranList);
+	view->renderChunks  = NULL;
+	view->sortedRegions = NULL;
+	view->regionDists   = NULL;
+}
+
 static void FreeChunks(void) {
+	int i;
 	Mem_Free(mapChunks);
-	Mem_Free(sortedChunks);
-	Mem_Free(renderChunks);
-	Mem_Free(distances);
+	Mem_Free(visibleChunks);
+	Mem_Free(pendingChunks);
+	Mem_Free(chunkRings);
+	Mem_Free(regions);
+	Mem_Free(regionChunks);
+#ifdef CC_BUILD_LODMESHES
+	FreeLodMeshes();
+	Mem_Free(lodMeshes);
+	lodMeshes      = NULL;
+	lodMeshesCount = 0;
+#endif
 
-	mapChunks    = NULL;
-	sortedChunks = NULL;
-	renderChunks = NULL;
-	distances    = NULL;
+	for (i = 0; i < MAX_LOCAL_PLAYERS; i++) 
+	{
+		FreeView(&views[i]);
+	}
+	InvalidateDrawLists();
+
+	mapChunks     = NULL;
+	visibleChunks = NULL;
+	pendingChunks = NULL;
+	pendingCount  = 0;
+	chunkRings    = NULL;
+	regions       = NULL;
+	regionChunks  = NULL;
 }
 
 static void AllocateParts(void) {
@@ -423,20 +780,38 @@ static void AllocateParts(void) {
 	MapRenderer_PartsTranslucent = ptr + count;
 }
 
-static void AllocateChunks(void) {
-	mapChunks    = (struct ChunkInfo*) Mem_Alloc(chunksCount, sizeof(struct ChunkInfo),  "chunk info");
-	sortedChunks = (struct ChunkInfo**)Mem_Alloc(chunksCount, sizeof(struct ChunkInfo*), "sorted chunk info");
-	renderChunks = (struct ChunkInfo**)Mem_Alloc(chunksCount, sizeof(struct ChunkInfo*), "render chunk info");
-	distances    = (cc_uint32*)Mem_Alloc(chunksCount, 4, "chunk distances");
+static void AllocateView(struct MapView* view) {
+	view->renderChunks  = (struct ChunkInfo**)Mem_Alloc(chunksCount, sizeof(struct ChunkInfo*), "render chunk info");
+	view->sortedRegions = (int*)Mem_Alloc(regionsCount, 4, "sorted regions");
+	view->regionDists   = (cc_uint32*)Mem_Alloc(regionsCount, 4, "region distances");
+#ifdef CC_BUILD_LODMESHES
+	view->lodVisible    = (int*)Mem_Alloc(lodMeshesCount, 4, "visible LOD meshes");
+#endif
 }
 
-static void ResetPartFlags(void) {
+static void AllocateChunks(void) {
 	int i;
-	for (i = 0; i < ATLAS1D_MAX_ATLASES; i++) {
-		checkNormParts[i] = true;
-		hasNormParts[i]   = false;
-		checkTranParts[i] = true;
-		hasTranParts[i]   = false;
+	regionsX = (World.ChunksX + (1 << REGION_SHIFT) - 1) >> REGION_SHIFT;
+	regionsY = (World.ChunksY + (1 << REGION_SHIFT) - 1) >> REGION_SHIFT;
+	regionsZ = (World.ChunksZ + (1 << REGION_SHIFT) - 1) >> REGION_SHIFT;
+	regionsCount = regionsX * regionsY * regionsZ;
+
+	mapChunks     = (struct ChunkInfo*) Mem_Alloc(chunksCount, sizeof(struct ChunkInfo),  "chunk info");
+	visibleChunks = (struct ChunkInfo**)Mem_Alloc(chunksCount, sizeof(struct ChunkInfo*), "visible chunk info");
+	pendingChunks = (struct ChunkInfo**)Mem_Alloc(chunksCount, sizeof(struct ChunkInfo*), "pending chunk info");
+	chunkRings    = (cc_uint16*)Mem_Alloc(chunksCount * 2, 2, "chunk rings");
+
+	regions       = (struct ChunkRegion*)Mem_Alloc(regionsCount, sizeof(struct ChunkRegion), "chunk regions");
+	regionChunks  = (struct ChunkInfo**)Mem_Alloc(chunksCount, sizeof(struct ChunkInfo*), "region chunk info");
+
+#ifdef CC_BUILD_LODMESHES
+	lodMeshesCount = regionsX * regionsZ;
+	lodMeshes  = (struct LodMesh*)Mem_AllocCleared(lodMeshesCount, sizeof(struct LodMesh), "LOD meshes");
+#endif
+
+	for (i = 0; i < Game_NumStates; i++) 
+	{
+		AllocateView(&views[i]);
 	}
 }
 
@@ -448,19 +823,73 @@ static void ResetPartCounts(void) {
 	}
 }
 
+static void InitRegion(struct ChunkRegion* r, int rx, int ry, int rz, int* offset) {
+	int beg, cx, cy, cz, x1, y1, z1, x2, y2, z2;
+	float dx, dy, dz;
+	beg = *offset;
+
+	x1 = rx << REGION_SHIFT; x2 = min(x1 + (1 << REGION_SHIFT), World.ChunksX);
+	y1 = ry << REGION_SHIFT; y2 = min(y1 + (1 << REGION_SHIFT), World.ChunksY);
+	z1 = rz << REGION_SHIFT; z2 = min(z1 + (1 << REGION_SHIFT), World.ChunksZ);
+
+	for (cz = z1; cz < z2; cz++) {
+		for (cy = y1; cy < y2; cy++) {
+			for (cx = x1; cx < x2; cx++) {
+				regionChunks[(*offset)++] = &mapChunks[World_ChunkPack(cx, cy, cz)];
+			}
+		}
+	}
+
+	r->offset = beg;
+	r->count  = *offset - beg;
+	r->column = rz * regionsX + rx;
+	r->lod    = false;
+	r->dirty  = r->count; /* All chunks start off needing to be built */
+	r->loaded = 0;
+
+	r->minX = x1 * CHUNK_SIZE + HALF_CHUNK_SIZE; r->maxX = (x2 - 1) * CHUNK_SIZE + HALF_CHUNK_SIZE;
+	r->minY = y1 * CHUNK_SIZE + HALF_CHUNK_SIZE; r->maxY = (y2 - 1) * CHUNK_SIZE + HALF_CHUNK_SIZE;
+	r->minZ = z1 * CHUNK_SIZE + HALF_CHUNK_SIZE; r->maxZ = (z2 - 1) * CHUNK_SIZE + HALF_CHUNK_SIZE;
+
+	dx = (r->maxX - r->minX) * 0.5f; r->centreX = r->minX + dx;
+	dy = (r->maxY - r->minY) * 0.5f; r->centreY = r->minY + dy;
+	dz = (r->maxZ - r->minZ) * 0.5f; r->centreZ = r->minZ + dz;
+	/* Bounding sphere of all chunk centres, expanded by a chunk's own bounding sphere */
+	r->radius = Math_SqrtF(dx * dx + dy * dy + dz * dz) + 14;
+}
+
 static void InitChunks(void) {
-	int x, y, z, index = 0;
+	int i, x, y, z, index = 0;
 	for (z = 0; z < World.Length; z += CHUNK_SIZE) {
 		for (y = 0; y < World.Height; y += CHUNK_SIZE) {
 			for (x = 0; x < World.Width; x += CHUNK_SIZE) {
 				ChunkInfo_Init(&mapChunks[index], x, y, z);
-				sortedChunks[index] = &mapChunks[index];
-				renderChunks[index] = &mapChunks[index];
-				distances[index]    = 0;
 				index++;
 			}
 		}
 	}
+
+	index = 0;
+	for (z = 0; z < regionsZ; z++) {
+		for (y = 0; y < regionsY; y++) {
+			for (x = 0; x < regionsX; x++) {
+				InitRegion(&regions[(z * regionsY + y) * regionsX + x], x, y, z, &index);
+			}
+		}
+	}
+
+	for (i = 0; i < Game_NumStates; i++) {
+		for (index = 0; index < regionsCount; index++) {
+			views[i].sortedRegions[index] = index;
+		}
+		views[i].renderChunksCount = 0;
+	}
+#ifdef CC_BUILD_LODMESHES
+	InitLodMeshes();
+#endif
+
+	pendingCount = 0;
+	MarkChunksChanged();
 }
 
 static void RefreshChunks(void) {
@@ -471,6 +900,9 @@ static void RefreshChunks(void) {
 	{
 		ChunkInfo_Refresh(&mapChunks[i]);
 	}
+#ifdef CC_BUILD_LODMESHES
+	MarkLodMeshesDirty();
+#endif
 }
 
 static void DeleteChunks(void) {
@@ -482,11 +914,30 @@ static void DeleteChunks(void) {
 		DeleteChunk(&mapChunks[i]);
 	}
 	ResetPartCounts();
+#ifdef CC_BUILD_LODMESHES
+	FreeLodMeshes();
+#endif
+}
+
+/* Forces every viewport to recalculate the sort order of regions */
+static void ResetChunkPositions(void) {
+	int i;
+	for (i = 0; i < MAX_LOCAL_PLAYERS; i++) {
+		views[i].chunkPos = IVec3_MaxValue();
+	}
+}
+
+/* Forces every viewport to recalculate which chunks are visible */
+static void ResetCameraPositions(void) {
+	int i;
+	for (i = 0; i < MAX_LOCAL_PLAYERS; i++) {
+		views[i].lastCamPos = Vec3_BigPos();
+	}
 }
 
 void MapRenderer_Refresh(void) {
 	int oldCount;
-	chunkPos = IVec3_MaxValue();
+	ResetChunkPositions();
 
 	if (mapChunks && World.Blocks) {
 		DeleteChunks();
@@ -507,7 +958,7 @@ static void RefreshBorderChunks(int maxHeight) {
 	int cx, cy, cz;
 	cc_bool onBorder;
 
-	chunkPos = IVec3_MaxValue();
+	ResetChunkPositions();
 	if (!mapChunks || !World.Blocks) return;
 
 	for (cz = 0; cz < World.ChunksZ; cz++) {
@@ -527,10 +978,10 @@ static void RefreshBorderChunks(int maxHeight) {
 /*########################################################################################################################*
 *--------------------------------------------------Chunks updating/sorting------------------------------------------------*
 *#########################################################################################################################*/
-#define CHUNK_TARGET_TIME ((1.0f/30) + 0.01f)
+float MapRenderer_ChunkTargetTime = (1.0f/30) + 0.01f;
 static int chunksTarget = 12;
-static Vec3 lastCamPos;
-static float lastYaw, lastPitch;
+/* Whether any viewport has updated visibility (and hence queued chunks) since chunks were last built */
+static cc_bool visibilityUpdated;
 /* Max distance from camera that chunks are rendered within */
 /* This may differ from the view distance configured by the user */
 static int renderDistSquared;
@@ -538,6 +989,10 @@ static int renderDistSquared;
 /* Chunks past this distance are automatically unloaded */
 static int buildDistSquared;
 
+/* Number of chunks in each distance ring, used to bucket sort chunks by distance */
+static int* ringCounts;
+static int ringsCount;
+
 static int AdjustDist(int dist) {
 	if (dist < CHUNK_SIZE) dist = CHUNK_SIZE;
 	dist = Utils_AdjViewDist(dist);
@@ -547,98 +1002,342 @@ static int AdjustDist(int dist) {
 static void CalcViewDists(void) {
 	buildDistSquared  = AdjustDist(Game_UserViewDistance);
 	renderDistSquared = AdjustDist(Game_ViewDistance);
+
+	ringsCount = (int)Math_SqrtF((float)max(buildDistSquared, renderDistSquared)) + 2;
+	Mem_Free(ringCounts);
+	ringCounts = (int*)Mem_Alloc(ringsCount, sizeof(int), "chunk ring counts");
 }
 
-static int UpdateChunksAndVisibility(int* chunkUpdates) {
-	int renderDistSqr = renderDistSquared;
-	int buildDistSqr  = buildDistSquared;
+static CC_INLINE cc_uint16 DistRing(int distSqr) {
+	int ring = (int)Math_SqrtF((float)distSqr);
+	return min(ring, ringsCount - 1);
+}
 
+/* Builds the nearest chunks pending being rebuilt, up to chunksTarget chunks */
+static void BuildPendingChunks(int count, int* chunkUpdates) {
+	cc_uint16* rings = chunkRings + chunksCount;
 	struct ChunkInfo* info;
-	int i, j = 0, distSqr;
+	int i, maxRing = ringsCount, total = 0;
 
-	for (i = 0; i < chunksCount; i++) 
+	/* Find the distance ring that the furthest of the chunks to build is in */
+	if (count > chunksTarget) {
+		Mem_Set(ringCounts, 0, ringsCount * sizeof(int));
+		for (i = 0; i < count; i++) ringCounts[rings[i]]++;
+
+		for (maxRing = 0; maxRing < ringsCount; maxRing++) {
+			total += ringCounts[maxRing];
+			if (total >= chunksTarget) break;
+		}
+	}
+
+	for (i = 0; i < count && *chunkUpdates < chunksTarget; i++) 
+	{
+		if (rings[i] > maxRing) continue;
+		info = pendingChunks[i];
+
+		DeleteChunk(info);
+		BuildChunk(info, chunkUpdates);
+	}
+}
+
+/* Bucket sorts the visible chunks by distance ring into renderChunks */
+static void SortVisibleChunks(int count) {
+	cc_uint16* rings = chunkRings;
+	int i, n, total = 0;
+
+	Mem_Set(ringCounts, 0, ringsCount * sizeof(int));
+	for (i = 0; i < count; i++) ringCounts[rings[i]]++;
+
+	/* Turn counts into index of first chunk in each ring */
+	for (i = 0; i < ringsCount; i++) {
+		n = ringCounts[i]; ringCounts[i] = total; total += n;
+	}
+
+	for (i = 0; i < count; i++) {
+		curView->renderChunks[ringCounts[rings[i]]++] = visibleChunks[i];
+	}
+}
+
+static void UnloadRegion(struct ChunkRegion* r) {
+	struct ChunkInfo* info;
+	int i;
+
+	for (i = r->offset; i < r->offset + r->count; i++) 
+	{
+		info = regionChunks[i];
+		if (!info->noData) DeleteChunk(info);
+	}
+}
+
+#ifdef CC_BUILD_LODMESHES
+/* Building a low detail mesh reads as many blocks as building several chunks */
+#define LOD_BUILD_COST 8
+
+static int LodMesh_WantedScale(struct LodMesh* mesh) {
+	return lodFarDistSquared && mesh->minDist >= lodFarDistSquared ? 4 : 2;
+}
+
+/* Whether the given mesh needs to be (re)built */
+static cc_bool LodMesh_NeedsBuild(struct LodMesh* mesh) {
+	if (!mesh->scale || mesh->scale != LodMesh_WantedScale(mesh)) return true;
+	return mesh->dirty && Game.Time - mesh->dirtyTime >= LOD_DIRTY_DELAY;
+}
+
+static void BuildLodMesh(int index) {
+	struct LodMesh* mesh = &lodMeshes[index];
+	int rx = index % regionsX, rz = index / regionsX;
+	int x1 = rx * LODMESH_MAX_SIZE, x2 = min(x1 + LODMESH_MAX_SIZE, World.Width);
+	int z1 = rz * LODMESH_MAX_SIZE, z2 = min(z1 + LODMESH_MAX_SIZE, World.Length);
+
+	LodMesh_Free(mesh);
+	Builder_MakeLodMesh(mesh, x1, z1, x2, z2, LodMesh_WantedScale(mesh));
+	lodMemUsed += LodMesh_Memory(mesh);
+	Game.ChunkUpdates++;
+}
+
+/* Frees the furthest away low detail meshes until memory used is within the budget */
+static void EvictLodMeshes(void) {
+	struct LodMesh* mesh;
+	int i, furthest;
+
+	while (lodMemUsed > lodMemLimit) {
+		furthest = -1;
+		for (i = 0; i < lodMeshesCount; i++) 
+		{
+			mesh = &lodMeshes[i];
+			if (!mesh->scale) continue;
+			if (furthest == -1 || mesh->minDist > lodMeshes[furthest].minDist) furthest = i;
+		}
+		if (furthest == -1) return;
+
+		lodBudgetDist = lodMeshes[furthest].minDist;
+		LodMesh_Free(&lodMeshes[furthest]);
+	}
+}
+
+/* Builds the nearest low detail meshes that are missing or outdated */
+static void BuildLodMeshes(int* chunkUpdates) {
+	cc_uint32 renderDistSqr = renderDistSquared;
+	struct LodMesh* mesh;
+	int i, nearest;
+
+	/* Always build at least one mesh, so nearby chunk updates can't starve them */
+	do {
+		nearest = -1;
+		for (i = 0; i < lodMeshesCount; i++) 
+		{
+			mesh = &lodMeshes[i];
+			if (!mesh->wanted || mesh->minDist > renderDistSqr || mesh->minDist >= lodBudgetDist) continue;
+			if (!LodMesh_NeedsBuild(mesh)) continue;
+
+			if (nearest == -1 || mesh->minDist < lodMeshes[nearest].minDist) nearest = i;
+		}
+		if (nearest == -1) return;
+
+		BuildLodMesh(nearest);
+		EvictLodMeshes();
+		*chunkUpdates += LOD_BUILD_COST;
+	} while (*chunkUpdates < chunksTarget);
+}
+
+/* Frees low detail meshes which are no longer needed, then builds missing or outdated ones */
+static void UpdateLodMeshes(int* chunkUpdates) {
+	cc_uint32 renderDistSqr = renderDistSquared;
+	struct LodMesh* mesh;
+	int i;
+
+	for (i = 0; i < lodMeshesCount; i++) 
 	{
-		info = sortedChunks[i];
-		if (info->empty) continue;
-		distSqr = distances[i];
-		
-		/* Auto unload chunks far away chunks */
-		if (!info->noData && distSqr >= buildDistSqr + 32 * 16) {
-			DeleteChunk(info); continue;
+		mesh = &lodMeshes[i];
+		if (!mesh->scale) continue;
+
+		/* Keep drawing the low detail mesh until the chunks replacing it have been built */
+		if (mesh->minDist > renderDistSqr || !(mesh->wanted || mesh->pending)) {
+			LodMesh_Free(mesh);
+			lodBudgetDist = LOD_NO_BUDGET_DIST;
 		}
+	}
+	BuildLodMeshes(chunkUpdates);
+}
+
+/* Determines which low detail meshes are visible from this viewport's camera */
+static void FindVisibleLodMeshes(void) {
+	struct LodMesh* mesh;
+	int i;
+	curView->lodVisibleCount = 0;
+
+	for (i = 0; i < lodMeshesCount; i++) 
+	{
+		mesh = &lodMeshes[i];
+		if (!mesh->scale || !mesh->offsets[mesh->batches]) continue;
 
-		if (info->dirty && distSqr <= buildDistSqr && *chunkUpdates < chunksTarget) {
-			DeleteChunk(info);
-			BuildChunk(info, chunkUpdates);
+		if (FrustumCulling_SphereInFrustum(mesh->centreX, mesh->centreY, mesh->centreZ, mesh->radius)) {
+			curView->lodVisible[curView->lodVisibleCount++] = i;
 		}
+	}
+}
+#endif
+
+#define MapView_HasPos(view) ((view)->chunkPos.x != Int32_MaxValue)
+
+/* Distance of the given chunk's centre from the nearest camera */
+static cc_uint32 ChunkMinDist(struct ChunkInfo* info) {
+	cc_uint32 distSqr, minDistSqr = (cc_uint32)-1;
+	struct MapView* view;
+	int i, dx, dy, dz;
+
+	for (i = 0; i < Game_NumStates; i++) 
+	{
+		view = &views[i];
+		if (!MapView_HasPos(view)) continue;
 
-		info->visible = distSqr <= renderDistSqr &&
-			FrustumCulling_SphereInFrustum(info->centreX, info->centreY, info->centreZ, 14); /* 14 ~ sqrt(3 * 8^2) */
-		if (info->visible && !info->empty) { renderChunks[j] = info; j++; }
+		dx = info->centreX - view->chunkPos.x; dy = info->centreY - view->chunkPos.y; dz = info->centreZ - view->chunkPos.z;
+		distSqr    = dx * dx + dy * dy + dz * dz;
+		minDistSqr = min(minDistSqr, distSqr);
 	}
-	return j;
+	return minDistSqr;
 }
 
-static int UpdateChunksStill(int* chunkUpdates) {
-	int renderDistSqr = renderDistSquared;
-	int buildDistSqr  = buildDistSquared;
+/* Determines which chunks are visible from this viewport's camera, */
+/*  and queues chunks needing to be built / unloads chunks no longer needed by any viewport */
+static int UpdateChunksAndVisibility(void) {
+	cc_uint32 renderDistSqr = renderDistSquared;
+	cc_uint32 buildDistSqr  = buildDistSquared;
+	cc_uint32 unloadDistSqr = buildDistSquared + 32 * 16;
 
+	int visibleCount = 0;
+	struct ChunkRegion* r;
 	struct ChunkInfo* info;
-	int i, j = 0, distSqr;
+	cc_bool regionVisible, lodDrawn = false;
+	int i, j, dx, dy, dz;
+	cc_uint32 distSqr, minDistSqr;
+#ifdef CC_BUILD_LODMESHES
+	struct LodMesh* mesh;
+#endif
 
-	for (i = 0; i < chunksCount; i++) 
+	for (i = 0; i < regionsCount; i++) 
 	{
-		info = sortedChunks[i];
-		if (info->empty) continue;
-		distSqr = distances[i];
+		r = &regions[curView->sortedRegions[i]];
+
+#ifdef CC_BUILD_LODMESHES
+		mesh     = &lodMeshes[r->column];
+		lodDrawn = mesh->scale != 0;
+		/* Once built, far regions are drawn using the low detail mesh of their column instead */
+		if (r->lod && lodDrawn) {
+			if (r->loaded) UnloadRegion(r);
+			continue;
+		}
+#endif
 
-		/* Auto unload chunks far away chunks */
-		if (!info->noData && distSqr >= buildDistSqr + 32 * 16) {
-			DeleteChunk(info); continue;
+		/* Auto unload far away regions */
+		if (r->minDist >= unloadDistSqr) {
+			if (r->loaded) UnloadRegion(r);
+			continue;
 		}
 
-		if (info->dirty && distSqr <= buildDistSqr && *chunkUpdates < chunksTarget) {
-			DeleteChunk(info);
-			BuildChunk(info, chunkUpdates);
+		regionVisible = curView->regionDists[i] <= renderDistSqr &&
+			FrustumCulling_SphereInFrustum(r->centreX, r->centreY, r->centreZ, r->radius);
+
+		/* Skip checking chunks of hidden regions which have nothing to build or unload */
+		if (!regionVisible && !(r->dirty && r->minDist <= buildDistSqr) 
+				&& !(r->loaded && r->maxDist >= unloadDistSqr)) continue;
+
+		for (j = r->offset; j < r->offset + r->count; j++) 
+		{
+			info = regionChunks[j];
+			if (info->empty) continue;
+
+			dx = info->centreX - curView->chunkPos.x; dy = info->centreY - curView->chunkPos.y; dz = info->centreZ - curView->chunkPos.z;
+			distSqr = dx * dx + dy * dy + dz * dz;
+			/* Chunks are built and unloaded based on distance from the nearest camera */
+			minDistSqr = Game_NumStates > 1 ? ChunkMinDist(info) : distSqr;
+
+			/* Auto unload chunks far away chunks */
+			if (!info->noData && minDistSqr >= unloadDistSqr) {
+				DeleteChunk(info); continue;
+			}
+
+			/* Far chunks aren't built, as they will be replaced by a low detail mesh */
+			if (info->dirty && !info->queued && minDistSqr <= buildDistSqr && !r->lod) {
+				chunkRings[chunksCount + pendingCount] = DistRing(minDistSqr);
+				pendingChunks[pendingCount++]          = info;
+				info->queued = true;
+#ifdef CC_BUILD_LODMESHES
+				mesh->pending++;
+#endif
+			}
 
-			/* only need to update the visibility of chunks in range. */
-			info->visible = distSqr <= renderDistSqr &&
+			/* Chunks are hidden while the low detail mesh of their column is still drawn */
+			info->visible = regionVisible && !lodDrawn && distSqr <= renderDistSqr &&
 				FrustumCulling_SphereInFrustum(info->centreX, info->centreY, info->centreZ, 14); /* 14 ~ sqrt(3 * 8^2) */
-			if (info->visible && !info->empty) { renderChunks[j] = info; j++; }
-		} else if (info->visible) {
-			renderChunks[j] = info; j++;
+			if (!info->visible) continue;
+
+			chunkRings[visibleCount]      = DistRing(distSqr);
+			visibleChunks[visibleCount++] = info;
 		}
 	}
-	return j;
+
+	SortVisibleChunks(visibleCount);
+#ifdef CC_BUILD_LODMESHES
+	FindVisibleLodMeshes();
+#endif
+	visibilityUpdated = true;
+	return visibleCount;
+}
+
+/* Builds the nearest of the chunks and low detail meshes queued by all viewports */
+/* NOTE: Only done once every viewport has been updated, so that viewports share */
+/*  the chunk updates of each frame instead of competing with each other for them */
+static void BuildQueuedChunks(float delta) {
+	int i, chunkUpdates = 0;
+
+	/* Build more chunks if 30 FPS or over (by default), otherwise slowdown */
+	chunksTarget += delta < MapRenderer_ChunkTargetTime ? 1 : -1; 
+	Math_Clamp(chunksTarget, 4, maxChunkUpdates);
+
+	if (!visibilityUpdated) return;
+	visibilityUpdated = false;
+
+	BuildPendingChunks(pendingCount, &chunkUpdates);
+#ifdef CC_BUILD_LODMESHES
+	UpdateLodMeshes(&chunkUpdates);
+	for (i = 0; i < lodMeshesCount; i++) lodMeshes[i].pending = 0;
+#endif
+
+	for (i = 0; i < pendingCount; i++) pendingChunks[i]->queued = false;
+	pendingCount = 0;
 }
 
 static void UpdateChunks(float delta) {
 	struct LocalPlayer* p;
 	cc_bool samePos;
-	int chunkUpdates = 0;
 
-	/* Build more chunks if 30 FPS or over, otherwise slowdown */
-	chunksTarget += delta < CHUNK_TARGET_TIME ? 1 : -1; 
-	Math_Clamp(chunksTarget, 4, maxChunkUpdates);
+#ifdef CC_BUILD_LODMESHES
+	if (Game.CurrentState == 0) CheckLodMeshesDue();
+#endif
 
 	p = Entities.CurPlayer;
-	samePos = Vec3_Equals(&Camera.CurrentPos, &lastCamPos)
-		&& p->Base.Pitch == lastPitch && p->Base.Yaw == lastYaw;
-
-	renderChunksCount = samePos ?
-		UpdateChunksStill(&chunkUpdates) :
-		UpdateChunksAndVisibility(&chunkUpdates);
+	samePos = Vec3_Equals(&Camera.CurrentPos, &curView->lastCamPos)
+		&& p->Base.Pitch == curView->lastPitch && p->Base.Yaw == curView->lastYaw;
+
+	/* Visible chunks can only change if camera moved or chunks were changed */
+	if (!samePos || curView->chunksChanged) {
+		curView->chunksChanged     = false;
+		curView->renderChunksCount = UpdateChunksAndVisibility();
+		curView->normList.dirty    = true;
+		curView->tranList.dirty    = true;
+	}
 
-	lastCamPos = Camera.CurrentPos;
-	lastPitch  = p->Base.Pitch;
-	lastYaw    = p->Base.Yaw;
+	curView->lastCamPos = Camera.CurrentPos;
+	curView->lastPitch  = p->Base.Pitch;
+	curView->lastYaw    = p->Base.Yaw;
 
-	if (!samePos || chunkUpdates) ResetPartFlags();
+	if (Game.CurrentState == Game_NumStates - 1) BuildQueuedChunks(delta);
 }
 
-static void SortMapChunks(int left, int right) {
-	struct ChunkInfo** values = sortedChunks; struct ChunkInfo* value;
-	cc_uint32* keys = distances; cc_uint32 key;
+static void SortRegions(int left, int right) {
+	int* values = curView->sortedRegions; int value;
+	cc_uint32* keys = curView->regionDists; cc_uint32 key;
 
 	while (left < right) {
 		int i = left, j = right;
@@ -651,12 +1350,86 @@ static void SortMapChunks(int left, int right) {
 			QuickSort_Swap_KV_Maybe();
 		}
 		/* recurse into the smaller subset */
-		QuickSort_Recurse(SortMapChunks)
+		QuickSort_Recurse(SortRegions)
+	}
+}
+
+/* Distance along an axis to the nearest point in the given range */
+static CC_INLINE int NearestAxisDist(int pos, int lo, int hi) {
+	return pos < lo ? lo - pos : (pos > hi ? pos - hi : 0);
+}
+
+/* Distance along an axis to the furthest point in the given range */
+static CC_INLINE int FurthestAxisDist(int pos, int lo, int hi) {
+	return max(pos - lo, hi - pos);
+}
+
+/* Calculates distance of each region from the nearest camera */
+static void UpdateRegionDists(void) {
+	struct ChunkRegion* r;
+	IVec3* pos;
+	cc_uint32 distSqr;
+	int i, j, dx, dy, dz;
+
+	for (i = 0; i < regionsCount; i++) {
+		r = &regions[i];
+		r->minDist = (cc_uint32)-1;
+		r->maxDist = (cc_uint32)-1;
+
+		for (j = 0; j < Game_NumStates; j++) {
+			if (!MapView_HasPos(&views[j])) continue;
+			pos = &views[j].chunkPos;
+
+			dx = NearestAxisDist(pos->x, r->minX, r->maxX);
+			dy = NearestAxisDist(pos->y, r->minY, r->maxY);
+			dz = NearestAxisDist(pos->z, r->minZ, r->maxZ);
+			distSqr    = dx * dx + dy * dy + dz * dz;
+			r->minDist = min(r->minDist, distSqr);
+
+			dx = FurthestAxisDist(pos->x, r->minX, r->maxX);
+			dy = FurthestAxisDist(pos->y, r->minY, r->maxY);
+			dz = FurthestAxisDist(pos->z, r->minZ, r->maxZ);
+			distSqr    = dx * dx + dy * dy + dz * dz;
+			r->maxDist = min(r->maxDist, distSqr);
+		}
+	}
+}
+
+#ifdef CC_BUILD_LODMESHES
+static void UpdateLodDistances(void) {
+	struct LodMesh* mesh;
+	struct ChunkRegion* r;
+	IVec3* pos;
+	cc_uint32 distSqr;
+	int i, rx, ry, rz, dx, dz;
+
+	for (rz = 0; rz < regionsZ; rz++) {
+		for (rx = 0; rx < regionsX; rx++) {
+			mesh = &lodMeshes[rz * regionsX + rx];
+			r    = &regions[rz * regionsY * regionsX + rx];
+			mesh->minDist = (cc_uint32)-1;
+
+			for (i = 0; i < Game_NumStates; i++) {
+				if (!MapView_HasPos(&views[i])) continue;
+				pos = &views[i].chunkPos;
+
+				dx = NearestAxisDist(pos->x, r->minX, r->maxX);
+				dz = NearestAxisDist(pos->z, r->minZ, r->maxZ);
+				distSqr       = dx * dx + dz * dz;
+				mesh->minDist = min(mesh->minDist, distSqr);
+			}
+			mesh->wanted = lodDistSquared && mesh->minDist >= lodDistSquared;
+
+			for (ry = 0; ry < regionsY; ry++) {
+				regions[(rz * regionsY + ry) * regionsX + rx].lod = mesh->wanted;
+			}
+		}
 	}
 }
+#endif
 
 static void UpdateSortOrder(void) {
-	struct ChunkInfo* info;
+	struct ChunkRegion* r;
 	IVec3 pos;
 	int i, dx, dy, dz;
 
@@ -667,36 +1440,35 @@ static void UpdateSortOrder(void) {
 	pos.z = (pos.z & ~CHUNK_MASK) + HALF_CHUNK_SIZE;
 
 	/* If in same chunk, don't need to recalculate sort order */
-	if (pos.x == chunkPos.x && pos.y == chunkPos.y && pos.z == chunkPos.z) return;
-	chunkPos = pos;
-	if (!chunksCount) return;
+	if (pos.x == curView->chunkPos.x && pos.y == curView->chunkPos.y && pos.z == curView->chunkPos.z) return;
+	curView->chunkPos = pos;
+	if (!regionsCount) return;
 
-	for (i = 0; i < chunksCount; i++) {
-		info = sortedChunks[i];
-		/* Calculate distance to chunk centre */
-		dx = info->centreX - pos.x; dy = info->centreY - pos.y; dz = info->centreZ - pos.z;
-		distances[i] = dx * dx + dy * dy + dz * dz;
+	UpdateRegionDists();
 
-		/* Consider these 3 chunks: */
-		/* |       X-1      |        X        |       X+1      | */
-		/* |################|########@########|################| */
-		/* Assume the player is standing at @, then DrawXMin/XMax is calculated as this */
-		/*    X-1: DrawXMin = false, DrawXMax = true  */
-		/*    X  : DrawXMin = true,  DrawXMax = true  */
-		/*    X+1: DrawXMin = true,  DrawXMax = false */
+	/* Only regions are sorted here, chunks are sorted when determining which are visible */
+	/* Previous sort order is kept, as it's usually nearly sorted already */
+	for (i = 0; i < regionsCount; i++) {
+		r = &regions[curView->sortedRegions[i]];
 
-		info->drawXMin = dx >= 0; info->drawXMax = dx <= 0;
-		info->drawZMin = dz >= 0; info->drawZMax = dz <= 0;
-		info->drawYMin = dy >= 0; info->drawYMax = dy <= 0;
+		dx = NearestAxisDist(pos.x, r->minX, r->maxX);
+		dy = NearestAxisDist(pos.y, r->minY, r->maxY);
+		dz = NearestAxisDist(pos.z, r->minZ, r->maxZ);
+		curView->regionDists[i] = dx * dx + dy * dy + dz * dz;
 	}
 
-	SortMapChunks(0, chunksCount - 1);
-	ResetPartFlags();
-	/*SimpleOcclusionCulling();*/
+	SortRegions(0, regionsCount - 1);
+#ifdef CC_BUILD_LODMESHES
+	UpdateLodDistances();
+#endif
+	/* Distances from the nearest camera changed, so other viewports may need to unload/build chunks too */
+	InvalidateDrawLists();
+	MarkChunksChanged();
 }
 
 void MapRenderer_Update(float delta) {
 	if (!mapChunks) return;
+	curView = &views[Game.CurrentState];
 	UpdateSortOrder();
 	UpdateChunks(delta);
 }
@@ -711,6 +1483,9 @@ void MapRenderer_RefreshChunk(int cx, int cy, int cz) {
 
 	chunk = &mapChunks[World_ChunkPack(cx, cy, cz)];
 	ChunkInfo_Refresh(chunk);
+#ifdef CC_BUILD_LODMESHES
+	MarkLodMeshDirty(cx << CHUNK_SHIFT, cz << CHUNK_SHIFT);
+#endif
 }
 
 void MapRenderer_OnBlockChanged(int x, int y, int z, BlockID block) {
@@ -721,6 +1496,9 @@ void MapRenderer_OnBlockChanged(int x, int y, int z, BlockID block) {
 	chunk->allAir &= Blocks.Draw[block] == DRAW_GAS;
 	/* TODO: Don't lookup twice, refresh directly using chunk pointer */
 	ChunkInfo_Refresh(chunk);
+#ifdef CC_BUILD_LODMESHES
+	MarkLodMeshDirty(x, z);
+#endif
 }
 
 static void OnEnvVariableChanged(void* obj, int envVar) {
@@ -737,25 +1515,26 @@ static void OnEnvVariableChanged(void* obj, int envVar) {
 }
 
 static void OnTerrainAtlasChanged(void* obj) {
-	static int tilesPerAtlas;
+	static int tilesPerAtlas, repeats;
 	/* e.g. If old atlas was 256x256 and new is 256x256, don't need to refresh */
-	if (MapRenderer_1DUsedCount && tilesPerAtlas != Atlas1D.TilesPerAtlas) {
+	if (MapRenderer_1DUsedCount && (tilesPerAtlas != Atlas1D.TilesPerAtlas || repeats != Atlas1D.Repeats)) {
 		MapRenderer_Refresh();
 	}
 
 	MapRenderer_1DUsedCount = MapRenderer_UsedAtlases();
 	tilesPerAtlas = Atlas1D.TilesPerAtlas;
-	ResetPartFlags();
+	repeats       = Atlas1D.Repeats;
+	InvalidateDrawLists();
 }
 
 static void OnBlockDefinitionChanged(void* obj) {
 	MapRenderer_Refresh();
 	MapRenderer_1DUsedCount = MapRenderer_UsedAtlases();
-	ResetPartFlags();
+	InvalidateDrawLists();
 }
 
 static void OnVisibilityChanged(void* obj) {
-	lastCamPos = Vec3_BigPos();
+	ResetCameraPositions();
 	CalcViewDists();
 }
 static void DeleteChunks_(void* obj) { DeleteChunks(); }
@@ -766,7 +1545,7 @@ static void OnNewMap(void) {
 	DeleteChunks();
 	ResetPartCounts();
 
-	chunkPos = IVec3_MaxValue();
+	ResetChunkPositions();
 	FreeChunks();
 	FreeParts();
 }
@@ -783,10 +1562,13 @@ static void OnNewMapLoaded(void) {
 	/*}*/
 
 	InitChunks();
-	lastCamPos = Vec3_BigPos();
+	ResetCameraPositions();
 }
 
 static void OnInit(void) {
+#ifdef CC_BUILD_LODMESHES
+	int dist;
+#endif
 	Event_Register_(&TextureEvents.AtlasChanged,  NULL, OnTerrainAtlasChanged);
 	Event_Register_(&WorldEvents.EnvVarChanged,   NULL, OnEnvVariableChanged);
 	Event_Register_(&BlockEvents.BlockDefChanged, NULL, OnBlockDefinitionChanged);
@@ -798,8 +1580,15 @@ static void OnInit(void) {
 
 	/* This = 87 fixes map being invisible when no textures */
 	MapRenderer_1DUsedCount = 87; /* Atlas1D_UsedAtlasesCount(); */
-	chunkPos   = IVec3_MaxValue();
+	ResetChunkPositions();
 	maxChunkUpdates = Options_GetInt(OPT_MAX_CHUNK_UPDATES, 4, 1024, 30);
+#ifdef CC_BUILD_LODMESHES
+	dist = Options_GetInt(OPT_LOD_DISTANCE, 0, 32768, 0);
+	lodDistSquared    = dist * dist;
+	dist = Options_GetInt(OPT_LOD_FAR_DISTANCE, 0, 32768, dist * 2);
+	lodFarDistSquared = dist * dist;
+	lodMemLimit = Options_GetInt(OPT_LOD_MEMORY, 1, 1024, 64) * 1024 * 1024;
+#endif
 	CalcViewDists();
 }
 
@@ -14,6 +14,8 @@ extern struct IGameComponent MapRenderer_Component;
 
 /* Max used 1D atlases. (i.e. Atlas1D_Index(maxTextureLoc) + 1) */
 extern int MapRenderer_1DUsedCount;
+/* More chunks are built each frame while frame time (in seconds) is below this, otherwise fewer */
+extern float MapRenderer_ChunkTargetTime;
 
 /* Buffer for all chunk parts. There are (MapRenderer_ChunksCount * Atlas1D_Count) parts in the buffer,
 with parts for 'normal' buffer being in lower half. */
@@ -41,6 +43,7 @@ struct ChunkInfo {
 	cc_uint8 dirty : 1;   /* Whether chunk is pending being rebuilt */
 	cc_uint8 allAir : 1;  /* Whether chunk is completely air */
 	cc_uint8 noData : 1;  /* Whether the chunk is currently empty of data, but may have data if built */
+	cc_uint8 queued : 1;  /* Whether chunk is in the queue of chunks to build this frame */
 	cc_uint8 : 0;         /* pad to next byte*/
 
 	cc_uint8 drawXMin : 1;
@@ -61,13 +64,37 @@ struct ChunkInfo {
 	struct ChunkPartInfo* translucentParts;
 };
 
+#if !defined CC_BUILD_LOWMEM && CC_GFX_BACKEND != CC_GFX_BACKEND_GL11
+#define CC_BUILD_LODMESHES
+#endif
+
+#ifdef CC_BUILD_LODMESHES
+/* Max width/length of the area covered by a low detail mesh (i.e. 8 chunks) */
+#define LODMESH_MAX_SIZE 128
+
+/* Describes a low detail mesh of the surface of a column of chunks, */
+/*  which is rendered instead of those chunks when far away from the camera */
+struct LodMesh {
+	GfxResourceID vb;
+	int* offsets;     /* Index of first vertex for each 1D atlas batch (batches + 1 entries) */
+	int batches;      /* Number of 1D atlas batches when mesh was built */
+	cc_uint8 scale;   /* Number of blocks merged along X and Z into each cell, 0 if not built */
+	cc_bool dirty;    /* Whether blocks have changed since the mesh was built */
+	float dirtyTime;  /* Value of Game.Time when the mesh first became dirty */
+	cc_bool wanted;   /* Whether far enough away from all cameras to be drawn at low detail */
+	int pending;      /* Number of chunks in this column pending being built */
+	cc_uint32 minDist; /* Horizontal distance of nearest chunk centre from the nearest camera */
+	float centreX, centreY, centreZ, radius;
+};
+#endif
+
 /* Renders the meshes of non-translucent blocks in visible chunks. */
 void MapRenderer_RenderNormal(float delta);
 /* Renders the meshes of translucent blocks in visible chunks. */
 void MapRenderer_RenderTranslucent(float delta);
 /* Potentially updates sort order of rendered chunks. */
 /* Potentially builds meshes for several nearby chunks. */
-/* NOTE: This should be called once per frame. */
+/* NOTE: This should be called once per frame for each viewport. */
 void MapRenderer_Update(float delta);
 
 /* Marks the given chunk as needing to be rebuilt/redrawn. */
@@ -2630,6 +2630,7 @@ static void TexIdsOverlay_Render(void* screen, float delta) {
 	Gfx_BindDynamicVb(s->vb);
 
 	offset = Widget_Render2(&s->title, offset);
+	Gui_FlushDraws();
 	offset = TexIdsOverlay_RenderTerrain(s, offset);
 
 	Gfx_BindTexture(s->idAtlas.tex.ID);
@@ -2923,7 +2924,7 @@ void TexPackOverlay_Show(const cc_string* url) {
 	String_InitArray(s->url, s->_urlBuffer);
 	String_Copy(&s->url, url);
 
-	s->reqID = Http_AsyncGetHeaders(url, HTTP_FLAG_PRIORITY);
+	s->reqID = Http_AsyncGetHeaders(url, HTTP_FLAG_PRIORITY | HTTP_FLAG_TEXTURE_PACK);
 	Gui_Add((struct Screen*)s, GUI_PRIORITY_TEXPACK);
 }
 
@@ -506,16 +506,19 @@ void Model_RegisterTexture(struct ModelTex* tex) {
 	LinkedList_Append(tex, textures_head, textures_tail);
 }
 
-static void Models_TextureChanged(void* obj, struct Stream* stream, const cc_string* name) {
+struct ModelTex* Model_FindTexture(const cc_string* name) {
 	struct ModelTex* tex;
 
 	for (tex = textures_head; tex; tex = tex->next) 
 	{
-		if (!String_CaselessEqualsConst(name, tex->name)) continue;
-
-		Game_UpdateTexture(&tex->texID, stream, name, &tex->skinType, NULL);
-		return;
+		if (String_CaselessEqualsConst(name, tex->name)) return tex;
 	}
+	return NULL;
+}
+
+static void Models_TextureChanged(void* obj, struct Stream* stream, const cc_string* name) {
+	struct ModelTex* tex = Model_FindTexture(name);
+	if (tex) Game_UpdateTexture(&tex->texID, stream, name, &tex->skinType, NULL);
 }
 
 
@@ -945,6 +948,8 @@ static void HumanModel_DrawCore(struct Entity* e, struct ModelSet* model, cc_boo
 	type = Models.skinType & 0x3;
 	set  = &model->limbs[type];
 	num  = HUMAN_BASE_VERTICES + (type == SKIN_64x32 ? HUMAN_HAT32_VERTICES : HUMAN_HAT64_VERTICES);
+	/* Outer skin layer details aren't noticeable from far away */
+	if (Models.LowDetail) num = HUMAN_BASE_VERTICES;
 	Model_LockVB(e, num);
 
 	Model_DrawRotate(-e->Pitch * MATH_DEG2RAD, 0, 0, &model->head, true);
@@ -957,7 +962,7 @@ static void HumanModel_DrawCore(struct Entity* e, struct ModelSet* model, cc_boo
 	Model_DrawRotate(e->Anim.RightArmX, 0, e->Anim.RightArmZ, &set->rightArm, false);
 	Models.Rotation = ROTATE_ORDER_ZYX;
 
-	if (type != SKIN_64x32) {
+	if (type != SKIN_64x32 && !Models.LowDetail) {
 		Model_DrawPart(&model->torsoLayer);
 		Model_DrawRotate(e->Anim.LeftLegX,  0, e->Anim.LeftLegZ,  &set->leftLegLayer,  false);
 		Model_DrawRotate(e->Anim.RightLegX, 0, e->Anim.RightLegZ, &set->rightLegLayer, false);
@@ -967,7 +972,9 @@ static void HumanModel_DrawCore(struct Entity* e, struct ModelSet* model, cc_boo
 		Model_DrawRotate(e->Anim.RightArmX, 0, e->Anim.RightArmZ, &set->rightArmLayer, false);
 		Models.Rotation = ROTATE_ORDER_ZYX;
 	}
-	Model_DrawRotate(-e->Pitch * MATH_DEG2RAD, 0, 0, &model->hat, true);
+	if (!Models.LowDetail) {
+		Model_DrawRotate(-e->Pitch * MATH_DEG2RAD, 0, 0, &model->hat, true);
+	}
 
 	Model_UnlockVB();
 	if (opaqueBody) {
@@ -975,7 +982,9 @@ static void HumanModel_DrawCore(struct Entity* e, struct ModelSet* model, cc_boo
 		Gfx_SetAlphaTest(false);
 		Gfx_DrawVb_IndexedTris_Range(HUMAN_BASE_VERTICES, 0, DRAW_HINT_NONE);
 		Gfx_SetAlphaTest(true);
-		Gfx_DrawVb_IndexedTris_Range(num - HUMAN_BASE_VERTICES, HUMAN_BASE_VERTICES, DRAW_HINT_NONE);
+
+		if (num > HUMAN_BASE_VERTICES)
+			Gfx_DrawVb_IndexedTris_Range(num - HUMAN_BASE_VERTICES, HUMAN_BASE_VERTICES, DRAW_HINT_NONE);
 	} else {
 		Gfx_DrawVb_IndexedTris(num);
 	}
@@ -116,6 +116,9 @@ CC_VAR extern struct _ModelsData {
 	struct Model* Human;
 	/* Pointer to block model */
 	struct Model* Block;
+	/* Whether the entity being rendered is far enough away to skip fine details */
+	/* (e.g. humanoid models skip drawing the outer skin layer parts) */
+	cc_bool LowDetail;
 } Models;
 
 /* Initialises fields of a model to default. */
@@ -159,6 +162,9 @@ void Model_Unregister(struct Model* model);
 /* Adds a texture to the list of automatically managed model textures. */
 /* These textures are automatically loaded from texture packs. (e.g. "skeleton.png") */
 CC_API void Model_RegisterTexture(struct ModelTex* tex);
+/* Finds the model texture with the given filename. (e.g. "skeleton.png") */
+/* NOTE: Returns NULL if no model texture has that filename */
+struct ModelTex* Model_FindTexture(const cc_string* name);
 
 /* Describes data for a box being built. */
 struct BoxDesc {
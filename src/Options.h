@@ -13,18 +13,26 @@ Copyright 2014-2025 ClassiCube | Licensed under BSD-3
 #define OPT_FORCE_OPENAL "forceopenal"
 #define OPT_MIN_MUSIC_DELAY "music-mindelay"
 #define OPT_MAX_MUSIC_DELAY "music-maxdelay"
+#define OPT_SOUND_CACHE_SIZE "sounds-cachesize"
 
 #define OPT_VIEW_DISTANCE "viewdist"
+#define OPT_MAP_CACHE_COUNT "map-cachecount"
 #define OPT_BLOCK_PHYSICS "singleplayerphysics"
 #define OPT_NAMES_MODE "namesmode"
 #define OPT_INVERT_MOUSE "invertmouse"
 #define OPT_SENSITIVITY "mousesensitivity"
 #define OPT_FPS_LIMIT "fpslimit"
+#define OPT_AUTO_QUALITY_FPS "gfx-autoqualityfps"
 #define OPT_DEFAULT_TEX_PACK "defaulttexpack"
 #define OPT_VIEW_BOBBING "viewbobbing"
 #define OPT_ENTITY_SHADOW "entityshadow"
+#define OPT_ENTITY_LOD_DISTANCE "entity-lod-distance"
+#define OPT_ENTITY_CULL_DISTANCE "entity-cull-distance"
 #define OPT_RENDER_TYPE "normal"
 #define OPT_SMOOTH_LIGHTING "gfx-smoothlighting"
+#define OPT_GREEDY_MESHING "gfx-greedymeshing"
+#define OPT_MESH_CACHE "gfx-meshcache"
+#define OPT_MESH_CACHE_SIZE "gfx-meshcachesize"
 #define OPT_LIGHTING_MODE "gfx-lightingmode"
 #define OPT_MIPMAPS "gfx-mipmaps"
 #define OPT_CHAT_LOGGING "chat-logging"
@@ -72,6 +80,10 @@ Copyright 2014-2025 ClassiCube | Licensed under BSD-3
 #define OPT_CLASSIC_CHAT "nostalgia-classicchat"
 #define OPT_CLASSIC_INVENTORY "nostalgia-classicinventory"
 #define OPT_MAX_CHUNK_UPDATES "gfx-maxchunkupdates"
+#define OPT_LOD_DISTANCE "gfx-loddistance"
+#define OPT_LOD_FAR_DISTANCE "gfx-lodfardistance"
+#define OPT_LOD_MEMORY "gfx-lodmemory"
+#define OPT_MAX_PARTICLES "gfx-maxparticles"
 #define OPT_CAMERA_MASS "cameramass"
 #define OPT_CAMERA_SMOOTH "camera-smooth"
 #define OPT_GRAB_CURSOR "win-grab-cursor"
@@ -81,6 +93,7 @@ Copyright 2014-2025 ClassiCube | Licensed under BSD-3
 #define OPT_HTTP_ONLY "http-no-https"
 #define OPT_HTTPS_VERIFY "https-verify"
 #define OPT_SKIN_SERVER "http-skinserver"
+#define OPT_HTTP_CACHE_SIZE "http-cachesize"
 #define OPT_RAW_INPUT "win-raw-input"
 #define OPT_DPI_SCALING "win-dpi-scaling"
 #define OPT_GAME_VERSION "game-version"
@@ -9,12 +9,16 @@
 #include "Funcs.h"
 #include "Game.h"
 #include "Event.h"
+#include "Options.h"
+#include "Platform.h"
 
 #ifdef CC_BUILD_TINYMEM
-	#define PARTICLES_MAX 10
+	#define PARTICLES_DEF_MAX 10
 #else
-	#define PARTICLES_MAX 600
+	#define PARTICLES_DEF_MAX 600
 #endif
+/* Maximum number of particles that can be drawn with one draw call */
+#define PARTICLES_MAX_BATCH (GFX_MAX_VERTICES / 4)
 
 
 /*########################################################################################################################*
@@ -23,8 +27,66 @@
 static GfxResourceID particles_TexId, particles_VB;
 static RNGState rnd;
 static cc_bool hitTerrain;
+static int particles_max, particles_limit;
 typedef cc_bool (*CanPassThroughFunc)(BlockID b);
 
+/* Stores the state of particles as a structure of arrays, */
+/*  which allows the integration loop to be auto-vectorised */
+struct ParticleList {
+	float* lastX; float* lastY; float* lastZ;
+	float* nextX; float* nextY; float* nextZ;
+	float* velX;  float* velY;  float* velZ;
+	float* lifetime; float* size; float* gravity;
+	int count, capacity;
+};
+#define PARTICLE_LIST_ARRAYS 12
+
+static cc_bool ParticleList_Alloc(struct ParticleList* l) {
+	float* data;
+	int cap = particles_max;
+	if (l->capacity) return true;
+
+	data = (float*)Mem_TryAlloc(cap, PARTICLE_LIST_ARRAYS * sizeof(float));
+	if (!data) return false;
+
+	l->lastX = data + cap *  0; l->lastY = data + cap *  1; l->lastZ = data + cap *  2;
+	l->nextX = data + cap *  3; l->nextY = data + cap *  4; l->nextZ = data + cap *  5;
+	l->velX  = data + cap *  6; l->velY  = data + cap *  7; l->velZ  = data + cap *  8;
+	l->lifetime = data + cap * 9; l->size = data + cap * 10; l->gravity = data + cap * 11;
+	l->capacity = cap;
+	return true;
+}
+
+/* Whether the oldest particle needs to be removed before adding another */
+static cc_bool ParticleList_Full(struct ParticleList* l) {
+	return l->count >= l->capacity || l->count >= particles_limit;
+}
+
+void Particles_ScaleLimit(int percent) {
+	particles_limit = max(10, particles_max * percent / 100);
+}
+
+static void ParticleList_Free(struct ParticleList* l) {
+	Mem_Free(l->lastX);
+	Mem_Set(l, 0, sizeof(struct ParticleList));
+}
+
+/* Moves the last particle in the list into the given slot */
+static void ParticleList_SwapRemove(struct ParticleList* l, int i, int last) {
+	l->lastX[i] = l->lastX[last]; l->lastY[i] = l->lastY[last]; l->lastZ[i] = l->lastZ[last];
+	l->nextX[i] = l->nextX[last]; l->nextY[i] = l->nextY[last]; l->nextZ[i] = l->nextZ[last];
+	l->velX[i]  = l->velX[last];  l->velY[i]  = l->velY[last];  l->velZ[i]  = l->velZ[last];
+
+	l->lifetime[i] = l->lifetime[last];
+	l->size[i]     = l->size[last];
+	l->gravity[i]  = l->gravity[last];
+}
+
+static void ParticleList_Spawn(struct ParticleList* l, int i, float x, float y, float z) {
+	l->lastX[i] = x; l->lastY[i] = y; l->lastZ[i] = z;
+	l->nextX[i] = x; l->nextY[i] = y; l->nextZ[i] = z;
+}
+
 void Particle_DoRender(const Vec2* size, const Vec3* pos, const TextureRec* rec, PackedCol col, struct VertexTextured* v) {
 	struct Matrix* view;
 	float sX, sY;
@@ -44,95 +106,145 @@ void Particle_DoRender(const Vec2* size, const Vec3* pos, const TextureRec* rec,
 	v->x = centre.x + aX - bX; v->y = centre.y + aY - bY; v->z = centre.z + aZ - bZ; v->Col = col; v->U = rec->u2; v->V = rec->v2; v++;
 }
 
-static cc_bool CollidesHor(Vec3* nextPos, BlockID block) {
-	Vec3 horPos = Vec3_Create3((float)Math_Floor(nextPos->x), 0.0f, (float)Math_Floor(nextPos->z));
-	Vec3 min, max;
-	Vec3_Add(&min, &Blocks.MinBB[block], &horPos);
-	Vec3_Add(&max, &Blocks.MaxBB[block], &horPos);
-	return nextPos->x >= min.x && nextPos->z >= min.z && nextPos->x < max.x && nextPos->z < max.z;
+static void ParticleList_GetPos(struct ParticleList* l, int i, float t, Vec3* pos) {
+	pos->x = l->lastX[i] + (l->nextX[i] - l->lastX[i]) * t;
+	pos->y = l->lastY[i] + (l->nextY[i] - l->lastY[i]) * t;
+	pos->z = l->lastZ[i] + (l->nextZ[i] - l->lastZ[i]) * t;
+}
+
+
+/*########################################################################################################################*
+*----------------------------------------------------Particle collision---------------------------------------------------*
+*#########################################################################################################################*/
+/* Particles are usually clustered together in the same few cells (e.g. from breaking a block), */
+/*  so block lookups are cached for the duration of a tick to avoid repeatedly looking them up */
+#define CELL_CACHE_SIZE 64
+static struct CellCacheEntry { int x, y, z, tick; BlockID block; } cell_cache[CELL_CACHE_SIZE];
+static int cell_tick = 1;
+
+static cc_bool CollidesHor(float x, float z, BlockID block) {
+	float horX = (float)Math_Floor(x), horZ = (float)Math_Floor(z);
+	return x >= horX + Blocks.MinBB[block].x && z >= horZ + Blocks.MinBB[block].z 
+		&& x <  horX + Blocks.MaxBB[block].x && z <  horZ + Blocks.MaxBB[block].z;
 }
 
 static BlockID GetBlock(int x, int y, int z) {
-	if (World_Contains(x, y, z)) return World_GetBlock(x, y, z);
+	struct CellCacheEntry* entry;
+	BlockID block;
+	entry = &cell_cache[((x * 7) ^ (y * 13) ^ (z * 31)) & (CELL_CACHE_SIZE - 1)];
+	if (entry->tick == cell_tick && entry->x == x && entry->y == y && entry->z == z) return entry->block;
+
+	if (World_Contains(x, y, z)) {
+		block = World_GetBlock(x, y, z);
+	} else if (y >= Env.EdgeHeight) {
+		block = BLOCK_AIR;
+	} else if (y >= Env_SidesHeight) {
+		block = Env.EdgeBlock;
+	} else {
+		block = Env.SidesBlock;
+	}
 
-	if (y >= Env.EdgeHeight)  return BLOCK_AIR;
-	if (y >= Env_SidesHeight) return Env.EdgeBlock;
-	return Env.SidesBlock;
+	entry->x = x; entry->y = y; entry->z = z;
+	entry->tick  = cell_tick;
+	entry->block = block;
+	return block;
 }
 
-static cc_bool ClipY(struct Particle* p, int y, cc_bool topFace, CanPassThroughFunc canPassThrough) {
+static cc_bool ClipY(struct ParticleList* l, int i, int y, cc_bool topFace, CanPassThroughFunc canPassThrough) {
 	BlockID block;
-	Vec3 minBB, maxBB;
 	float collideY;
 	cc_bool collideVer;
 
 	if (y < 0) {
-		p->nextPos.y = ENTITY_ADJUSTMENT; 
-		p->lastPos.y = ENTITY_ADJUSTMENT;
+		l->nextY[i] = ENTITY_ADJUSTMENT; 
+		l->lastY[i] = ENTITY_ADJUSTMENT;
 
-		Vec3_Set(p->velocity, 0,0,0);
+		l->velX[i] = 0; l->velY[i] = 0; l->velZ[i] = 0;
 		hitTerrain = true;
 		return false;
 	}
 
-	block = GetBlock((int)p->nextPos.x, y, (int)p->nextPos.z);
+	block = GetBlock((int)l->nextX[i], y, (int)l->nextZ[i]);
 	if (canPassThrough(block)) return true;
-	minBB = Blocks.MinBB[block]; maxBB = Blocks.MaxBB[block];
 
-	collideY   = y + (topFace ? maxBB.y : minBB.y);
-	collideVer = topFace ? (p->nextPos.y < collideY) : (p->nextPos.y > collideY);
+	collideY   = y + (topFace ? Blocks.MaxBB[block].y : Blocks.MinBB[block].y);
+	collideVer = topFace ? (l->nextY[i] < collideY) : (l->nextY[i] > collideY);
 
-	if (collideVer && CollidesHor(&p->nextPos, block)) {
+	if (collideVer && CollidesHor(l->nextX[i], l->nextZ[i], block)) {
 		float adjust = topFace ? ENTITY_ADJUSTMENT : -ENTITY_ADJUSTMENT;
-		p->lastPos.y = collideY + adjust;
-		p->nextPos.y = p->lastPos.y;
+		l->lastY[i] = collideY + adjust;
+		l->nextY[i] = l->lastY[i];
 
-		Vec3_Set(p->velocity, 0,0,0);
+		l->velX[i] = 0; l->velY[i] = 0; l->velZ[i] = 0;
 		hitTerrain = true;
 		return false;
 	}
 	return true;
 }
 
-static cc_bool IntersectsBlock(struct Particle* p, CanPassThroughFunc canPassThrough) {
-	BlockID cur = GetBlock((int)p->nextPos.x, (int)p->nextPos.y, (int)p->nextPos.z);
-	float minY  = Math_Floor(p->nextPos.y) + Blocks.MinBB[cur].y;
-	float maxY  = Math_Floor(p->nextPos.y) + Blocks.MaxBB[cur].y;
+static cc_bool IntersectsBlock(struct ParticleList* l, int i, CanPassThroughFunc canPassThrough) {
+	float x = l->nextX[i], y = l->nextY[i], z = l->nextZ[i];
+	BlockID cur = GetBlock((int)x, (int)y, (int)z);
+	float minY, maxY;
+	if (canPassThrough(cur)) return false;
+
+	minY = Math_Floor(y) + Blocks.MinBB[cur].y;
+	maxY = Math_Floor(y) + Blocks.MaxBB[cur].y;
+	return y >= minY && y < maxY && CollidesHor(x, z, cur);
+}
 
-	return !canPassThrough(cur) && p->nextPos.y >= minY && p->nextPos.y < maxY && CollidesHor(&p->nextPos, cur);
+/* Checks whether particles are stuck inside a block, and if so marks them as expired */
+static void ParticleList_CheckInside(struct ParticleList* l, CanPassThroughFunc canPassThrough) {
+	int i;
+	for (i = 0; i < l->count; i++)
+	{
+		if (IntersectsBlock(l, i, canPassThrough)) l->lifetime[i] = -1.0f;
+	}
 }
 
-static cc_bool PhysicsTick(struct Particle* p, float gravity, CanPassThroughFunc canPassThrough, float delta) {
-	Vec3 velocity;
-	int y, begY, endY;
+/* Applies gravity and velocity to all particles */
+static void ParticleList_Integrate(struct ParticleList* l, float delta) {
+	float* CC_RESTRICT lastX = l->lastX; float* CC_RESTRICT nextX = l->nextX; float* CC_RESTRICT velX = l->velX;
+	float* CC_RESTRICT lastY = l->lastY; float* CC_RESTRICT nextY = l->nextY; float* CC_RESTRICT velY = l->velY;
+	float* CC_RESTRICT lastZ = l->lastZ; float* CC_RESTRICT nextZ = l->nextZ; float* CC_RESTRICT velZ = l->velZ;
+	float* CC_RESTRICT lifetime = l->lifetime;
+	float* CC_RESTRICT gravity  = l->gravity;
+	float scale = delta * 3.0f;
+	int i, count = l->count;
 
-	p->lastPos = p->nextPos;
-	if (IntersectsBlock(p, canPassThrough)) return true;
+	for (i = 0; i < count; i++)
+	{
+		lastX[i] = nextX[i]; lastY[i] = nextY[i]; lastZ[i] = nextZ[i];
+		velY[i] -= gravity[i] * delta;
 
-	p->velocity.y -= gravity * delta;
-	begY = Math_Floor(p->nextPos.y);
-	
-	Vec3_Mul1(&velocity, &p->velocity, delta * 3.0f);
-	Vec3_Add(&p->nextPos, &p->nextPos, &velocity);
-	endY = Math_Floor(p->nextPos.y);
+		nextX[i] += velX[i] * scale;
+		nextY[i] += velY[i] * scale;
+		nextZ[i] += velZ[i] * scale;
+		lifetime[i] -= delta;
+	}
+}
+
+/* Clips the particle against blocks it moved through vertically during this tick */
+/* Returns whether the particle collided with any blocks */
+static cc_bool ParticleList_Collide(struct ParticleList* l, int i, CanPassThroughFunc canPassThrough) {
+	/* lastY is where the particle was before being moved in ParticleList_Integrate */
+	int y, begY = Math_Floor(l->lastY[i]), endY = Math_Floor(l->nextY[i]);
+	hitTerrain = false;
 
-	if (p->velocity.y > 0.0f) {
+	if (l->velY[i] > 0.0f) {
 		/* don't test block we are already in */
-		for (y = begY + 1; y <= endY && ClipY(p, y, false, canPassThrough); y++) {}
+		for (y = begY + 1; y <= endY && ClipY(l, i, y, false, canPassThrough); y++) {}
 	} else {
-		for (y = begY; y >= endY && ClipY(p, y, true, canPassThrough); y--) {}
+		for (y = begY; y >= endY && ClipY(l, i, y, true, canPassThrough); y--) {}
 	}
-
-	p->lifetime -= delta;
-	return p->lifetime < 0.0f;
+	return hitTerrain;
 }
 
 
 /*########################################################################################################################*
 *-------------------------------------------------------Rain particle-----------------------------------------------------*
 *#########################################################################################################################*/
-static struct Particle rain_Particles[PARTICLES_MAX];
-static int rain_count;
+static struct ParticleList rain_list;
 static TextureRec rain_rec = { 2.0f/128.0f, 14.0f/128.0f, 5.0f/128.0f, 16.0f/128.0f };
 
 static cc_bool RainParticle_CanPass(BlockID block) {
@@ -140,19 +252,14 @@ static cc_bool RainParticle_CanPass(BlockID block) {
 	return draw == DRAW_GAS || draw == DRAW_SPRITE;
 }
 
-static cc_bool RainParticle_Tick(struct Particle* p, float delta) {
-	hitTerrain = false;
-	return PhysicsTick(p, 3.5f, RainParticle_CanPass, delta) || hitTerrain;
-}
-
-static void RainParticle_Render(struct Particle* p, float t, struct VertexTextured* vertices) {
+static void RainParticle_Render(int i, float t, struct VertexTextured* vertices) {
 	Vec3 pos;
 	Vec2 size;
 	PackedCol col;
 	int x, y, z;
 
-	Vec3_Lerp(&pos, &p->lastPos, &p->nextPos, t);
-	size.x = p->size * 0.015625f; size.y = size.x;
+	ParticleList_GetPos(&rain_list, i, t, &pos);
+	size.x = rain_list.size[i] * 0.015625f; size.y = size.x;
 
 	x = Math_Floor(pos.x); y = Math_Floor(pos.y); z = Math_Floor(pos.z);
 	col = Lighting.Color(x, y, z);
@@ -161,58 +268,67 @@ static void RainParticle_Render(struct Particle* p, float t, struct VertexTextur
 
 static void Rain_Render(float t) {
 	struct VertexTextured* data;
-	int i;
-	if (!rain_count) return;
-	
-	data = (struct VertexTextured*)Gfx_LockDynamicVb(particles_VB, 
-										VERTEX_FORMAT_TEXTURED, rain_count * 4);
-	for (i = 0; i < rain_count; i++) {
-		RainParticle_Render(&rain_Particles[i], t, data);
-		data += 4;
-	}
-
+	int i, j, count;
+	if (!rain_list.count) return;
 	Gfx_BindTexture(particles_TexId);
-	Gfx_UnlockDynamicVb(particles_VB);
-	Gfx_DrawVb_IndexedTris(rain_count * 4);
+
+	for (i = 0; i < rain_list.count; i += count) 
+	{
+		count = min(rain_list.count - i, PARTICLES_MAX_BATCH);
+		data  = (struct VertexTextured*)Gfx_LockDynamicVb(particles_VB, 
+											VERTEX_FORMAT_TEXTURED, count * 4);
+		for (j = i; j < i + count; j++) {
+			RainParticle_Render(j, t, data);
+			data += 4;
+		}
+
+		Gfx_UnlockDynamicVb(particles_VB);
+		Gfx_DrawVb_IndexedTris(count * 4);
+	}
 }
 
 static void Rain_RemoveAt(int i) {
-	for (; i < rain_count - 1; i++) {
-		rain_Particles[i] = rain_Particles[i + 1];
-	}
-	rain_count--;
+	int last = --rain_list.count;
+	if (i != last) ParticleList_SwapRemove(&rain_list, i, last);
 }
 
 static void Rain_Tick(float delta) {
+	struct ParticleList* l = &rain_list;
 	int i;
-	for (i = 0; i < rain_count; i++) {
-		if (RainParticle_Tick(&rain_Particles[i], delta)) {
-			Rain_RemoveAt(i); i--;
-		}
+	ParticleList_CheckInside(l, RainParticle_CanPass);
+	ParticleList_Integrate(l, delta);
+
+	for (i = 0; i < l->count; i++) 
+	{
+		/* Rain particles disappear as soon as they hit the ground */
+		if (l->lifetime[i] >= 0.0f && !ParticleList_Collide(l, i, RainParticle_CanPass)) continue;
+		Rain_RemoveAt(i); i--;
 	}
 }
 
 void Particles_RainSnowEffect(float x, float y, float z) {
-	struct Particle* p;
-	int i, type;
+	struct ParticleList* l = &rain_list;
+	int i, j, type;
+	if (!ParticleList_Alloc(l)) return;
 
 	for (i = 0; i < 2; i++) {
-		if (rain_count == PARTICLES_MAX) Rain_RemoveAt(0);
-		p = &rain_Particles[rain_count++];
+		if (ParticleList_Full(l)) Rain_RemoveAt(0);
+		j = l->count++;
 
-		p->velocity.x = Random_Float(&rnd) * 0.8f - 0.4f; /* [-0.4, 0.4] */
-		p->velocity.z = Random_Float(&rnd) * 0.8f - 0.4f;
-		p->velocity.y = Random_Float(&rnd) + 0.4f;
+		l->velX[j] = Random_Float(&rnd) * 0.8f - 0.4f; /* [-0.4, 0.4] */
+		l->velZ[j] = Random_Float(&rnd) * 0.8f - 0.4f;
+		l->velY[j] = Random_Float(&rnd) + 0.4f;
 
-		p->lastPos.x = x + Random_Float(&rnd); /* [0.0, 1.0] */
-		p->lastPos.y = y + Random_Float(&rnd) * 0.1f + 0.01f;
-		p->lastPos.z = z + Random_Float(&rnd);
+		ParticleList_Spawn(l, j, 
+			x + Random_Float(&rnd), /* [0.0, 1.0] */
+			y + Random_Float(&rnd) * 0.1f + 0.01f,
+			z + Random_Float(&rnd));
 
-		p->nextPos  = p->lastPos;
-		p->lifetime = 40.0f;
+		l->lifetime[j] = 40.0f;
+		l->gravity[j]  = 3.5f;
 
 		type = Random_Next(&rnd, 30);
-		p->size = type >= 28 ? 2 : (type >= 25 ? 4 : 3);
+		l->size[j] = type >= 28 ? 2 : (type >= 25 ? 4 : 3);
 	}
 }
 
@@ -220,54 +336,50 @@ void Particles_RainSnowEffect(float x, float y, float z) {
 /*########################################################################################################################*
 *------------------------------------------------------Terrain particle---------------------------------------------------*
 *#########################################################################################################################*/
-struct TerrainParticle {
-	struct Particle base;
+struct TerrainParticleInfo {
 	TextureRec rec;
 	TextureLoc texLoc;
 	BlockID block;
 };
 
-static struct TerrainParticle terrain_particles[PARTICLES_MAX];
-static int terrain_count;
-static cc_uint16 terrain_1DCount[ATLAS1D_MAX_ATLASES];
-static cc_uint16 terrain_1DIndices[ATLAS1D_MAX_ATLASES];
+static struct ParticleList terrain_list;
+static struct TerrainParticleInfo* terrain_info;
+static int terrain_1DCount[ATLAS1D_MAX_ATLASES];
+static int terrain_1DIndices[ATLAS1D_MAX_ATLASES];
 
 static cc_bool TerrainParticle_CanPass(BlockID block) {
 	cc_uint8 draw = Blocks.Draw[block];
 	return draw == DRAW_GAS || draw == DRAW_SPRITE || Blocks.IsLiquid[block];
 }
 
-static cc_bool TerrainParticle_Tick(struct TerrainParticle* p, float delta) {
-	return PhysicsTick(&p->base, Blocks.ParticleGravity[p->block], TerrainParticle_CanPass, delta);
-}
-
-static void TerrainParticle_Render(struct TerrainParticle* p, float t, struct VertexTextured* vertices) {
+static void TerrainParticle_Render(int i, float t, struct VertexTextured* vertices) {
+	struct TerrainParticleInfo* info = &terrain_info[i];
 	PackedCol col = PACKEDCOL_WHITE;
 	Vec3 pos;
 	Vec2 size;
 	int x, y, z;
 
-	Vec3_Lerp(&pos, &p->base.lastPos, &p->base.nextPos, t);
-	size.x = p->base.size * 0.015625f; size.y = size.x;
+	ParticleList_GetPos(&terrain_list, i, t, &pos);
+	size.x = terrain_list.size[i] * 0.015625f; size.y = size.x;
 	
-	if (!Blocks.Brightness[p->block]) {
+	if (!Blocks.Brightness[info->block]) {
 		x = Math_Floor(pos.x); y = Math_Floor(pos.y); z = Math_Floor(pos.z);
 		col = Lighting.Color_XSide(x, y, z);
 	}
 
-	Block_Tint(col, p->block);
-	Particle_DoRender(&size, &pos, &p->rec, col, vertices);
+	Block_Tint(col, info->block);
+	Particle_DoRender(&size, &pos, &info->rec, col, vertices);
 }
 
-static void Terrain_Update1DCounts(void) {
+static void Terrain_Update1DCounts(int beg, int end) {
 	int i, index;
 
 	for (i = 0; i < ATLAS1D_MAX_ATLASES; i++) {
 		terrain_1DCount[i]   = 0;
 		terrain_1DIndices[i] = 0;
 	}
-	for (i = 0; i < terrain_count; i++) {
-		index = Atlas1D_Index(terrain_particles[i].texLoc);
+	for (i = beg; i < end; i++) {
+		index = Atlas1D_Index(terrain_info[i].texLoc);
 		terrain_1DCount[index] += 4;
 	}
 	for (i = 1; i < Atlas1D.Count; i++) {
@@ -275,22 +387,21 @@ static void Terrain_Update1DCounts(void) {
 	}
 }
 
-static void Terrain_Render(float t) {
+static void Terrain_RenderBatch(int beg, int count, float t) {
 	struct VertexTextured* data;
 	struct VertexTextured* ptr;
-	int offset = 0;
+	int offset = 0, end = beg + count;
 	int i, index;
-	if (!terrain_count) return;
 
 	data = (struct VertexTextured*)Gfx_LockDynamicVb(particles_VB, 
-										VERTEX_FORMAT_TEXTURED, terrain_count * 4);
-	Terrain_Update1DCounts();
-	for (i = 0; i < terrain_count; i++) 
+										VERTEX_FORMAT_TEXTURED, count * 4);
+	Terrain_Update1DCounts(beg, end);
+	for (i = beg; i < end; i++) 
 	{
-		index = Atlas1D_Index(terrain_particles[i].texLoc);
+		index = Atlas1D_Index(terrain_info[i].texLoc);
 		ptr   = data + terrain_1DIndices[index];
 
-		TerrainParticle_Render(&terrain_particles[i], t, ptr);
+		TerrainParticle_Render(i, t, ptr);
 		terrain_1DIndices[index] += 4;
 	}
 
@@ -306,26 +417,49 @@ static void Terrain_Render(float t) {
 	}
 }
 
-static void Terrain_RemoveAt(int i) {
-	for (; i < terrain_count - 1; i++) 
+static void Terrain_Render(float t) {
+	int i, count;
+	for (i = 0; i < terrain_list.count; i += count) 
 	{
-		terrain_particles[i] = terrain_particles[i + 1];
+		count = min(terrain_list.count - i, PARTICLES_MAX_BATCH);
+		Terrain_RenderBatch(i, count, t);
 	}
-	terrain_count--;
+}
+
+static void Terrain_RemoveAt(int i) {
+	int last = --terrain_list.count;
+	if (i == last) return;
+
+	ParticleList_SwapRemove(&terrain_list, i, last);
+	terrain_info[i] = terrain_info[last];
 }
 
 static void Terrain_Tick(float delta) {
+	struct ParticleList* l = &terrain_list;
 	int i;
-	for (i = 0; i < terrain_count; i++) 
+	ParticleList_CheckInside(l, TerrainParticle_CanPass);
+	ParticleList_Integrate(l, delta);
+
+	for (i = 0; i < l->count; i++) 
 	{
-		if (TerrainParticle_Tick(&terrain_particles[i], delta)) {
-			Terrain_RemoveAt(i); i--;
+		if (l->lifetime[i] >= 0.0f) {
+			ParticleList_Collide(l, i, TerrainParticle_CanPass); continue;
 		}
+		Terrain_RemoveAt(i); i--;
+	}
+}
+
+static cc_bool Terrain_Alloc(void) {
+	if (!terrain_info) {
+		terrain_info = (struct TerrainParticleInfo*)Mem_TryAlloc(particles_max, sizeof(struct TerrainParticleInfo));
+		if (!terrain_info) return false;
 	}
+	return ParticleList_Alloc(&terrain_list);
 }
 
 void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
-	struct TerrainParticle* p;
+	struct ParticleList* l = &terrain_list;
+	struct TerrainParticleInfo* info;
 	TextureLoc loc;
 	int texIndex;
 	TextureRec baseRec, rec;
@@ -340,9 +474,10 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 	/* per-particle variables */
 	float cellX, cellY, cellZ;
 	Vec3 cell;
-	int x, y, z, type;
+	int x, y, z, i, type;
 
 	if (now != BLOCK_AIR || Blocks.Draw[old] == DRAW_GAS) return;
+	if (!Terrain_Alloc()) return;
 	IVec3_ToVec3(&origin, &coords);
 	loc = Block_Tex(old, FACE_XMIN);
 	
@@ -375,13 +510,14 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 				if (cell.x < minBB.x || cell.x > maxBB.x || cell.y < minBB.y
 					|| cell.y > maxBB.y || cell.z < minBB.z || cell.z > maxBB.z) continue;
 
-				if (terrain_count == PARTICLES_MAX) Terrain_RemoveAt(0);
-				p = &terrain_particles[terrain_count++];
+				if (ParticleList_Full(l)) Terrain_RemoveAt(0);
+				i    = l->count++;
+				info = &terrain_info[i];
 
 				/* centre random offset around [-0.2, 0.2] */
-				p->base.velocity.x = CELL_CENTRE + (cellX - 0.5f) + (Random_Float(&rnd) * 0.4f - 0.2f);
-				p->base.velocity.y = CELL_CENTRE + (cellY - 0.0f) + (Random_Float(&rnd) * 0.4f - 0.2f);
-				p->base.velocity.z = CELL_CENTRE + (cellZ - 0.5f) + (Random_Float(&rnd) * 0.4f - 0.2f);
+				l->velX[i] = CELL_CENTRE + (cellX - 0.5f) + (Random_Float(&rnd) * 0.4f - 0.2f);
+				l->velY[i] = CELL_CENTRE + (cellY - 0.0f) + (Random_Float(&rnd) * 0.4f - 0.2f);
+				l->velZ[i] = CELL_CENTRE + (cellZ - 0.5f) + (Random_Float(&rnd) * 0.4f - 0.2f);
 
 				rec = baseRec;
 				rec.u1 = baseRec.u1 + Random_Range(&rnd, minU, maxUsedU) * uScale;
@@ -391,15 +527,15 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 				rec.u2 = min(rec.u2, maxU2) - 0.01f * uScale;
 				rec.v2 = min(rec.v2, maxV2) - 0.01f * vScale;
 		
-				Vec3_Add(&p->base.lastPos, &origin, &cell);
-				p->base.nextPos  = p->base.lastPos;
-				p->base.lifetime = 0.3f + Random_Float(&rnd) * 1.2f;
+				ParticleList_Spawn(l, i, origin.x + cell.x, origin.y + cell.y, origin.z + cell.z);
+				l->lifetime[i] = 0.3f + Random_Float(&rnd) * 1.2f;
+				l->gravity[i]  = Blocks.ParticleGravity[old];
 
-				p->rec    = rec;
-				p->texLoc = loc;
-				p->block  = old;
+				info->rec    = rec;
+				info->texLoc = loc;
+				info->block  = old;
 				type = Random_Next(&rnd, 30);
-				p->base.size = type >= 28 ? 12 : (type >= 25 ? 10 : 8);
+				l->size[i] = type >= 28 ? 12 : (type >= 25 ? 10 : 8);
 			}
 		}
 	}
@@ -410,15 +546,14 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 *-------------------------------------------------------Custom particle---------------------------------------------------*
 *#########################################################################################################################*/
 #ifdef CC_BUILD_NETWORKING
-struct CustomParticle {
-	struct Particle base;
+struct CustomParticleInfo {
 	int effectId;
 	float totalLifespan;
 };
 
 struct CustomParticleEffect Particles_CustomEffects[256];
-static struct CustomParticle custom_particles[PARTICLES_MAX];
-static int custom_count;
+static struct ParticleList custom_list;
+static struct CustomParticleInfo* custom_info;
 static cc_uint8 collideFlags;
 #define EXPIRES_UPON_TOUCHING_GROUND (1 << 0)
 #define SOLID_COLLIDES  (1 << 1)
@@ -437,32 +572,24 @@ static cc_bool CustomParticle_CanPass(BlockID block) {
 	return true;
 }
 
-static cc_bool CustomParticle_Tick(struct CustomParticle* p, float delta) {
-	struct CustomParticleEffect* e = &Particles_CustomEffects[p->effectId];
-	hitTerrain   = false;
-	collideFlags = e->collideFlags;
-
-	return PhysicsTick(&p->base, e->gravity, CustomParticle_CanPass, delta)
-		|| (hitTerrain && (e->collideFlags & EXPIRES_UPON_TOUCHING_GROUND));
-}
-
-static void CustomParticle_Render(struct CustomParticle* p, float t, struct VertexTextured* vertices) {
-	struct CustomParticleEffect* e = &Particles_CustomEffects[p->effectId];
+static void CustomParticle_Render(int i, float t, struct VertexTextured* vertices) {
+	struct CustomParticleInfo* info = &custom_info[i];
+	struct CustomParticleEffect* e  = &Particles_CustomEffects[info->effectId];
 	Vec3 pos;
 	Vec2 size;
 	PackedCol col;
 	TextureRec rec = e->rec;
 	int x, y, z;
 
-	float time_lived = p->totalLifespan - p->base.lifetime;
-	int curFrame = Math_Floor(e->frameCount * (time_lived / p->totalLifespan));
+	float time_lived = info->totalLifespan - custom_list.lifetime[i];
+	int curFrame = Math_Floor(e->frameCount * (time_lived / info->totalLifespan));
 	float shiftU = curFrame * (rec.u2 - rec.u1);
 
 	rec.u1 += shiftU;/* * 0.0078125f; */
 	rec.u2 += shiftU;/* * 0.0078125f; */
 
-	Vec3_Lerp(&pos, &p->base.lastPos, &p->base.nextPos, t);
-	size.x = p->base.size; size.y = size.x;
+	ParticleList_GetPos(&custom_list, i, t, &pos);
+	size.x = custom_list.size[i]; size.y = size.x;
 
 	x = Math_Floor(pos.x); y = Math_Floor(pos.y); z = Math_Floor(pos.z);
 	col = e->fullBright ? PACKEDCOL_WHITE : Lighting.Color(x, y, z);
@@ -473,51 +600,81 @@ static void CustomParticle_Render(struct CustomParticle* p, float t, struct Vert
 
 static void Custom_Render(float t) {
 	struct VertexTextured* data;
-	int i;
-	if (!custom_count) return;
+	int i, j, count;
+	if (!custom_list.count) return;
+	Gfx_BindTexture(particles_TexId);
 
-	data = (struct VertexTextured*)Gfx_LockDynamicVb(particles_VB, 
-										VERTEX_FORMAT_TEXTURED, custom_count * 4);
-	for (i = 0; i < custom_count; i++) {
-		CustomParticle_Render(&custom_particles[i], t, data);
-		data += 4;
-	}
+	for (i = 0; i < custom_list.count; i += count) 
+	{
+		count = min(custom_list.count - i, PARTICLES_MAX_BATCH);
+		data  = (struct VertexTextured*)Gfx_LockDynamicVb(particles_VB, 
+											VERTEX_FORMAT_TEXTURED, count * 4);
+		for (j = i; j < i + count; j++) {
+			CustomParticle_Render(j, t, data);
+			data += 4;
+		}
 
-	Gfx_BindTexture(particles_TexId);
-	Gfx_UnlockDynamicVb(particles_VB);
-	Gfx_DrawVb_IndexedTris(custom_count * 4);
+		Gfx_UnlockDynamicVb(particles_VB);
+		Gfx_DrawVb_IndexedTris(count * 4);
+	}
 }
 
 static void Custom_RemoveAt(int i) {
-	for (; i < custom_count - 1; i++) {
-		custom_particles[i] = custom_particles[i + 1];
-	}
-	custom_count--;
+	int last = --custom_list.count;
+	if (i == last) return;
+
+	ParticleList_SwapRemove(&custom_list, i, last);
+	custom_info[i] = custom_info[last];
 }
 
 static void Custom_Tick(float delta) {
+	struct ParticleList* l = &custom_list;
+	struct CustomParticleEffect* e;
 	int i;
-	for (i = 0; i < custom_count; i++) {
-		if (CustomParticle_Tick(&custom_particles[i], delta)) {
-			Custom_RemoveAt(i); i--;
+
+	for (i = 0; i < l->count; i++) 
+	{
+		collideFlags = Particles_CustomEffects[custom_info[i].effectId].collideFlags;
+		if (IntersectsBlock(l, i, CustomParticle_CanPass)) l->lifetime[i] = -1.0f;
+	}
+	ParticleList_Integrate(l, delta);
+
+	for (i = 0; i < l->count; i++) 
+	{
+		if (l->lifetime[i] >= 0.0f) {
+			e = &Particles_CustomEffects[custom_info[i].effectId];
+			collideFlags = e->collideFlags;
+
+			if (!ParticleList_Collide(l, i, CustomParticle_CanPass)) continue;
+			if (!(e->collideFlags & EXPIRES_UPON_TOUCHING_GROUND))   continue;
 		}
+		Custom_RemoveAt(i); i--;
+	}
+}
+
+static cc_bool Custom_Alloc(void) {
+	if (!custom_info) {
+		custom_info = (struct CustomParticleInfo*)Mem_TryAlloc(particles_max, sizeof(struct CustomParticleInfo));
+		if (!custom_info) return false;
 	}
+	return ParticleList_Alloc(&custom_list);
 }
 
 void Particles_CustomEffect(int effectID, float x, float y, float z, float originX, float originY, float originZ) {
-	struct CustomParticle* p;
+	struct ParticleList* l = &custom_list;
 	struct CustomParticleEffect* e = &Particles_CustomEffects[effectID];
-	int i, count = e->particleCount;
+	int i, j, count = e->particleCount;
 	Vec3 offset, delta, origin;
 	float d;
 
+	if (!Custom_Alloc()) return;
 	origin.x = originX; origin.y = originY; origin.z = originZ;
 
 	for (i = 0; i < count; i++) 
 	{
-		if (custom_count == PARTICLES_MAX) Custom_RemoveAt(0);
-		p = &custom_particles[custom_count++];
-		p->effectId = effectID;
+		if (ParticleList_Full(l)) Custom_RemoveAt(0);
+		j = l->count++;
+		custom_info[j].effectId = effectID;
 
 		offset.x = Random_Float(&rnd) - 0.5f;
 		offset.y = Random_Float(&rnd) - 0.5f;
@@ -530,34 +687,40 @@ void Particles_CustomEffect(int effectID, float x, float y, float z, float origi
 		d  = Math_Exp2(Math_Log2(d) / 3.0); /* d^1/3 for better distribution */
 		d *= e->spread;
 
-		p->base.lastPos.x = x + offset.x * d;
-		p->base.lastPos.y = y + offset.y * d;
-		p->base.lastPos.z = z + offset.z * d;
-		
-		Vec3_Sub(&delta, &p->base.lastPos, &origin);
+		ParticleList_Spawn(l, j, x + offset.x * d, y + offset.y * d, z + offset.z * d);
+		delta.x = l->lastX[j] - origin.x;
+		delta.y = l->lastY[j] - origin.y;
+		delta.z = l->lastZ[j] - origin.z;
 		Vec3_Normalise(&delta);
 
-		p->base.velocity.x = delta.x * e->speed;
-		p->base.velocity.y = delta.y * e->speed;
-		p->base.velocity.z = delta.z * e->speed;
+		l->velX[j] = delta.x * e->speed;
+		l->velY[j] = delta.y * e->speed;
+		l->velZ[j] = delta.z * e->speed;
 
-		p->base.nextPos  = p->base.lastPos;
-		p->base.lifetime = e->baseLifetime + (e->baseLifetime * e->lifetimeVariation) * ((Random_Float(&rnd) - 0.5f) * 2);
-		p->totalLifespan = p->base.lifetime;
+		l->lifetime[j] = e->baseLifetime + (e->baseLifetime * e->lifetimeVariation) * ((Random_Float(&rnd) - 0.5f) * 2);
+		l->gravity[j]  = e->gravity;
+		custom_info[j].totalLifespan = l->lifetime[j];
 
-		p->base.size = e->size + (e->size * e->sizeVariation) * ((Random_Float(&rnd) - 0.5f) * 2);
+		l->size[j] = e->size + (e->size * e->sizeVariation) * ((Random_Float(&rnd) - 0.5f) * 2);
 
 		/* Don't spawn custom particle inside a block (otherwise it appears */
 		/*   for a few frames, then disappears in first PhysicsTick call)*/
 		collideFlags = e->collideFlags;
-		if (IntersectsBlock(&p->base, CustomParticle_CanPass)) custom_count--;
+		if (IntersectsBlock(l, j, CustomParticle_CanPass)) l->count--;
 	}
 }
+
+static void Custom_Free(void) {
+	ParticleList_Free(&custom_list);
+	Mem_Free(custom_info);
+	custom_info = NULL;
+}
 #else
-static int custom_count;
+static struct ParticleList custom_list;
 
 static void Custom_Render(float t) { }
 static void Custom_Tick(float delta) { }
+static void Custom_Free(void) { }
 #endif
 
 
@@ -565,11 +728,11 @@ static void Custom_Tick(float delta) { }
 *--------------------------------------------------------Particles--------------------------------------------------------*
 *#########################################################################################################################*/
 void Particles_Render(float t) {
-	if (!terrain_count && !rain_count && !custom_count) return;
+	if (!terrain_list.count && !rain_list.count && !custom_list.count) return;
 
 	if (Gfx.LostContext) return;
 	if (!particles_VB)
-		particles_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, PARTICLES_MAX * 4);
+		particles_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, min(particles_max, PARTICLES_MAX_BATCH) * 4);
 
 	Gfx_SetAlphaTest(true);
 
@@ -583,6 +746,9 @@ void Particles_Render(float t) {
 
 static void Particles_Tick(struct ScheduledTask* task) {
 	float delta = task->interval;
+	/* Invalidate cached block lookups from the previous tick */
+	cell_tick++;
+
 	Terrain_Tick(delta);
 	Rain_Tick(delta);
 	Custom_Tick(delta);
@@ -613,14 +779,23 @@ static void OnInit(void) {
 	ScheduledTask_Add(GAME_DEF_TICKS, Particles_Tick);
 	Random_SeedFromCurrentTime(&rnd);
 	TextureEntry_Register(&particles_entry);
+	particles_max   = Options_GetInt(OPT_MAX_PARTICLES, 10, 65536, PARTICLES_DEF_MAX);
+	particles_limit = particles_max;
 
 	Event_Register_(&UserEvents.BlockChanged, NULL, OnBreakBlockEffect_Handler);
 	Event_Register_(&GfxEvents.ContextLost,   NULL, OnContextLost);
 }
 
-static void OnFree(void) { OnContextLost(NULL); }
+static void OnFree(void) {
+	OnContextLost(NULL);
+	ParticleList_Free(&rain_list);
+	ParticleList_Free(&terrain_list);
+	Mem_Free(terrain_info);
+	terrain_info = NULL;
+	Custom_Free();
+}
 
-static void OnReset(void) { rain_count = 0; terrain_count = 0; custom_count = 0; }
+static void OnReset(void) { rain_list.count = 0; terrain_list.count = 0; custom_list.count = 0; }
 
 struct IGameComponent Particles_Component = {
 	OnInit,  /* Init  */
@@ -45,6 +45,8 @@ void Particles_Render(float t);
 void Particles_BreakBlockEffect(IVec3 coords, BlockID oldBlock, BlockID block);
 void Particles_RainSnowEffect(float x, float y, float z);
 void Particles_CustomEffect(int effectID, float x, float y, float z, float originX, float originY, float originZ);
+/* Limits the number of active particles to a percentage of the maximum set by the user */
+void Particles_ScaleLimit(int percent);
 
 CC_END_HEADER
 #endif
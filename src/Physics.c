@@ -149,16 +149,155 @@ static void Searcher_QuickSort(int left, int right) {
 	}
 }
 
+/* Insertion sort is much faster than quicksort for the small number of blocks usually found */
+static void Searcher_InsertionSort(int count) {
+	struct SearcherState* keys = Searcher_States; struct SearcherState key;
+	int i, j;
+
+	for (i = 1; i < count; i++)
+	{
+		key = keys[i];
+		for (j = i - 1; j >= 0 && keys[j].tSquared > key.tSquared; j--)
+		{
+			keys[j + 1] = keys[j];
+		}
+		keys[j + 1] = key;
+	}
+}
+
+/* Adds the given block as a collision candidate, if the entity could reach it this tick */
+static cc_bool Searcher_TryAdd(struct SearcherState* state, int x, int y, int z, BlockID block, 
+							Vec3* vel, struct AABB* entityBB, struct AABB* entityExtentBB) {
+	struct AABB blockBB;
+	float xx, yy, zz, tx, ty, tz;
+
+	xx = (float)x; yy = (float)y; zz = (float)z;
+	blockBB.Min = Blocks.MinBB[block];
+	blockBB.Min.x += xx; blockBB.Min.y += yy; blockBB.Min.z += zz;
+	blockBB.Max = Blocks.MaxBB[block];
+	blockBB.Max.x += xx; blockBB.Max.y += yy; blockBB.Max.z += zz;
+
+	if (!AABB_Intersects(entityExtentBB, &blockBB)) return false; /* necessary for non whole blocks. (slabs) */
+	Searcher_CalcTime(vel, entityBB, &blockBB, &tx, &ty, &tz);
+	if (tx > 1.0f || ty > 1.0f || tz > 1.0f) return false;
+
+	state->x = (x << 3) | (block  & 0x007);
+	state->y = (y << 4) | ((block & 0x078) >> 3);
+	state->z = (z << 3) | ((block & 0x380) >> 7);
+	state->tSquared = tx * tx + ty * ty + tz * tz;
+	return true;
+}
+
+
+/*########################################################################################################################*
+*---------------------------------------------------Collisions broadphase-------------------------------------------------*
+*#########################################################################################################################*/
+/* Entities usually stay within the same few blocks for several ticks, so the solid blocks around */
+/*  an entity are cached to avoid having to look up every block in its reachable area each tick */
+/* Cached blocks are stored in the same packed coordinates format as SearcherState */
+#define SEARCHER_CACHE_ENTRIES  4
+#define SEARCHER_CACHE_BLOCKS   128
+#define SEARCHER_CACHE_PADDING  1
+#define SEARCHER_CACHE_MAX_AREA 1024
+
+struct SearcherCacheEntry {
+	struct Entity* entity;
+	IVec3 min, max;
+	int count;
+	struct SearcherState blocks[SEARCHER_CACHE_BLOCKS];
+};
+static struct SearcherCacheEntry searcher_cache[SEARCHER_CACHE_ENTRIES];
+static int searcher_nextEntry;
+
+static cc_bool Searcher_CacheContains(struct SearcherCacheEntry* entry, const IVec3* min, const IVec3* max) {
+	return min->x >= entry->min.x && min->y >= entry->min.y && min->z >= entry->min.z
+		&& max->x <= entry->max.x && max->y <= entry->max.y && max->z <= entry->max.z;
+}
+
+static cc_bool Searcher_FillCache(struct SearcherCacheEntry* entry, const IVec3* min, const IVec3* max) {
+	struct SearcherState* cur = entry->blocks;
+	BlockID block;
+	int x, y, z;
+
+	entry->min.x = min->x - SEARCHER_CACHE_PADDING; entry->max.x = max->x + SEARCHER_CACHE_PADDING;
+	entry->min.y = min->y - SEARCHER_CACHE_PADDING; entry->max.y = max->y + SEARCHER_CACHE_PADDING;
+	entry->min.z = min->z - SEARCHER_CACHE_PADDING; entry->max.z = max->z + SEARCHER_CACHE_PADDING;
+	entry->count = 0;
+
+	for (y = entry->min.y; y <= entry->max.y; y++) {
+		for (z = entry->min.z; z <= entry->max.z; z++) {
+			for (x = entry->min.x; x <= entry->max.x; x++) {
+				block = World_GetPhysicsBlock(x, y, z);
+				if (Blocks.Collide[block] != COLLIDE_SOLID) continue;
+
+				/* Too many solid blocks nearby to cache */
+				if (entry->count == SEARCHER_CACHE_BLOCKS) { entry->entity = NULL; return false; }
+				cur->x = (x << 3) | (block  & 0x007);
+				cur->y = (y << 4) | ((block & 0x078) >> 3);
+				cur->z = (z << 3) | ((block & 0x380) >> 7);
+				cur++; entry->count++;
+			}
+		}
+	}
+	return true;
+}
+
+/* Returns the cached solid blocks covering the given area for the given entity, or NULL if not cacheable */
+static struct SearcherCacheEntry* Searcher_GetCached(struct Entity* e, const IVec3* min, const IVec3* max) {
+	struct SearcherCacheEntry* entry = NULL;
+	int i, area;
+
+	for (i = 0; i < SEARCHER_CACHE_ENTRIES; i++) 
+	{
+		if (searcher_cache[i].entity != e) continue;
+		entry = &searcher_cache[i]; break;
+	}
+	if (entry && Searcher_CacheContains(entry, min, max)) return entry;
+
+	area = (max->x - min->x + 1 + SEARCHER_CACHE_PADDING * 2) * (max->y - min->y + 1 + SEARCHER_CACHE_PADDING * 2)
+		* (max->z - min->z + 1 + SEARCHER_CACHE_PADDING * 2);
+	if (area > SEARCHER_CACHE_MAX_AREA) return NULL;
+
+	if (!entry) {
+		entry = &searcher_cache[searcher_nextEntry];
+		searcher_nextEntry = (searcher_nextEntry + 1) % SEARCHER_CACHE_ENTRIES;
+	}
+	entry->entity = e;
+	return Searcher_FillCache(entry, min, max) ? entry : NULL;
+}
+
+void Searcher_OnBlockChanged(int x, int y, int z) {
+	struct SearcherCacheEntry* entry;
+	int i;
+
+	for (i = 0; i < SEARCHER_CACHE_ENTRIES; i++) 
+	{
+		entry = &searcher_cache[i];
+		if (x < entry->min.x || y < entry->min.y || z < entry->min.z) continue;
+		if (x > entry->max.x || y > entry->max.y || z > entry->max.z) continue;
+		entry->entity = NULL;
+	}
+}
+
+void Searcher_ClearCache(void) {
+	int i;
+	for (i = 0; i < SEARCHER_CACHE_ENTRIES; i++) 
+	{
+		searcher_cache[i].entity = NULL;
+	}
+}
+
+
 int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, struct AABB* entityExtentBB) {
 	Vec3 vel = entity->Velocity;
 	IVec3 min, max;
 	cc_uint32 elements;
 	struct SearcherState* curState;
-	int count;
+	struct SearcherCacheEntry* entry;
+	struct SearcherState state;
+	int i, count;
 
 	BlockID block;
-	struct AABB blockBB;
-	float xx, yy, zz, tx, ty, tz;
 	int x, y, z;
 
 	Entity_GetBounds(entity, entityBB);
@@ -181,35 +320,38 @@ int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, s
 		Searcher_States  = (struct SearcherState*)Mem_Alloc(elements, sizeof(struct SearcherState), "collision search states");
 	}
 	curState = Searcher_States;
+	entry    = Searcher_GetCached(entity, &min, &max);
 
-	/* Order loops so that we minimise cache misses */
-	for (y = min.y; y <= max.y; y++) {
-		for (z = min.z; z <= max.z; z++) {
-			for (x = min.x; x <= max.x; x++) {
-				block = World_GetPhysicsBlock(x, y, z);
-				if (Blocks.Collide[block] != COLLIDE_SOLID) continue;
+	if (entry) {
+		for (i = 0; i < entry->count; i++)
+		{
+			state = entry->blocks[i];
+			x = state.x >> 3; y = state.y >> 4; z = state.z >> 3;
+			if (x < min.x || y < min.y || z < min.z || x > max.x || y > max.y || z > max.z) continue;
 
-				xx = (float)x; yy = (float)y; zz = (float)z;
-				blockBB.Min = Blocks.MinBB[block];
-				blockBB.Min.x += xx; blockBB.Min.y += yy; blockBB.Min.z += zz;
-				blockBB.Max = Blocks.MaxBB[block];
-				blockBB.Max.x += xx; blockBB.Max.y += yy; blockBB.Max.z += zz;
-
-				if (!AABB_Intersects(entityExtentBB, &blockBB)) continue; /* necessary for non whole blocks. (slabs) */
-				Searcher_CalcTime(&vel, entityBB, &blockBB, &tx, &ty, &tz);
-				if (tx > 1.0f || ty > 1.0f || tz > 1.0f) continue;
-
-				curState->x = (x << 3) | (block  & 0x007);
-				curState->y = (y << 4) | ((block & 0x078) >> 3);
-				curState->z = (z << 3) | ((block & 0x380) >> 7);
-				curState->tSquared = tx * tx + ty * ty + tz * tz;
-				curState++;
+			block = (state.x & 0x7) | (state.y & 0xF) << 3 | (state.z & 0x7) << 7;
+			if (Searcher_TryAdd(curState, x, y, z, block, &vel, entityBB, entityExtentBB)) curState++;
+		}
+	} else {
+		/* Order loops so that we minimise cache misses */
+		for (y = min.y; y <= max.y; y++) {
+			for (z = min.z; z <= max.z; z++) {
+				for (x = min.x; x <= max.x; x++) {
+					block = World_GetPhysicsBlock(x, y, z);
+					if (Blocks.Collide[block] != COLLIDE_SOLID) continue;
+
+					if (Searcher_TryAdd(curState, x, y, z, block, &vel, entityBB, entityExtentBB)) curState++;
+				}
 			}
 		}
 	}
 
 	count = (int)(curState - Searcher_States);
-	if (count) Searcher_QuickSort(0, count - 1);
+	if (count <= 16) {
+		Searcher_InsertionSort(count);
+	} else {
+		Searcher_QuickSort(0, count - 1);
+	}
 	return count;
 }
 
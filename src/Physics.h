@@ -40,6 +40,10 @@ extern struct SearcherState* Searcher_States;
 int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, struct AABB* entityExtentBB);
 void Searcher_CalcTime(Vec3* vel, struct AABB *entityBB, struct AABB* blockBB, float* tx, float* ty, float* tz);
 void Searcher_Free(void);
+/* Invalidates cached nearby solid blocks for any entities near the given coordinates */
+void Searcher_OnBlockChanged(int x, int y, int z);
+/* Invalidates cached nearby solid blocks for all entities */
+void Searcher_ClearCache(void);
 
 CC_END_HEADER
 #endif
@@ -297,6 +297,15 @@ int File_Exists(const cc_filepath* path) {
 	return attribs != INVALID_FILE_ATTRIBUTES && !(attribs & FILE_ATTRIBUTE_DIRECTORY);
 }
 
+cc_result File_Delete(const cc_filepath* path) {
+	cc_result res;
+	if (DeleteFileW(path->uni)) return 0;
+	/* Windows 9x does not support W API functions */
+	if ((res = GetLastError()) != ERROR_CALL_NOT_IMPLEMENTED) return res;
+
+	return DeleteFileA(path->ansi) ? 0 : GetLastError();
+}
+
 static cc_result Directory_EnumCore(const cc_string* dirPath, const cc_string* file, DWORD attribs,
 									void* obj, Directory_EnumCallback callback) {
 	cc_string path; char pathBuffer[MAX_PATH + 10];
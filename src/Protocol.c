@@ -46,6 +46,9 @@ static cc_bool map_begunLoading;
 static cc_uint64 map_receiveBeg;
 static struct Stream map_part;
 static int map_volume;
+/* Identity of the map being loaded, as sent by the server */
+static cc_uint8 map_uuid[WORLD_UUID_LEN];
+static cc_bool map_hasUuid;
 
 /*########################################################################################################################*
 *-----------------------------------------------------CPE extensions------------------------------------------------------*
@@ -96,6 +99,7 @@ static struct CpeExt
 	lightingMode_Ext    = { "LightingMode", 1 },
 	cinematicGui_Ext    = { "CinematicGui", 1 },
 	notifyAction_Ext    = { "NotifyAction", 1 },
+	cachedMaps_Ext      = { "CachedMaps", 1 },
 	extTextures_Ext     = { "ExtendedTextures", 1 },
 	extBlocks_Ext       = { "ExtendedBlocks", 1 };
 
@@ -106,6 +110,7 @@ static struct CpeExt* cpe_clientExtensions[] = {
 	&blockDefsExt_Ext, &bulkBlockUpdate_Ext, &textColors_Ext, &envMapAspect_Ext, &entityProperty_Ext, &extEntityPos_Ext,
 	&twoWayPing_Ext, &invOrder_Ext, &instantMOTD_Ext, &fastMap_Ext, &setHotbar_Ext, &setSpawnpoint_Ext, &velControl_Ext,
 	&customParticles_Ext, &pluginMessages_Ext, &extTeleport_Ext, &lightingMode_Ext, &cinematicGui_Ext, &notifyAction_Ext,
+	&cachedMaps_Ext,
 #ifdef CUSTOM_MODELS
 	&customModels_Ext,
 #endif
@@ -276,7 +281,7 @@ static void WoM_CheckMotd(void) {
 
 	/* Ensure that if the user quickly changes to a different world, env settings from old world aren't
 	applied in the new world if the async 'get env request' didn't complete before the old world was unloaded */
-	wom_identifier = Http_AsyncGetData(&url, HTTP_FLAG_PRIORITY);
+	wom_identifier = Http_AsyncGetData(&url, HTTP_FLAG_PRIORITY | HTTP_FLAG_MAP_ENV | HTTP_FLAG_CACHE);
 	wom_sendId = true;
 }
 
@@ -538,6 +543,7 @@ static void Classic_StartLoading(void) {
 	map_begunLoading = true;
 	map_receiveBeg   = Stopwatch_Measure();
 	map_volume       = 0;
+	map_hasUuid      = false;
 
 	MapState_Init(&map1);
 #ifdef EXTENDED_BLOCKS
@@ -550,6 +556,13 @@ static void Classic_LevelInit(cc_uint8* data) {
 	if (map_begunLoading) return;
 
 	Classic_StartLoading();
+
+	/* Cached maps puts identity of the map after the other header fields */
+	if (IsSupported(cachedMaps_Ext)) {
+		static const cc_uint8 noUuid[WORLD_UUID_LEN];
+		Mem_Copy(map_uuid, data + (IsSupported(fastMap_Ext) ? 4 : 0), WORLD_UUID_LEN);
+		map_hasUuid = !Mem_Equal(map_uuid, noUuid, WORLD_UUID_LEN);
+	}
 	if (!IsSupported(fastMap_Ext)) return;
 
 	/* Fast map puts volume in header, and uses raw DEFLATE without GZIP header/footer */
@@ -624,6 +637,9 @@ static void Classic_LevelFinalise(cc_uint8* data) {
 		Chat_AddRaw("&cFailed to load map, try joining a different map");
 		Chat_AddRaw("   &cNot enough free memory to load the map");
 	} else if (!map1.blocks) {
+		/* Server sent no map data at all, to indicate the map is unchanged from when it was last joined */
+		if (map_hasUuid && World_LoadCachedMap(map_uuid, width, height, length)) { FreeMapStates(); return; }
+
 		Chat_AddRaw("&cFailed to load map, try joining a different map");
 		Chat_AddRaw("   &cAttempted to load map without a Blocks array");
 	} else if (map_volume != volume) {
@@ -645,6 +661,9 @@ static void Classic_LevelFinalise(cc_uint8* data) {
 #endif
 	World_SetNewMap(map1.blocks, width, height, length);
 	map1.blocks  = NULL;
+
+	/* So the map can be found in the cache when the server later switches back to it */
+	if (map_hasUuid && World.Blocks) Mem_Copy(World.Uuid, map_uuid, WORLD_UUID_LEN);
 }
 
 static void Classic_SetBlock(cc_uint8* data) {
@@ -1048,6 +1067,8 @@ static void CPE_ExtEntry(cc_uint8* data) {
 		}
 	} else if (ext == &notifyAction_Ext) {
 		Server.SupportsNotifyAction = true;
+	} else if (ext == &cachedMaps_Ext) {
+		Protocol.Sizes[OPCODE_LEVEL_BEGIN] += WORLD_UUID_LEN;
 	}
 #ifdef EXTENDED_TEXTURES
 	else if (ext == &extTextures_Ext) {
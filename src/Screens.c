@@ -117,9 +117,15 @@ static void HUDScreen_RemakeLine1(struct HUDScreen* s) {
 
 		indices = ICOUNT(Game_Vertices);
 		String_Format1(&status, "%i vertices", &indices);
+		if (Gui.DrawsSaved) String_Format1(&status, ", %i gui draws saved", &Gui.DrawsSaved);
 
 		ping = Ping_AveragePingMS();
 		if (ping) String_Format1(&status, ", ping %i ms", &ping);
+
+		if (Game_AutoQualityLevel >= 0) {
+			String_Format3(&status, ", auto quality %i (%f1 ms, view %i)", 
+				&Game_AutoQualityLevel, &Game_AutoQualityFrameTime, &Game_ViewDistance);
+		}
 	}
 	TextWidget_Set(&s->line1, &status, &s->font);
 	s->dirty = true;
@@ -314,12 +320,14 @@ static void HUDScreen_Init(void* screen) {
 
 	Event_Register_(&UserEvents.HacksStateChanged, s, HUDScreen_HacksChanged);
 	Event_Register_(&TextureEvents.AtlasChanged,   s, HUDScreen_NeedRedrawing);
+	Event_Register_(&TextureEvents.IconsChanged,   s, HUDScreen_NeedRedrawing);
 	Event_Register_(&BlockEvents.BlockDefChanged,  s, HUDScreen_NeedRedrawing);
 }
 
 static void HUDScreen_Free(void* screen) {
 	Event_Unregister_(&UserEvents.HacksStateChanged, screen, HUDScreen_HacksChanged);
 	Event_Unregister_(&TextureEvents.AtlasChanged,   screen, HUDScreen_NeedRedrawing);
+	Event_Unregister_(&TextureEvents.IconsChanged,   screen, HUDScreen_NeedRedrawing);
 	Event_Unregister_(&BlockEvents.BlockDefChanged,  screen, HUDScreen_NeedRedrawing);
 }
 
@@ -399,22 +407,22 @@ static void HUDScreen_Render(void* screen, float delta) {
 		Widget_Render2(&s->line2, 8);
 	} else if (IsOnlyChatActive() && Gui.ShowFPS) {
 		Widget_Render2(&s->line2, 8);
-		Gfx_BindTexture(s->posAtlas.tex.ID);
-		Gfx_DrawVb_IndexedTris_Range(s->posCount, 12 + HOTBAR_MAX_VERTICES, DRAW_HINT_RECT);
+		Gui_DrawRange(s->posAtlas.tex.ID, s->posCount, 12 + HOTBAR_MAX_VERTICES, DRAW_HINT_RECT);
 		/* TODO swap these two lines back */
 	}
 
 	if (!Gui_GetBlocksWorld()) {
+		Gui_FlushDraws();
 		Gfx_BindDynamicVb(s->vb);
 		if (!Gui.HideHotbar) Widget_Render2(&s->hotbar, 12);
 
 		if (!Gui.HideCrosshair && Gui.IconsTex && !tablist_active) {
-			Gfx_BindTexture(Gui.IconsTex);
 			Gfx_BindDynamicVb(s->vb); /* Have to rebind for mobile right now... */
-			Gfx_DrawVb_IndexedTris_Range(4, 0, DRAW_HINT_SPRITE);
+			Gui_DrawRange(Gui.IconsTex, 4, 0, DRAW_HINT_SPRITE);
 		}
 	}
 
+	Gui_FlushDraws();
 	Gfx_3DS_SetRenderScreen(BOTTOM_SCREEN);
 }
 
@@ -454,24 +462,47 @@ static struct TabListOverlay {
 	TabListEntryCompare compare;
 	cc_uint16 ids[TABLIST_MAX_ENTRIES];
 	struct Texture textures[TABLIST_MAX_ENTRIES];
+	/* When supported, names are drawn from a glyph atlas instead of a texture per name */
+	struct GlyphAtlas glyphs;
+	cc_bool useGlyphs;
+	int glyphVertices;
 } TabListOverlay_Instance CC_BIG_VAR;
 #define TABLIST_MAX_VERTICES (TEXTWIDGET_MAX + 4 * TABLIST_MAX_ENTRIES)
 
+static cc_string TabListOverlay_FormatText(const cc_string* name, cc_string* tmp) {
+	if (!Game_PureClassic) return *name;
+
+	String_AppendColorless(tmp, name);
+	return *tmp;
+}
+
 static void TabListOverlay_DrawText(struct Texture* tex, struct TabListOverlay* s, const cc_string* name) {
 	cc_string tmp; char tmpBuffer[STRING_SIZE];
 	struct DrawTextArgs args;
+	cc_string text;
 
-	if (Game_PureClassic) {
-		String_InitArray(tmp, tmpBuffer);
-		String_AppendColorless(&tmp, name);
-	} else {
-		tmp = *name;
+	String_InitArray(tmp, tmpBuffer);
+	text = TabListOverlay_FormatText(name, &tmp);
+
+	if (s->useGlyphs) {
+		tex->ID     = 0;
+		tex->width  = GlyphAtlas_TextWidth(&s->glyphs, &text);
+		tex->height = s->glyphs.lineHeight;
+		return;
 	}
 
-	DrawTextArgs_Make(&args, &tmp, &s->font, !s->classic);
+	DrawTextArgs_Make(&args, &text, &s->font, !s->classic);
 	Drawer2D_MakeTextTexture(tex, &args);
 }
 
+static cc_string TabListOverlay_UNSAFE_GetText(struct TabListOverlay* s, int i) {
+	if (s->ids[i] != GROUP_NAME_ID) return TabList_UNSAFE_GetList(s->ids[i]);
+
+	/* Group names are always inserted just before the first player in that group */
+	if (i + 1 >= s->usedCount) return String_Empty;
+	return TabList_UNSAFE_GetGroup(s->ids[i + 1]);
+}
+
 static int TabListOverlay_GetColumnWidth(struct TabListOverlay* s, int column) {
 	int i   = column * LIST_NAMES_PER_COLUMN;
 	int end = min(s->usedCount, i + LIST_NAMES_PER_COLUMN);
@@ -748,7 +779,8 @@ static int TabListOverlay_PointerDown(void* screen, int id, int x, int y) {
 
 	for (i = 0; i < s->usedCount; i++)
 	{
-		if (!s->textures[i].ID || s->ids[i] == GROUP_NAME_ID) continue;
+		if (!s->useGlyphs && !s->textures[i].ID) continue;
+		if (s->ids[i] == GROUP_NAME_ID) continue;
 		tex = s->textures[i];
 		if (!Gui_Contains(tex.x, tex.y, tex.width, tex.height, x, y)) continue;
 
@@ -773,6 +805,7 @@ static void TabListOverlay_ContextLost(void* screen) {
 	{
 		Gfx_DeleteTexture(&s->textures[i].ID);
 	}
+	GlyphAtlas_Free(&s->glyphs);
 
 	Elem_Free(&s->title);
 	Font_Free(&s->font);
@@ -789,6 +822,7 @@ static void TabListOverlay_ContextRecreated(void* screen) {
 
 	TextWidget_SetConst(&s->title, "Connected players:", &s->font);
 	Font_SetPadding(&s->font, 1);
+	s->useGlyphs = GlyphAtlas_Make(&s->glyphs, &s->font, !s->classic);
 	Screen_UpdateVb(screen);
 
 	/* TODO: Just recreate instead of this? maybe */
@@ -800,17 +834,69 @@ static void TabListOverlay_ContextRecreated(void* screen) {
 	TabListOverlay_SortAndLayout(s); /* TODO: Not do layout here too */
 }
 
+static int TabListOverlay_CountGlyphVertices(struct TabListOverlay* s) {
+	cc_string tmp; char tmpBuffer[STRING_SIZE];
+	cc_string name, text;
+	int i, count = 0;
+
+	for (i = 0; i < s->usedCount; i++)
+	{
+		String_InitArray(tmp, tmpBuffer);
+		name   = TabListOverlay_UNSAFE_GetText(s, i);
+		text   = TabListOverlay_FormatText(&name, &tmp);
+		count += GlyphAtlas_CountQuads(&s->glyphs, &text) * 4;
+	}
+	return min(count, GFX_MAX_VERTICES - TEXTWIDGET_MAX);
+}
+
+static void TabListOverlay_BuildGlyphs(struct TabListOverlay* s, cc_bool grabbed, struct VertexTextured** v) {
+	cc_string tmp; char tmpBuffer[STRING_SIZE];
+	cc_string name, text;
+	struct Texture tex;
+	int i, count, left = s->glyphVertices;
+
+	for (i = 0; i < s->usedCount; i++)
+	{
+		String_InitArray(tmp, tmpBuffer);
+		name  = TabListOverlay_UNSAFE_GetText(s, i);
+		text  = TabListOverlay_FormatText(&name, &tmp);
+		count = GlyphAtlas_CountQuads(&s->glyphs, &text) * 4;
+		if (count > left) break;
+
+		tex = s->textures[i];
+		if (grabbed && s->ids[i] != GROUP_NAME_ID) {
+			if (Gui_ContainsPointers(tex.x, tex.y, tex.width, tex.height)) tex.x += 4;
+		}
+		GlyphAtlas_AddText(&s->glyphs, &text, tex.x, tex.y, v);
+		left -= count;
+	}
+	s->glyphVertices -= left;
+}
+
 static void TabListOverlay_BuildMesh(void* screen) {
 	struct TabListOverlay* s = (struct TabListOverlay*)screen;
 	struct Screen*   grabbed = Gui_GetInputGrab();
 	struct VertexTextured* v;
 	struct Texture tex;
-	int i;
+	int i, count;
+
+	if (s->useGlyphs) {
+		s->glyphVertices = TabListOverlay_CountGlyphVertices(s);
+		count = TEXTWIDGET_MAX + s->glyphVertices;
+		if (count > s->maxVertices) { s->maxVertices = count; Screen_UpdateVb(s); }
+	} else {
+		count = TEXTWIDGET_MAX + s->usedCount * 4;
+	}
 	
-	v = (struct VertexTextured*)Gfx_LockDynamicVb(s->vb,
-										VERTEX_FORMAT_TEXTURED, TEXTWIDGET_MAX + s->usedCount * 4);
+	v = (struct VertexTextured*)Gfx_LockDynamicVb(s->vb, VERTEX_FORMAT_TEXTURED, count);
 	Widget_BuildMesh(&s->title, &v);
 
+	if (s->useGlyphs) {
+		TabListOverlay_BuildGlyphs(s, grabbed != NULL, &v);
+		Gfx_UnlockDynamicVb(s->vb);
+		return;
+	}
+
 	for (i = 0; i < s->usedCount; i++)
 	{
 		if (!s->textures[i].ID) continue;
@@ -840,15 +926,19 @@ static void TabListOverlay_Render(void* screen, float delta) {
 	Gfx_BindDynamicVb(s->vb);
 	offset = Widget_Render2(&s->title, offset);
 
+	/* All names are drawn with a single draw call */
+	if (s->useGlyphs && s->glyphVertices) {
+		Gui_DrawRange(s->glyphs.texID, s->glyphVertices, offset, DRAW_HINT_NONE);
+	}
+
 	for (i = 0; i < s->usedCount; i++)
 	{
 		if (!s->textures[i].ID) continue;
-		Gfx_BindTexture(s->textures[i].ID);
-
-		Gfx_DrawVb_IndexedTris_Range(4, offset, DRAW_HINT_RECT);
+		Gui_DrawRange(s->textures[i].ID, 4, offset, DRAW_HINT_RECT);
 		offset += 4;
 	}
 
+	Gui_FlushDraws();
 	Gfx_3DS_SetRenderScreen(BOTTOM_SCREEN);
 }
 
@@ -901,6 +991,7 @@ static struct ChatScreen {
 	int chatIndex, paddingX, paddingY;
 	int lastDownloadStatus;
 	struct FontDesc chatFont;
+	struct GlyphAtlas glyphs;
 	struct ChatInputWidget input;
 	struct TextGroupWidget chat, clientStatus;
 	struct SpecialInputWidget altText;
@@ -927,6 +1018,7 @@ static void ChatScreen_UpdateChatYOffsets(struct ChatScreen* s) {
 	Widget_Layout(&s->clientStatus);
 	s->chat.yOffset = s->clientStatus.yOffset + s->clientStatus.height;
 	Widget_Layout(&s->chat);
+	s->dirty = true;
 }
 
 static void ChatScreen_OnInputTextChanged(void* elem) {
@@ -946,6 +1038,31 @@ static cc_string ChatScreen_GetClientStatus(int i) { return Chat_ClientStatus[i]
 
 static void ChatScreen_FreeChatFonts(struct ChatScreen* s) {
 	Font_Free(&s->chatFont);
+	GlyphAtlas_Free(&s->glyphs);
+	s->chat.glyphs         = NULL;
+	s->clientStatus.glyphs = NULL;
+}
+
+static int ChatScreen_CalcMaxVertices(void* screen) {
+	struct ChatScreen* s = (struct ChatScreen*)screen;
+	struct TextGroupWidget* chat = &s->chat;
+	/* In case chatlines is 0 */
+	return max(4, chat->VTABLE->GetMaxVertices(chat) + Widget_MaxVertices(&s->clientStatus));
+}
+
+/* Chat and client status lines are drawn from a glyph atlas when possible */
+static void ChatScreen_UpdateGlyphs(struct ChatScreen* s) {
+	struct GlyphAtlas* glyphs = NULL;
+	int maxVertices;
+	if (GlyphAtlas_Make(&s->glyphs, &s->chatFont, true)) glyphs = &s->glyphs;
+
+	s->chat.glyphs         = glyphs;
+	s->clientStatus.glyphs = glyphs;
+
+	maxVertices = ChatScreen_CalcMaxVertices(s);
+	if (maxVertices == s->maxVertices) return;
+	s->maxVertices = maxVertices;
+	if (!Gfx.LostContext) Screen_UpdateVb(s);
 }
 
 static cc_bool ChatScreen_ChatUpdateFont(struct ChatScreen* s) {
@@ -957,6 +1074,7 @@ static cc_bool ChatScreen_ChatUpdateFont(struct ChatScreen* s) {
 	if (Display_ScaleY(size) == s->chatFont.size) return false;
 	ChatScreen_FreeChatFonts(s);
 	Font_Make(&s->chatFont, size, FONT_FLAGS_PADDING);
+	ChatScreen_UpdateGlyphs(s);
 
 	ChatInputWidget_SetFont(&s->input,        &s->chatFont);
 	TextGroupWidget_SetFont(&s->chat,         &s->chatFont);
@@ -983,6 +1101,7 @@ static void ChatScreen_ScrollChatBy(struct ChatScreen* s, int delta) {
 	int newIndex = ChatScreen_ClampChatIndex(s->chatIndex + delta);
 	delta = newIndex - s->chatIndex;
 	if (Game_PureClassic) return;
+	s->dirty = true;
 
 	while (delta) {
 		if (delta < 0) {
@@ -1027,6 +1146,7 @@ static void ChatScreen_ColCodeChanged(void* screen, int code) {
 	SpecialInputWidget_UpdateCols(&s->altText);
 	TextGroupWidget_RedrawAllWithCol(&s->chat,         code);
 	TextGroupWidget_RedrawAllWithCol(&s->clientStatus, code);
+	s->dirty = true; /* Glyph colours are stored in the vertices */
 
 	/* Some servers have plugins that redefine colours constantly */
 	/* Preserve caret accumulator so caret blinking stays consistent */
@@ -1072,35 +1192,37 @@ static void ChatScreen_DrawChatBackground(struct ChatScreen* s) {
 	}
 }
 
+static cc_bool ChatScreen_IsRecentLine(struct ChatScreen* s, int i, double now) {
+	int logIdx = s->chatIndex + i;
+	if (logIdx < 0 || logIdx >= Chat_Log.count) return false;
+
+	/* Only draw chat within last 10 seconds */
+	return Chat_GetLogTime(logIdx) + 10 >= now;
+}
+
 static void ChatScreen_DrawChat(struct ChatScreen* s, float delta) {
-	GfxResourceID texID;
 	double now;
-	int i, logIdx;
-
-	Elem_Render(&s->clientStatus, delta);
+	int i, offset = 0;
 
 	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
 	Gfx_BindDynamicVb(s->vb);
 	now = Game.Time;
 
 	if (s->grabsInput) {
-		Widget_Render2(&s->chat, 0);
+		offset = Widget_Render2(&s->chat, 0);
 	} else {
 		/* Only render recent chat */
 		for (i = 0; i < s->chat.lines; i++) 
 		{
-			texID  = s->chat.textures[i].ID;
-			if (!texID) continue;
-			logIdx = s->chatIndex + i;
-
-			if (logIdx < 0 || logIdx >= Chat_Log.count) continue;
-			/* Only draw chat within last 10 seconds */
-			if (Chat_GetLogTime(logIdx) + 10 < now) continue;
-			
-			Gfx_BindTexture(texID);
-			Gfx_DrawVb_IndexedTris_Range(4, i * 4, DRAW_HINT_RECT);
+			if (ChatScreen_IsRecentLine(s, i, now)) {
+				offset = TextGroupWidget_RenderLine(&s->chat, i, offset);
+			} else {
+				offset += TextGroupWidget_LineVertices(&s->chat, i);
+			}
 		}
 	}
+	Widget_Render2(&s->clientStatus, offset);
+	Gui_FlushDraws();
 
 	if (s->grabsInput) {
 		Elem_Render(&s->input.base, delta);
@@ -1153,13 +1275,6 @@ static void ChatScreen_ContextRecreated(void* screen) {
 #endif
 }
 
-static int ChatScreen_CalcMaxVertices(void* screen) {
-	struct ChatScreen* s = (struct ChatScreen*)screen;
-	struct TextGroupWidget* chat = &s->chat;
-	/* In case chatlines is 0 */
-	return max(4, chat->VTABLE->GetMaxVertices(chat));
-}
-
 static void ChatScreen_BuildMesh(void* screen) {
 	struct ChatScreen* s = (struct ChatScreen*)screen;
 	struct VertexTextured* data;
@@ -1169,6 +1284,7 @@ static void ChatScreen_BuildMesh(void* screen) {
 	ptr  = &data;
 
 	Widget_BuildMesh(&s->chat, ptr);
+	Widget_BuildMesh(&s->clientStatus, ptr);
 	Gfx_UnlockDynamicVb(s->vb);
 }
 
@@ -1471,6 +1587,7 @@ static struct SpecialTextScreen {
 	Screen_Body
 	int lastDownloadStatus;
 	struct FontDesc chatFont, announcementFont, bigAnnouncementFont, smallAnnouncementFont;
+	struct GlyphAtlas glyphs;
 	struct TextWidget announcement, bigAnnouncement, smallAnnouncement;
 	struct TextGroupWidget status, bottomRight;
 
@@ -1487,6 +1604,25 @@ static void SpecialTextScreen_FreeChatFonts(struct SpecialTextScreen* s) {
 	Font_Free(&s->announcementFont);
 	Font_Free(&s->bigAnnouncementFont);
 	Font_Free(&s->smallAnnouncementFont);
+
+	GlyphAtlas_Free(&s->glyphs);
+	s->status.glyphs      = NULL;
+	s->bottomRight.glyphs = NULL;
+}
+
+/* Status and bottom right lines are drawn from a glyph atlas when possible */
+static void SpecialTextScreen_UpdateGlyphs(struct SpecialTextScreen* s) {
+	struct GlyphAtlas* glyphs = NULL;
+	int maxVertices;
+	if (GlyphAtlas_Make(&s->glyphs, &s->chatFont, true)) glyphs = &s->glyphs;
+
+	s->status.glyphs      = glyphs;
+	s->bottomRight.glyphs = glyphs;
+
+	maxVertices = Screen_CalcDefaultMaxVertices(s);
+	if (maxVertices == s->maxVertices) return;
+	s->maxVertices = maxVertices;
+	if (!Gfx.LostContext) Screen_UpdateVb(s);
 }
 
 static cc_bool SpecialTextScreen_ChatUpdateFont(struct SpecialTextScreen* s) {
@@ -1498,6 +1634,7 @@ static cc_bool SpecialTextScreen_ChatUpdateFont(struct SpecialTextScreen* s) {
 	if (Display_ScaleY(size) == s->chatFont.size) return false;
 	SpecialTextScreen_FreeChatFonts(s);
 	Font_Make(&s->chatFont, size, FONT_FLAGS_PADDING);
+	SpecialTextScreen_UpdateGlyphs(s);
 
 	size = (int)(16 * Gui_GetChatScale());
 	Math_Clamp(size, 8, 64);
@@ -1538,6 +1675,7 @@ static void SpecialTextScreen_ColCodeChanged(void* screen, int code) {
 
 	TextGroupWidget_RedrawAllWithCol(&s->status,       code);
 	TextGroupWidget_RedrawAllWithCol(&s->bottomRight,  code);
+	s->dirty = true; /* Glyph colours are stored in the vertices */
 }
 
 static void SpecialTextScreen_ChatReceived(void* screen, const cc_string* msg, int type) {
@@ -1820,6 +1958,7 @@ static void InventoryScreen_Init(void* screen) {
 	s->deferredSelect = true;
 
 	Event_Register_(&TextureEvents.AtlasChanged,     s, InventoryScreen_NeedRedrawing);
+	Event_Register_(&TextureEvents.IconsChanged,     s, InventoryScreen_NeedRedrawing);
 	Event_Register_(&BlockEvents.PermissionsChanged, s, InventoryScreen_OnBlockChanged);
 	Event_Register_(&BlockEvents.BlockDefChanged,    s, InventoryScreen_OnBlockChanged);
 
@@ -1830,6 +1969,7 @@ static void InventoryScreen_Free(void* screen) {
 	struct InventoryScreen* s = (struct InventoryScreen*)screen;
 
 	Event_Unregister_(&TextureEvents.AtlasChanged,     s, InventoryScreen_NeedRedrawing);
+	Event_Unregister_(&TextureEvents.IconsChanged,     s, InventoryScreen_NeedRedrawing);
 	Event_Unregister_(&BlockEvents.PermissionsChanged, s, InventoryScreen_OnBlockChanged);
 	Event_Unregister_(&BlockEvents.BlockDefChanged,    s, InventoryScreen_OnBlockChanged);
 }
@@ -2088,6 +2228,7 @@ static void LoadingScreen_Render(void* screen, float delta) {
 
 	offset = Widget_Render2(&s->title,   offset);
 	offset = Widget_Render2(&s->message, offset);
+	Gui_FlushDraws();
 
 	filledWidth = (int)(s->progWidth * s->progress);
 	Gfx_Draw2DFlat(s->progX, s->progY, s->progWidth, 
@@ -16,6 +16,7 @@
 #include "Utils.h"
 #include "Chat.h" /* TODO avoid this include */
 #include "Errors.h"
+#include "Model.h"
 
 /* Simple fallback terrain for when no texture packs are available at all */
 static BitmapCol fallback_terrain[16 * 8] = {
@@ -83,7 +84,7 @@ TextureRec Atlas1D_TexRec(TextureLoc texLoc, int uCount, int* index) {
 static void Atlas1D_Load(int index, struct Bitmap* atlas1D) {
 	int tileSize      = Atlas2D.TileSize;
 	int tilesPerAtlas = Atlas1D.TilesPerAtlas;
-	int y, tile = index * tilesPerAtlas;
+	int y, i, tile = index * tilesPerAtlas;
 	int atlasX, atlasY;
 	
 	for (y = 0; y < tilesPerAtlas; y++, tile++) 
@@ -91,8 +92,11 @@ static void Atlas1D_Load(int index, struct Bitmap* atlas1D) {
 		atlasX = Atlas2D_TileX(tile) * tileSize;
 		atlasY = Atlas2D_TileY(tile) * tileSize;
 
-		Bitmap_UNSAFE_CopyBlock(atlasX, atlasY, 0, y * tileSize,
-							&Atlas2D.Bmp, atlas1D, tileSize);
+		for (i = 0; i < Atlas1D.Repeats; i++)
+		{
+			Bitmap_UNSAFE_CopyBlock(atlasX, atlasY, 0, ((y << Atlas1D.RepeatShift) + i) * tileSize,
+								&Atlas2D.Bmp, atlas1D, tileSize);
+		}
 	}
 	Gfx_RecreateTexture(&Atlas1D.TexIds[index], atlas1D, TEXTURE_FLAG_MANAGED | TEXTURE_FLAG_DYNAMIC, Gfx.Mipmaps);
 }
@@ -105,7 +109,7 @@ static void Atlas1D_LoadBlock(int index) {
 	struct Bitmap atlas1D;
 
 	Platform_Log2("Lazy load atlas #%i (%i per bmp)", &index, &tilesPerAtlas);
-	Bitmap_Allocate(&atlas1D, tileSize, tilesPerAtlas * tileSize);
+	Bitmap_Allocate(&atlas1D, tileSize, (tilesPerAtlas << Atlas1D.RepeatShift) * tileSize);
 	
 	Atlas1D_Load(index, &atlas1D);
 	Mem_Free(atlas1D.scan0);
@@ -135,7 +139,7 @@ static void Atlas_Convert2DTo1D(void) {
 	int i;
 
 	Platform_Log2("Loaded terrain atlas: %i bmps, %i per bmp", &atlasesCount, &tilesPerAtlas);
-	Bitmap_Allocate(&atlas1D, tileSize, tilesPerAtlas * tileSize);
+	Bitmap_Allocate(&atlas1D, tileSize, (tilesPerAtlas << Atlas1D.RepeatShift) * tileSize);
 	
 	for (i = 0; i < atlasesCount; i++) 
 	{
@@ -145,8 +149,12 @@ static void Atlas_Convert2DTo1D(void) {
 }
 #endif
 
+/* Maximum number of copies of each tile in a 1D atlas */
+#define ATLAS1D_MAX_REPEATS 8
+static cc_bool atlas1D_repeatTiles;
+
 static void Atlas_Update1D(void) {
-	int maxAtlasHeight, maxTilesPerAtlas, maxTiles;
+	int maxAtlasHeight, maxTilesPerAtlas, maxTiles, repeats = 1;
 	int maxTexHeight = Gfx.MaxTexHeight;
 
 	/* E.g. a graphics backend may support textures up to 256 x 256 */
@@ -160,10 +168,20 @@ static void Atlas_Update1D(void) {
 	maxTilesPerAtlas = maxAtlasHeight / Atlas2D.TileSize;
 	maxTiles         = Atlas2D.RowsCount * ATLAS2D_TILES_PER_ROW;
 
+#ifndef CC_BUILD_LOWMEM
+	/* Still keep at least 16 different tiles in each 1D atlas */
+	if (atlas1D_repeatTiles) {
+		while (repeats < ATLAS1D_MAX_REPEATS && (maxTilesPerAtlas / repeats) > 16) repeats *= 2;
+	}
+#endif
+	maxTilesPerAtlas /= repeats;
+
 	Atlas1D.TilesPerAtlas = min(maxTilesPerAtlas, maxTiles);
 	Atlas1D.Count = Math_CeilDiv(maxTiles, Atlas1D.TilesPerAtlas);
+	Atlas1D.Repeats     = repeats;
+	Atlas1D.RepeatShift = Math_ilog2(repeats);
 
-	Atlas1D.InvTileSize = 1.0f / Atlas1D.TilesPerAtlas;
+	Atlas1D.InvTileSize = 1.0f / (Atlas1D.TilesPerAtlas * repeats);
 	Atlas1D.Mask  = Atlas1D.TilesPerAtlas - 1;
 	Atlas1D.Shift = Math_ilog2(Atlas1D.TilesPerAtlas);
 }
@@ -253,6 +271,17 @@ cc_bool Atlas_TryChange(struct Bitmap* atlas) {
 	return true;
 }
 
+void Atlas1D_SetRepeatTiles(cc_bool repeat) {
+	if (atlas1D_repeatTiles == repeat) return;
+	atlas1D_repeatTiles = repeat;
+	if (!Atlas2D.Bmp.scan0 || Gfx.LostContext) return;
+
+	Atlas1D_Free();
+	Atlas_Update1D();
+	Atlas_Convert2DTo1D();
+	Event_RaiseVoid(&TextureEvents.AtlasChanged);
+}
+
 
 /*########################################################################################################################*
 *------------------------------------------------------TextureUrls--------------------------------------------------------*
@@ -521,11 +550,19 @@ cc_result TexturePack_ExtractDefault(DefaultZipCallback callback, const char** d
 
 
 static cc_bool SelectZipEntry(const cc_string* path) { return true; }
-static cc_result ProcessZipEntry(const cc_string* path, struct Stream* stream, struct ZipEntry* source) {
-	cc_string name = *path;
-	Utils_UNSAFE_GetFilename(&name);
-	Event_RaiseEntry(&TextureEvents.FileChanged, stream, &name);
-	return 0;
+
+/* Stream of the entry currently being raised as TextureEvents.FileChanged, */
+/*  and the image already decoded from it on a worker thread (if any) */
+static struct Stream* pack_curStream;
+static struct Bitmap* pack_curBmp;
+
+cc_result TexturePack_DecodePng(struct Bitmap* bmp, struct Stream* stream) {
+	if (stream == pack_curStream && pack_curBmp && pack_curBmp->scan0) {
+		*bmp = *pack_curBmp;
+		pack_curBmp->scan0 = NULL;
+		return 0;
+	}
+	return Png_Decode(bmp, stream);
 }
 
 static cc_result ExtractPng(struct Stream* stream) {
@@ -537,6 +574,226 @@ static cc_result ExtractPng(struct Stream* stream) {
 	return res;
 }
 
+#if !defined CC_BUILD_COOPTHREADED && !defined CC_BUILD_LOWMEM && CC_BUILD_MAXSTACK > (64 * 1024)
+/* Inflating and decoding .zip entries is done on worker threads, with the results */
+/*  then raised as TextureEvents.FileChanged on the main thread in the .zip's order */
+#define PACK_MAX_WORKERS 3
+#define PACK_MAX_JOBS    512
+static cc_bool TextureEntry_IsUsed(const cc_string* name);
+
+enum PackJobState { PACKJOB_PENDING, PACKJOB_BUSY, PACKJOB_DONE };
+struct PackJob {
+	cc_string path;   /* Full path of the entry in the archive */
+	cc_uint8* raw;    /* Path characters, followed by compressed data */
+	cc_uint8* data;   /* Decompressed data */
+	cc_uint32 rawSize, dataSize;
+	int method, state;
+	cc_bool decodePng;
+	cc_result res;
+	struct Bitmap bmp; /* Decoded image, if decodePng is true */
+};
+
+static struct PackJob* pack_jobs;
+static int pack_numJobs, pack_nextJob;
+static void* pack_mutex;
+static void* pack_jobDone;
+
+static cc_result QueueZipEntry(const cc_string* path, struct Stream* stream, struct ZipEntry* source) {
+	struct PackJob* job;
+	cc_string name = *path;
+	cc_uint32 size;
+	cc_result res;
+	if (pack_numJobs >= PACK_MAX_JOBS) return ZIP_ERR_TOO_MANY_ENTRIES;
+
+	job  = &pack_jobs[pack_numJobs];
+	size = source->CompressionMethod ? source->CompressedSize : source->UncompressedSize;
+	/* +1 in case of empty path and data */
+	job->raw = (cc_uint8*)Mem_TryAlloc(1, path->length + size + 1);
+	if (!job->raw) return ERR_OUT_OF_MEMORY;
+
+	Mem_Copy(job->raw, path->buffer, path->length);
+	if ((res = Stream_Read(stream, job->raw + path->length, size))) {
+		Mem_Free(job->raw); return res;
+	}
+
+	job->path     = String_Init((char*)job->raw, path->length, path->length);
+	job->data     = NULL;
+	job->rawSize  = size;
+	job->dataSize = source->UncompressedSize;
+	job->method   = source->CompressionMethod;
+	job->state    = PACKJOB_PENDING;
+	job->res      = 0;
+	job->bmp.scan0 = NULL;
+
+	/* Only bother decoding images that will actually be used */
+	Utils_UNSAFE_GetFilename(&name);
+	job->decodePng = TextureEntry_IsUsed(&name) || Model_FindTexture(&name);
+
+	pack_numJobs++;
+	return 0;
+}
+
+static cc_result PackJob_Inflate(struct PackJob* job) {
+	struct InflateState* inflate;
+	struct Stream src, compStream;
+	cc_uint8* raw = job->raw + job->path.length;
+	cc_result res;
+
+	if (job->method == 0) {
+		job->data     = raw;
+		job->dataSize = job->rawSize;
+		return 0;
+	}
+
+	job->data = (cc_uint8*)Mem_TryAlloc(1, job->dataSize + 1);
+	inflate   = (struct InflateState*)Mem_TryAlloc(1, sizeof(struct InflateState));
+
+	if (job->data && inflate) {
+		Stream_ReadonlyMemory(&src, raw, job->rawSize);
+		Inflate_MakeStream2(&compStream, inflate, &src);
+		res = Stream_Read(&compStream, job->data, job->dataSize);
+	} else {
+		res = ERR_OUT_OF_MEMORY;
+	}
+
+	Mem_Free(inflate);
+	return res;
+}
+
+static void PackJob_Run(struct PackJob* job) {
+	struct Stream src;
+	cc_result res;
+
+	job->res = PackJob_Inflate(job);
+	if (job->res || !job->decodePng || !Png_Detect(job->data, job->dataSize)) return;
+
+	Stream_ReadonlyMemory(&src, job->data, job->dataSize);
+	res = Png_Decode(&job->bmp, &src);
+	if (!res) return;
+
+	/* Main thread will decode again, so the error gets reported as usual */
+	Mem_Free(job->bmp.scan0);
+	job->bmp.scan0 = NULL;
+}
+
+static struct PackJob* PackJob_Claim(void) {
+	struct PackJob* job = NULL;
+
+	Mutex_Lock(pack_mutex);
+	if (pack_nextJob < pack_numJobs) {
+		job = &pack_jobs[pack_nextJob++];
+		job->state = PACKJOB_BUSY;
+	}
+	Mutex_Unlock(pack_mutex);
+	return job;
+}
+
+static void PackJob_Process(struct PackJob* job) {
+	PackJob_Run(job);
+
+	Mutex_Lock(pack_mutex);
+	job->state = PACKJOB_DONE;
+	Mutex_Unlock(pack_mutex);
+	Waitable_Signal(pack_jobDone);
+}
+
+static cc_bool PackJob_IsDone(struct PackJob* job) {
+	cc_bool done;
+
+	Mutex_Lock(pack_mutex);
+	done = job->state == PACKJOB_DONE;
+	Mutex_Unlock(pack_mutex);
+	return done;
+}
+
+static void PackWorker_Run(void) {
+	struct PackJob* job;
+	while ((job = PackJob_Claim())) { PackJob_Process(job); }
+}
+
+static void PackJob_Deliver(struct PackJob* job) {
+	struct Stream stream;
+	cc_string name;
+
+	if (job->res) {
+		Logger_SysWarn2(job->res, "decompressing", &job->path);
+	} else {
+		name = job->path;
+		Utils_UNSAFE_GetFilename(&name);
+		Stream_ReadonlyMemory(&stream, job->data, job->dataSize);
+
+		pack_curStream = &stream;
+		pack_curBmp    = &job->bmp;
+		Event_RaiseEntry(&TextureEvents.FileChanged, &stream, &name);
+		pack_curStream = NULL;
+		pack_curBmp    = NULL;
+	}
+
+	/* Image might not have been used by any handler */
+	Mem_Free(job->bmp.scan0);
+	if (job->data != job->raw + job->path.length) Mem_Free(job->data);
+	Mem_Free(job->raw);
+}
+
+static cc_result ExtractZip(struct Stream* stream, struct ZipEntry* entries, int maxEntries) {
+	void* workers[PACK_MAX_WORKERS] = { 0 };
+	struct PackJob* job;
+	cc_result res;
+	int i, numWorkers;
+
+	pack_jobs = (struct PackJob*)Mem_TryAlloc(PACK_MAX_JOBS, sizeof(struct PackJob));
+	if (!pack_jobs) return ERR_OUT_OF_MEMORY;
+	pack_numJobs = 0;
+	pack_nextJob = 0;
+
+	/* Reading the compressed data is cheap compared to inflating and decoding it */
+	/* NOTE: Entries read before an error are still delivered, same as Zip_Extract */
+	res = Zip_ExtractRaw(stream, SelectZipEntry, QueueZipEntry, entries, maxEntries);
+
+	pack_mutex   = Mutex_Create("Texture pack jobs");
+	pack_jobDone = Waitable_Create("Texture pack job done");
+	numWorkers   = min(PACK_MAX_WORKERS, pack_numJobs - 1);
+
+	for (i = 0; i < numWorkers; i++) 
+	{
+		Thread_Run(&workers[i], PackWorker_Run, 256 * 1024, "Texture pack");
+	}
+
+	for (i = 0; i < pack_numJobs; i++) 
+	{
+		/* Help out with later entries, instead of idly waiting for this one */
+		while (!PackJob_IsDone(&pack_jobs[i])) {
+			job = PackJob_Claim();
+			if (job) { PackJob_Process(job); } 
+			else     { Waitable_Wait(pack_jobDone); }
+		}
+		PackJob_Deliver(&pack_jobs[i]);
+	}
+
+	for (i = 0; i < numWorkers; i++) 
+	{
+		if (workers[i]) Thread_Join(workers[i]);
+	}
+
+	Mutex_Free(pack_mutex);
+	Waitable_Free(pack_jobDone);
+	Mem_Free(pack_jobs);
+	pack_jobs = NULL;
+	return res;
+}
+#else
+static cc_result ProcessZipEntry(const cc_string* path, struct Stream* stream, struct ZipEntry* source) {
+	cc_string name = *path;
+	Utils_UNSAFE_GetFilename(&name);
+	Event_RaiseEntry(&TextureEvents.FileChanged, stream, &name);
+	return 0;
+}
+
+static cc_result ExtractZip(struct Stream* stream, struct ZipEntry* entries, int maxEntries) {
+	return Zip_Extract(stream, SelectZipEntry, ProcessZipEntry, entries, maxEntries);
+}
+#endif
+
 static cc_bool needReload;
 static cc_result ExtractFrom(struct Stream* stream, const cc_string* path) {
 #if CC_BUILD_MAXSTACK <= (32 * 1024)
@@ -564,11 +821,9 @@ static cc_result ExtractFrom(struct Stream* stream, const cc_string* path) {
 		/* file isn't a .png image, probably a .zip archive then */
 
 #if CC_BUILD_MAXSTACK <= (32 * 1024)
-		res = Zip_Extract(stream, SelectZipEntry, ProcessZipEntry,
-							entries, 512);
+		res = ExtractZip(stream, entries, 512);
 #else
-		res = Zip_Extract(stream, SelectZipEntry, ProcessZipEntry,
-							entries, Array_Elems(entries));
+		res = ExtractZip(stream, entries, Array_Elems(entries));
 #endif
 
 		if (res) Logger_SysWarn2(res, "extracting", path);
@@ -707,7 +962,7 @@ static void DownloadAsync(const cc_string* url) {
 	}
 
 	Http_TryCancel(TexturePack_ReqID);
-	TexturePack_ReqID = Http_AsyncGetDataEx(url, HTTP_FLAG_PRIORITY, &time, &etag, NULL);
+	TexturePack_ReqID = Http_AsyncGetDataEx(url, HTTP_FLAG_PRIORITY | HTTP_FLAG_TEXTURE_PACK, &time, &etag, NULL);
 }
 
 void TexturePack_Extract(const cc_string* url) {
@@ -725,13 +980,25 @@ void TextureEntry_Register(struct TextureEntry* entry) {
 	LinkedList_Append(entry, entries_head, entries_tail);
 }
 
+#ifdef PACK_MAX_WORKERS
+static cc_bool TextureEntry_IsUsed(const cc_string* name) {
+	struct TextureEntry* e;
+
+	for (e = entries_head; e; e = e->next) 
+	{
+		if (String_CaselessEqualsConst(name, e->filename)) return true;
+	}
+	return false;
+}
+#endif
+
 
 /*########################################################################################################################*
 *---------------------------------------------------Textures component----------------------------------------------------*
 *#########################################################################################################################*/
 static void TerrainPngProcess(struct Stream* stream, const cc_string* name) {
 	struct Bitmap bmp;
-	cc_result res = Png_Decode(&bmp, stream);
+	cc_result res = TexturePack_DecodePng(&bmp, stream);
 
 	if (res) {
 		Logger_SysWarn2(res, "decoding", name);
@@ -48,7 +48,10 @@ CC_VAR extern struct _Atlas1DData {
 	int TilesPerAtlas;
 	/* Converts a tile id into 1D atlas index, and index within that atlas. */
 	int Mask, Shift;
-	/* Texture V coord that equals the size of one tile. (i.e. 1/Atlas1D.TilesPerAtlas) */
+	/* Number of consecutive copies of each tile in a 1D atlas. (usually 1) */
+	/* NOTE: Greedy meshing uses these to repeat tiles vertically across merged faces. */
+	int Repeats, RepeatShift;
+	/* Texture V coord that equals the size of one tile. (i.e. 1/(Atlas1D.TilesPerAtlas * Atlas1D.Repeats)) */
 	/* NOTE: The texture U coord that equals the size of one tile is 1. */
 	float InvTileSize;
 	/* Textures for each 1D atlas. Only Atlas1D_Count of these are valid. */
@@ -64,8 +67,8 @@ extern cc_bool TexturePack_DefaultMissing;
 
 #define Atlas2D_TileX(texLoc) ((texLoc) &  ATLAS2D_MASK)  /* texLoc % ATLAS2D_TILES_PER_ROW */
 #define Atlas2D_TileY(texLoc) ((texLoc) >> ATLAS2D_SHIFT) /* texLoc / ATLAS2D_TILES_PER_ROW */
-/* Returns the index of the given tile id within a 1D atlas */
-#define Atlas1D_RowId(texLoc) ((texLoc)  & Atlas1D.Mask)  /* texLoc % Atlas1D_TilesPerAtlas */
+/* Returns the row of the first copy of the given tile id within a 1D atlas */
+#define Atlas1D_RowId(texLoc) (((texLoc) & Atlas1D.Mask) << Atlas1D.RepeatShift) /* (texLoc % Atlas1D_TilesPerAtlas) * Repeats */
 /* Returns the index of the 1D atlas within the array of 1D atlases that contains the given tile id */
 #define Atlas1D_Index(texLoc) ((texLoc) >> Atlas1D.Shift) /* texLoc / Atlas1D_TilesPerAtlas */
 
@@ -73,11 +76,16 @@ extern cc_bool TexturePack_DefaultMissing;
 GfxResourceID Atlas2D_LoadTile(TextureLoc texLoc);
 /* Attempts to change the terrain atlas. (bitmap containing textures for all blocks) */
 cc_bool Atlas_TryChange(struct Bitmap* bmp);
+/* Decodes the PNG image of a texture pack entry passed to a TextureEvents.FileChanged handler. */
+/* NOTE: If the entry was already decoded on a worker thread, that image is returned instead. */
+cc_result TexturePack_DecodePng(struct Bitmap* bmp, struct Stream* stream);
 /* Returns the UV rectangle of the given tile id in the 1D atlases. */
 /* That is, returns U1/U2/V1/V2 coords that make up the tile in a 1D atlas. */
 /* index is set to the index of the 1D atlas that the tile is in. */
 TextureRec Atlas1D_TexRec(TextureLoc texLoc, int uCount, int* index);
 void Atlas1D_Bind(int index);
+/* Sets whether 1D atlases should contain multiple copies of each tile, rebuilding them if needed. */
+void Atlas1D_SetRepeatTiles(cc_bool repeat);
 
 /* Whether the given URL is in list of accepted URLs. */
 cc_bool TextureUrls_HasAccepted(const cc_string* url);
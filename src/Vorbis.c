@@ -259,12 +259,17 @@ struct Codebook {
 	float minValue, deltaValue;
 	cc_uint32 sequenceP, lookupType, lookupValues;
 	cc_uint16* multiplicands;
+	/* Precomputed vector for each entry (NULL if codebook is too large) */
+	float* vectors;
 };
+/* Maximum number of floats in a codebook's precomputed vectors */
+#define CODEBOOK_MAX_VECTORS (64 * 1024)
 
 static void Codebook_Free(struct Codebook* c) {
 	Mem_Free(c->codewords);
 	Mem_Free(c->values);
 	Mem_Free(c->multiplicands);
+	Mem_Free(c->vectors);
 }
 
 static cc_uint32 Codebook_Pow(cc_uint32 base, cc_uint32 exp) {
@@ -358,6 +363,37 @@ static cc_bool Codebook_CalcCodewords(struct Codebook* c, cc_uint8* len) {
 	return true;
 }
 
+/* Vorbis spec 3.2.1. Unpacks the vector of every entry ahead of time, */
+/*  which avoids a division and modulo per value for lookup type 1 codebooks */
+static void Codebook_CalcVectors(struct Codebook* c) {
+	cc_uint32 i, j, divisor, offset;
+	float last, value, *v;
+	if (!c->dimensions || c->entries > CODEBOOK_MAX_VECTORS / c->dimensions) return;
+
+	c->vectors = (float*)Mem_TryAlloc(c->entries * c->dimensions, sizeof(float));
+	if (!c->vectors) return;
+
+	for (i = 0; i < c->entries; i++) 
+	{
+		v = c->vectors + i * c->dimensions;
+		last = 0.0f; divisor = 1;
+
+		for (j = 0; j < c->dimensions; j++) 
+		{
+			if (c->lookupType == 1) {
+				offset   = (i / divisor) % c->lookupValues;
+				divisor *= c->lookupValues;
+			} else {
+				offset = i * c->dimensions + j;
+			}
+
+			value = c->multiplicands[offset] * c->deltaValue + c->minValue + last;
+			v[j]  = value;
+			if (c->sequenceP) last = value;
+		}
+	}
+}
+
 static cc_result Codebook_DecodeSetup(struct VorbisState* ctx, struct Codebook* c) {
 	cc_uint32 sync;
 	cc_uint8* codewordLens;
@@ -416,6 +452,7 @@ static cc_result Codebook_DecodeSetup(struct VorbisState* ctx, struct Codebook*
 
 	c->lookupType    = Vorbis_ReadBits(ctx, 4);
 	c->multiplicands = NULL;
+	c->vectors       = NULL;
 	if (c->lookupType == 0) return 0;
 	if (c->lookupType > 2)  return VORBIS_ERR_CODEBOOK_LOOKUP;
 
@@ -436,6 +473,8 @@ static cc_result Codebook_DecodeSetup(struct VorbisState* ctx, struct Codebook*
 	{
 		c->multiplicands[i] = Vorbis_ReadBits(ctx, valueBits);
 	}
+
+	Codebook_CalcVectors(c);
 	return 0;
 }
 
@@ -465,9 +504,13 @@ static cc_uint32 Codebook_DecodeScalar(struct VorbisState* ctx, struct Codebook*
 static void Codebook_DecodeVectors(struct VorbisState* ctx, struct Codebook* c, float* v, int step) {
 	cc_uint32 lookupOffset = Codebook_DecodeScalar(ctx, c);
 	float last = 0.0f, value;
+	const float* src;
 	cc_uint32 i, offset;
 
-	if (c->lookupType == 1) {		
+	if (c->vectors && lookupOffset < c->entries) {
+		src = c->vectors + lookupOffset * c->dimensions;
+		for (i = 0; i < c->dimensions; i++, v += step) { *v += src[i]; }
+	} else if (c->lookupType == 1) {		
 		cc_uint32 indexDivisor = 1;
 		for (i = 0; i < c->dimensions; i++, v += step) 
 		{
@@ -1107,8 +1150,9 @@ void imdct_calc(float* in, float* out, struct imdct_state* state) {
 	/* Uses a few fixes for the paper noted at http://www.nothings.org/stb_vorbis/mdct_01.txt */
 	float *A = state->a, *B = state->b, *C = state->c;
 
-	float u[VORBIS_MAX_BLOCK_SIZE / 2];
-	float w[VORBIS_MAX_BLOCK_SIZE / 2];
+	float bufA[VORBIS_MAX_BLOCK_SIZE / 2];
+	float bufB[VORBIS_MAX_BLOCK_SIZE / 2];
+	float *u = bufA, *w = bufB, *tmp;
 	float e_1, e_2, f_1, f_2;
 	float g_1, g_2, h_1, h_2;
 	float x_1, x_2, y_1, y_2;
@@ -1139,6 +1183,9 @@ void imdct_calc(float* in, float* out, struct imdct_state* state) {
 		int k0 = n >> (l+3), k1 = 1 << (l+3);
 		int r, r2, rMax = n >> (l+4), s2, s2Max = 1 << (l+2);
 
+		/* Previous iteration's output becomes this iteration's input */
+		if (l) { tmp = w; w = u; u = tmp; }
+
 		for (r = 0, r2 = 0; r < rMax; r++, r2 += 2) 
 		{
 			for (s2 = 0; s2 < s2Max; s2 += 2) 
@@ -1154,12 +1201,6 @@ void imdct_calc(float* in, float* out, struct imdct_state* state) {
 				u[n2-2-k0*(s2+1)-r2] = (e_2 - f_2) * A[r*k1] + (e_1 - f_1) * A[r*k1+1];
 			}
 		}
-
-		/* TODO: eliminate this, do w/u in-place */
-		/* TODO: dynamically allocate mem for imdct */
-		if (l+1 <= log2_n - 4) {
-			Mem_Copy(w, u, n2 * sizeof(float));
-		}
 	}
 
 	/* step 4, step 5, step 6, step 7, step 8, output */
@@ -1485,7 +1526,7 @@ cc_result Vorbis_DecodeFrame(struct VorbisState* ctx) {
 
 	/* swap prev and cur outputs around */
 	tmp = ctx->values[1]; ctx->values[1] = ctx->values[0]; ctx->values[0] = tmp;
-	Mem_Set(ctx->values[0], 0, ctx->channels * ctx->curBlockSize);
+	Mem_Set(ctx->values[0], 0, ctx->channels * ctx->curBlockSize * sizeof(float));
 
 	for (i = 0; i < ctx->channels; i++) 
 	{
@@ -1586,6 +1627,66 @@ cc_result Vorbis_DecodeFrame(struct VorbisState* ctx) {
 	return 0;
 }
 
+#ifdef CC_BUILD_SSE2
+#include <emmintrin.h>
+
+/* Converts 4 samples from each channel, clamping them to between -1 and 1 */
+static CC_INLINE __m128i Vorbis_ConvertSSE2(const float* src) {
+	__m128 v = _mm_loadu_ps(src);
+	v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+	return _mm_cvttps_epi32(_mm_mul_ps(v, _mm_set1_ps(32767.0f)));
+}
+#endif
+
+/* Converts samples to 16 bit integers, interleaving the channels together */
+static cc_int16* Vorbis_Interleave(cc_int16* dst, float** src, int channels, int count) {
+	float sample;
+	int i = 0, ch;
+
+#ifdef CC_BUILD_SSE2
+	__m128i a, b;
+	if (channels == 1) {
+		for (; i + 8 <= count; i += 8, dst += 8) 
+		{
+			a = Vorbis_ConvertSSE2(src[0] + i);
+			b = Vorbis_ConvertSSE2(src[0] + i + 4);
+			_mm_storeu_si128((__m128i*)dst, _mm_packs_epi32(a, b));
+		}
+	} else if (channels == 2) {
+		for (; i + 4 <= count; i += 4, dst += 8) 
+		{
+			a = Vorbis_ConvertSSE2(src[0] + i);
+			b = Vorbis_ConvertSSE2(src[1] + i);
+			/* L0 L1 L2 L3 R0 R1 R2 R3 -> L0 R0 L1 R1 L2 R2 L3 R3 */
+			a = _mm_packs_epi32(a, b);
+			b = _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 2, 3, 2));
+			_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(a, b));
+		}
+	}
+#endif
+
+	for (; i < count; i++) 
+	{
+		for (ch = 0; ch < channels; ch++) 
+		{
+			sample = src[ch][i];
+			Math_Clamp(sample, -1.0f, 1.0f);
+			*dst++ = (cc_int16)(sample * 32767);
+		}
+	}
+	return dst;
+}
+
+/* Applies the window to the previous and current blocks and adds them together */
+static void Vorbis_OverlapAdd(float* CC_RESTRICT prev, const float* CC_RESTRICT cur, 
+							const float* CC_RESTRICT winPrev, const float* CC_RESTRICT winCur, int count) {
+	int i;
+	for (i = 0; i < count; i++) 
+	{
+		prev[i] = prev[i] * winPrev[i] + cur[i] * winCur[i];
+	}
+}
+
 int Vorbis_OutputFrame(struct VorbisState* ctx, cc_int16* data) {
 	struct VorbisWindow window;
 	float* prev[VORBIS_MAX_CHANS];
@@ -1593,8 +1694,7 @@ int Vorbis_OutputFrame(struct VorbisState* ctx, cc_int16* data) {
 
 	int curQrtr, prevQrtr, overlapQtr;
 	int curOffset, prevOffset, overlapSize;
-	float sample;
-	int i, ch;
+	int i;
 
 	/* first frame decoded has no data */
 	if (ctx->prevBlockSize == 0) {
@@ -1627,15 +1727,7 @@ int Vorbis_OutputFrame(struct VorbisState* ctx, cc_int16* data) {
 	}
 
 	/* for long prev and short cur block, there will be non-overlapped data before */
-	for (i = 0; i < prevOffset; i++) 
-	{
-		for (ch = 0; ch < ctx->channels; ch++) 
-		{
-			sample = prev[ch][i];
-			Math_Clamp(sample, -1.0f, 1.0f);
-			*data++ = (cc_int16)(sample * 32767);
-		}
-	}
+	data = Vorbis_Interleave(data, prev, ctx->channels, prevOffset);
 
 	/* adjust pointers to start at 0 for overlapping */
 	for (i = 0; i < ctx->channels; i++) 
@@ -1647,28 +1739,16 @@ int Vorbis_OutputFrame(struct VorbisState* ctx, cc_int16* data) {
 	window = ctx->windows[(overlapQtr * 4) == ctx->blockSizes[1]];
 
 	/* overlap and add data */
-	/* also perform windowing here */
-	for (i = 0; i < overlapSize; i++) 
+	/* also perform windowing here (prev block's data is no longer needed after this) */
+	for (i = 0; i < ctx->channels; i++) 
 	{
-		for (ch = 0; ch < ctx->channels; ch++) 
-		{
-			sample = prev[ch][i] * window.Prev[i] + cur[ch][i] * window.Cur[i];
-			Math_Clamp(sample, -1.0f, 1.0f);
-			*data++ = (cc_int16)(sample * 32767);
-		}
+		Vorbis_OverlapAdd(prev[i], cur[i], window.Prev, window.Cur, overlapSize);
 	}
+	data = Vorbis_Interleave(data, prev, ctx->channels, overlapSize);
 
 	/* for long cur and short prev block, there will be non-overlapped data after */
 	for (i = 0; i < ctx->channels; i++) { cur[i] += overlapSize; }
-	for (i = 0; i < curOffset; i++) 
-	{
-		for (ch = 0; ch < ctx->channels; ch++) 
-		{
-			sample = cur[ch][i];
-			Math_Clamp(sample, -1.0f, 1.0f);
-			*data++ = (cc_int16)(sample * 32767);
-		}
-	}
+	data = Vorbis_Interleave(data, cur, ctx->channels, curOffset);
 
 	ctx->prevBlockSize = ctx->curBlockSize;
 	return (prevQrtr + curQrtr) * ctx->channels;
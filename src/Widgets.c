@@ -59,10 +59,7 @@ static void TextWidget_BuildMesh(void* widget, struct VertexTextured** vertices)
 
 static int TextWidget_Render2(void* widget, int offset) {
 	struct TextWidget* w = (struct TextWidget*)widget;
-	if (w->tex.ID) {
-		Gfx_BindTexture(w->tex.ID);
-		Gfx_DrawVb_IndexedTris_Range(4, offset, DRAW_HINT_RECT);
-	}
+	if (w->tex.ID) Gui_DrawRange(w->tex.ID, 4, offset, DRAW_HINT_RECT);
 	return offset + 4;
 }
 
@@ -214,14 +211,11 @@ static void ButtonWidget_BuildMesh(void* widget, struct VertexTextured** vertice
 
 static int ButtonWidget_Render2(void* widget, int offset) {
 	struct ButtonWidget* w = (struct ButtonWidget*)widget;	
-	Gfx_BindTexture(Gui.ClassicTexture ? Gui.GuiClassicTex : Gui.GuiTex);
+	GfxResourceID tex = Gui.ClassicTexture ? Gui.GuiClassicTex : Gui.GuiTex;
 	/* TODO: Does this 400 need to take DPI into account */
-	Gfx_DrawVb_IndexedTris_Range(w->width >= 400 ? 4 : 8, offset, DRAW_HINT_SPRITE);
+	Gui_DrawRange(tex, w->width >= 400 ? 4 : 8, offset, DRAW_HINT_SPRITE);
 
-	if (w->tex.ID) {
-		Gfx_BindTexture(w->tex.ID);
-		Gfx_DrawVb_IndexedTris_Range(4, offset + 8, DRAW_HINT_SPRITE);
-	}
+	if (w->tex.ID) Gui_DrawRange(w->tex.ID, 4, offset + 8, DRAW_HINT_SPRITE);
 	return offset + 12;
 }
 
@@ -450,9 +444,7 @@ static void HotbarWidget_BuildMesh(void* widget, struct VertexTextured** vertice
 static void HotbarWidget_RenderOutline(struct HotbarWidget* w, int offset) {
 	GfxResourceID tex;
 	tex = Gui.ClassicTexture ? Gui.GuiClassicTex : Gui.GuiTex;
-
-	Gfx_BindTexture(tex);
-	Gfx_DrawVb_IndexedTris_Range(8, offset, DRAW_HINT_SPRITE);
+	Gui_DrawRange(tex, 8, offset, DRAW_HINT_SPRITE);
 }
 
 static void HotbarWidget_RenderEntries(struct HotbarWidget* w, int offset) {
@@ -462,10 +454,12 @@ static void HotbarWidget_RenderEntries(struct HotbarWidget* w, int offset) {
 
 static int HotbarWidget_Render2(void* widget, int offset) {
 	struct HotbarWidget* w = (struct HotbarWidget*)widget;
+	Gui_FlushDraws();
 	Gfx_3DS_SetRenderScreen(BOTTOM_SCREEN);
 
 	HotbarWidget_RenderOutline(w, offset    );
 	HotbarWidget_RenderEntries(w, offset + 8);
+	Gui_FlushDraws();
 
 	if (Gui_TouchUI) {
 		w->ellipsisTex.x = HotbarWidget_TileX(w, HOTBAR_MAX_INDEX) - w->ellipsisTex.width / 2;
@@ -792,6 +786,7 @@ static void TableWidget_BuildMesh(void* widget, struct VertexTextured** vertices
 	i = w->selectedIndex;
 	if (i != -1) {
 		TableWidget_GetCoords(w, i, &x, &y);
+		IsometricDrawer_NextLayer();
 
 		IsometricDrawer_AddBatch(w->blocks[i],
 			w->selBlockSize, x + cellSizeX / 2, y + cellSizeY / 2);
@@ -815,6 +810,7 @@ static int TableWidget_Render2(void* widget, int offset) {
 	PackedCol topSelColor     = PackedCol_Make(255, 255, 255, 142);
 	PackedCol bottomSelColor  = PackedCol_Make(255, 255, 255, 192);
 
+	Gui_FlushDraws();
 	Gfx_Draw2DGradient(Table_X(w), Table_Y(w),
 		Table_Width(w), Table_Height(w), topBackColor, bottomBackColor);
 
@@ -840,6 +836,7 @@ static int TableWidget_Render2(void* widget, int offset) {
 	if (w->verticesCount) {
 		IsometricDrawer_Render(w->verticesCount, offset, w->state);
 	}
+	Gui_FlushDraws();
 	return offset + TABLE_MAX_VERTICES;
 }
 
@@ -1593,13 +1590,11 @@ static void TextInputWidget_BuildMesh(void* widget, struct VertexTextured** vert
 
 static int TextInputWidget_Render2(void* widget, int offset) {
 	struct InputWidget* w = (struct InputWidget*)widget;
-	Gfx_BindTexture(w->inputTex.ID);
-	Gfx_DrawVb_IndexedTris_Range(4, offset, DRAW_HINT_RECT);
+	Gui_DrawRange(w->inputTex.ID, 4, offset, DRAW_HINT_RECT);
 	offset += 4;
 
 	if (w->showCaret && Math_Mod1((float)w->caretAccumulator) < 0.5f) {
-		Gfx_BindTexture(w->caretTex.ID);
-		Gfx_DrawVb_IndexedTris_Range(4, offset, DRAW_HINT_RECT);
+		Gui_DrawRange(w->caretTex.ID, 4, offset, DRAW_HINT_RECT);
 	}
 	return offset + 4;
 }
@@ -2033,7 +2028,9 @@ void TextGroupWidget_ShiftUp(struct TextGroupWidget* w) {
 
 	for (i = 0; i < last; i++) 
 	{
-		w->textures[i] = w->textures[i + 1];
+		w->textures[i]      = w->textures[i + 1];
+		w->glyphLines[i]    = w->glyphLines[i + 1];
+		w->glyphVertices[i] = w->glyphVertices[i + 1];
 	}
 	w->textures[last].ID = 0; /* Gfx_DeleteTexture() called by TextGroupWidget_Redraw otherwise */
 	TextGroupWidget_Redraw(w, last);
@@ -2046,7 +2043,9 @@ void TextGroupWidget_ShiftDown(struct TextGroupWidget* w) {
 
 	for (i = last; i > 0; i--) 
 	{
-		w->textures[i] = w->textures[i - 1];
+		w->textures[i]      = w->textures[i - 1];
+		w->glyphLines[i]    = w->glyphLines[i - 1];
+		w->glyphVertices[i] = w->glyphVertices[i - 1];
 	}
 	w->textures[0].ID = 0; /* Gfx_DeleteTexture() called by TextGroupWidget_Redraw otherwise */
 	TextGroupWidget_Redraw(w, 0);
@@ -2058,7 +2057,7 @@ int TextGroupWidget_UsedHeight(struct TextGroupWidget* w) {
 
 	for (i = 0; i < w->lines; i++) 
 	{
-		if (textures[i].ID) break;
+		if (TextGroupWidget_HasLine(w, i)) break;
 	}
 	for (; i < w->lines; i++) 
 	{
@@ -2288,7 +2287,7 @@ int TextGroupWidget_GetSelected(struct TextGroupWidget* w, cc_string* text, int
 
 	for (i = 0; i < w->lines; i++) 
 	{
-		if (!w->textures[i].ID) continue;
+		if (!TextGroupWidget_HasLine(w, i)) continue;
 		tex = w->textures[i];
 		if (!Gui_Contains(tex.x, tex.y, tex.width, tex.height, x, y)) continue;
 
@@ -2354,6 +2353,33 @@ static void TextGroupWidget_DrawAdvanced(struct TextGroupWidget* w, struct Textu
 	Context2D_Free(&ctx);
 }
 
+static cc_bool TextGroupWidget_HasUrl(struct TextGroupWidget* w, int index) {
+	char chars[GUI_MAX_CHATLINES * TEXTGROUPWIDGET_LEN];
+	struct Portion portions[2 * (TEXTGROUPWIDGET_LEN / TEXTGROUPWIDGET_HTTP_LEN)];
+	int i, portionsCount;
+
+	if (!w->underlineUrls || !TextGroupWidget_MightHaveUrls(w)) return false;
+	portionsCount = TextGroupWidget_Reduce(w, chars, index, portions);
+
+	for (i = 0; i < portionsCount; i++)
+	{
+		if (portions[i].Len & TEXTGROUPWIDGET_URL) return true;
+	}
+	return false;
+}
+
+static cc_bool TextGroupWidget_CanUseGlyphs(struct TextGroupWidget* w, int index, const cc_string* text) {
+	if (!w->glyphs) return false;
+	/* Glyph atlas can't draw underlined text */
+	if (TextGroupWidget_HasUrl(w, index)) return false;
+	return GlyphAtlas_CountQuads(w->glyphs, text) * 4 <= TEXTGROUPWIDGET_MAX_GLYPH_VERTICES;
+}
+
+/* How much of the padding above text is cropped, see Drawer2D_ReducePadding_Tex */
+static int TextGroupWidget_GlyphPadding(struct TextGroupWidget* w, int index) {
+	return (w->glyphs->lineHeight - w->textures[index].height) / 2;
+}
+
 void TextGroupWidget_RedrawAll(struct TextGroupWidget* w) {
 	int i;
 	for (i = 0; i < w->lines; i++) { TextGroupWidget_Redraw(w, i); }
@@ -2364,12 +2390,18 @@ void TextGroupWidget_Redraw(struct TextGroupWidget* w, int index) {
 	struct DrawTextArgs args;
 	struct Texture tex = { 0 };
 	Gfx_DeleteTexture(&w->textures[index].ID);
+	w->glyphLines[index] = false;
 
 	text = TextGroupWidget_UNSAFE_Get(w, index);
 	if (!Drawer2D_IsEmptyText(&text)) {
 		DrawTextArgs_Make(&args, &text, w->font, true);
 
-		if (w->underlineUrls && TextGroupWidget_MightHaveUrls(w)) {
+		if (TextGroupWidget_CanUseGlyphs(w, index, &text)) {
+			/* Quads for the glyphs are created later in TextGroupWidget_BuildMesh */
+			tex.width  = GlyphAtlas_TextWidth(w->glyphs, &text);
+			tex.height = w->glyphs->lineHeight;
+			w->glyphLines[index] = true;
+		} else if (w->underlineUrls && TextGroupWidget_MightHaveUrls(w)) {
 			TextGroupWidget_DrawAdvanced(w, &tex, &args, index, &text);
 		} else {
 			Drawer2D_MakeTextTexture(&tex, &args);
@@ -2438,37 +2470,58 @@ static void TextGroupWidget_Free(void* widget) {
 	for (i = 0; i < w->lines; i++) 
 	{
 		Gfx_DeleteTexture(&w->textures[i].ID);
+		w->glyphLines[i] = false;
 	}
 }
 
 static void TextGroupWidget_BuildMesh(void* widget, struct VertexTextured** vertices) {
 	struct TextGroupWidget* w = (struct TextGroupWidget*)widget;
-	int i;
+	struct Texture* tex;
+	cc_string text;
+	int i, count;
 
 	for (i = 0; i < w->lines; i++)
 	{
-		Gfx_Make2DQuad(&w->textures[i], PACKEDCOL_WHITE, vertices);
+		tex = &w->textures[i];
+		if (!w->glyphLines[i]) {
+			Gfx_Make2DQuad(tex, PACKEDCOL_WHITE, vertices); continue;
+		}
+
+		text  = TextGroupWidget_UNSAFE_Get(w, i);
+		count = GlyphAtlas_CountQuads(w->glyphs, &text) * 4;
+		/* Line might have changed without being redrawn */
+		if (count > TEXTGROUPWIDGET_MAX_GLYPH_VERTICES) count = 0;
+
+		if (count) GlyphAtlas_AddText(w->glyphs, &text, tex->x, 
+								tex->y - TextGroupWidget_GlyphPadding(w, i), vertices);
+		w->glyphVertices[i] = count;
+	}
+}
+
+int TextGroupWidget_RenderLine(struct TextGroupWidget* w, int i, int offset) {
+	if (w->glyphLines[i]) {
+		if (w->glyphVertices[i]) Gui_DrawRange(w->glyphs->texID, w->glyphVertices[i], offset, DRAW_HINT_NONE);
+		return offset + w->glyphVertices[i];
 	}
+
+	if (w->textures[i].ID) Gui_DrawRange(w->textures[i].ID, 4, offset, DRAW_HINT_RECT);
+	return offset + 4;
 }
 
 static int TextGroupWidget_Render2(void* widget, int offset) {
 	struct TextGroupWidget* w = (struct TextGroupWidget*)widget;
-	struct Texture* textures  = w->textures;
 	int i;
 
-	for (i = 0; i < w->lines; i++, offset += 4)
+	for (i = 0; i < w->lines; i++)
 	{
-		if (!textures[i].ID) continue;
-
-		Gfx_BindTexture(textures[i].ID);
-		Gfx_DrawVb_IndexedTris_Range(4, offset, DRAW_HINT_RECT);
+		offset = TextGroupWidget_RenderLine(w, i, offset);
 	}
 	return offset;
 }
 
 static int TextGroupWidget_MaxVertices(void* widget) { 
 	struct TextGroupWidget* w = (struct TextGroupWidget*)widget;
-	return w->lines * 4;
+	return w->lines * (w->glyphs ? TEXTGROUPWIDGET_MAX_GLYPH_VERTICES : 4);
 }
 
 static const struct WidgetVTABLE TextGroupWidget_VTABLE = {
@@ -2819,10 +2872,9 @@ static int ThumbstickWidget_Render2(void* widget, int offset) {
 	int i, base, flags = ThumbstickWidget_CalcDirs(w);
 
 	if (Gui.TouchTex) {
-		Gfx_BindTexture(Gui.TouchTex);
 		for (i = 0; i < 4; i++) {
 			base = (flags & (1 << i)) ? 0 : THUMBSTICKWIDGET_PER;
-			Gfx_DrawVb_IndexedTris_Range(4, offset + base + (i * 4), DRAW_HINT_SPRITE);
+			Gui_DrawRange(Gui.TouchTex, 4, offset + base + (i * 4), DRAW_HINT_SPRITE);
 		}
 	}
 	return offset + THUMBSTICKWIDGET_MAX;
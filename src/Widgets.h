@@ -242,6 +242,8 @@ CC_NOINLINE void ChatInputWidget_SetFont(struct ChatInputWidget* w, struct FontD
 /* Retrieves the text for the i'th line in the group */
 typedef cc_string (*TextGroupWidget_Get)(int i);
 #define TEXTGROUPWIDGET_LEN (STRING_SIZE + (STRING_SIZE / 2))
+/* Max vertices for a line drawn using glyphs (longer lines are drawn to a texture instead) */
+#define TEXTGROUPWIDGET_MAX_GLYPH_VERTICES (STRING_SIZE * 2 * 4)
 
 /* A group of text labels. */
 struct TextGroupWidget {
@@ -253,7 +255,15 @@ struct TextGroupWidget {
 	cc_bool underlineUrls;
 	struct Texture* textures;
 	TextGroupWidget_Get GetLine;
+	/* When not NULL, lines are drawn using this atlas instead of a texture per line */
+	/* NOTE: Such lines are only drawn when rendering using Widget_Render2 */
+	struct GlyphAtlas* glyphs;
+	/* Whether a line is drawn using glyphs, and number of vertices it was last built with */
+	cc_bool glyphLines[GUI_MAX_CHATLINES];
+	cc_uint16 glyphVertices[GUI_MAX_CHATLINES];
 };
+#define TextGroupWidget_HasLine(w, i) ((w)->textures[i].ID || (w)->glyphLines[i])
+#define TextGroupWidget_LineVertices(w, i) ((w)->glyphLines[i] ? (w)->glyphVertices[i] : 4)
 
 CC_NOINLINE void TextGroupWidget_Create(struct TextGroupWidget* w, int lines, struct Texture* textures, TextGroupWidget_Get getLine);
 CC_NOINLINE void TextGroupWidget_Add(void* screen, struct TextGroupWidget* w, int lines, struct Texture* textures, TextGroupWidget_Get getLine);
@@ -273,6 +283,8 @@ CC_NOINLINE int  TextGroupWidget_GetSelected(struct TextGroupWidget* w, cc_strin
 CC_NOINLINE void TextGroupWidget_Redraw(struct TextGroupWidget* w, int index);
 /* Calls TextGroupWidget_Redraw for all lines */
 CC_NOINLINE void TextGroupWidget_RedrawAll(struct TextGroupWidget* w);
+/* Draws the given line, returning the offset of the vertices for the next line */
+CC_NOINLINE int  TextGroupWidget_RenderLine(struct TextGroupWidget* w, int i, int offset);
 /* Calls TextGroupWidget_Redraw for all lines which have the given colour code. */
 /* Typically only called in response to the ChatEvents.ColCodeChanged event. */
 CC_NOINLINE void TextGroupWidget_RedrawAllWithCol(struct TextGroupWidget* w, char col);
@@ -10,9 +10,350 @@
 #include "Game.h"
 #include "TexturePack.h"
 #include "Window.h"
+#include "Deflate.h"
+#include "Stream.h"
+#include "Options.h"
+#include "Errors.h"
 
 struct _WorldData World;
 static char nameBuffer[STRING_SIZE];
+/* Whether any environment settings have been set since the last Env_Reset */
+static cc_bool env_wasSet;
+
+
+/*########################################################################################################################*
+*--------------------------------------------------------Map cache--------------------------------------------------------*
+*#########################################################################################################################*/
+/* The blocks of recently left maps are kept compressed in memory, so that rejoining them */
+/*  keeps the same identity, and servers can switch back to them without resending the map */
+#if defined CC_BUILD_COMPRESSION && !defined CC_BUILD_LOWMEM
+#define MAP_CACHE_MAX_ENTRIES 8
+/* Larger maps take too long to compress when leaving them */
+#define MAP_CACHE_MAX_VOLUME (256 * 256 * 256)
+
+struct MapCacheEntry {
+	cc_uint8 uuid[WORLD_UUID_LEN];
+	int width, height, length;
+	cc_bool hasUpper;
+	cc_bool compressing; /* Whether the background thread is currently reading blocks/upper */
+	cc_uint32 id;        /* Unique ID, for finding the entry again after compressing it */
+	struct _EnvData env;
+	BlockRaw* blocks;    /* Uncompressed blocks, until compressed on the background thread */
+	BlockRaw* upper;
+	cc_uint8* data;      /* Compressed blocks */
+	cc_uint32 size;
+};
+/* Most recently used maps are at the start */
+static struct MapCacheEntry mapCache_entries[MAP_CACHE_MAX_ENTRIES];
+static int mapCache_count, mapCache_max = -1;
+static cc_uint32 mapCache_nextId;
+static void* mapCache_mutex;
+static void* mapCache_waitable;
+static void* mapCache_thread;
+static volatile cc_bool mapCache_stopping;
+/* Identity of the map currently being reloaded from the cache */
+static cc_uint8 mapCache_reloadUuid[WORLD_UUID_LEN];
+static cc_bool mapCache_reloading;
+
+static cc_bool MapCache_HasUpper(void) {
+#ifdef EXTENDED_BLOCKS
+	return World.Blocks2 && World.Blocks2 != World.Blocks;
+#else
+	return false;
+#endif
+}
+
+static void MapCache_Remove(int i) {
+	struct MapCacheEntry* e = &mapCache_entries[i];
+	/* Background thread frees the blocks once it has finished compressing them */
+	if (!e->compressing) { Mem_Free(e->blocks); Mem_Free(e->upper); }
+	Mem_Free(e->data);
+
+	for (; i < mapCache_count - 1; i++) {
+		mapCache_entries[i] = mapCache_entries[i + 1];
+	}
+	mapCache_count--;
+}
+
+static int MapCache_FindId(cc_uint32 id) {
+	int i;
+	for (i = 0; i < mapCache_count; i++) {
+		if (mapCache_entries[i].id == id) return i;
+	}
+	return -1;
+}
+
+static cc_result MapCache_MemoryWrite(struct Stream* s, const cc_uint8* data, cc_uint32 count, cc_uint32* modified) {
+	/* Maps which don't compress well aren't worth caching */
+	if (count > s->meta.mem.left) return ERR_END_OF_STREAM;
+	Mem_Copy(s->meta.mem.cur, data, count);
+
+	s->meta.mem.cur  += count;
+	s->meta.mem.left -= count;
+	*modified = count; return 0;
+}
+
+static cc_result MapCache_Compress(struct MapCacheEntry* e) {
+	struct Stream stream, compStream;
+	struct DeflateState* state;
+	int volume = e->width * e->height * e->length;
+	cc_uint32 size;
+	cc_uint8* data;
+	cc_result res;
+
+	size  = (e->upper ? volume : volume / 2) + 1024;
+	state = (struct DeflateState*)Mem_TryAlloc(1, sizeof(struct DeflateState));
+	data  = (cc_uint8*)Mem_TryAlloc(size, 1);
+	if (!state || !data) { Mem_Free(state); Mem_Free(data); return ERR_OUT_OF_MEMORY; }
+
+	Stream_Init(&stream);
+	stream.Write = MapCache_MemoryWrite;
+	stream.meta.mem.cur    = data;
+	stream.meta.mem.base   = data;
+	stream.meta.mem.left   = size;
+	stream.meta.mem.length = size;
+	Deflate_MakeStream(&compStream, state, &stream);
+
+	res = Stream_Write(&compStream, e->blocks, volume);
+	if (!res && e->upper) res = Stream_Write(&compStream, e->upper, volume);
+	if (!res) res = compStream.Close(&compStream);
+	Mem_Free(state);
+
+	if (!res) {
+		e->size = size - stream.meta.mem.left;
+		e->data = (cc_uint8*)Mem_TryAlloc(e->size, 1);
+
+		if (e->data) { Mem_Copy(e->data, data, e->size); } 
+		else { res = ERR_OUT_OF_MEMORY; }
+	}
+	Mem_Free(data);
+	return res;
+}
+
+/* Compresses the given entry, then stores the result into the cache */
+static void MapCache_CompressEntry(struct MapCacheEntry* job) {
+	struct MapCacheEntry* e;
+	cc_result res;
+	int i;
+
+	res = MapCache_Compress(job);
+
+	Mutex_Lock(mapCache_mutex);
+	{
+		i = MapCache_FindId(job->id);
+		if (i >= 0) {
+			e = &mapCache_entries[i];
+			e->compressing = false;
+
+			if (res) {
+				MapCache_Remove(i);
+			} else {
+				e->data = job->data; job->data = NULL;
+				e->size = job->size;
+				Mem_Free(e->blocks); e->blocks = NULL;
+				Mem_Free(e->upper);  e->upper  = NULL;
+			}
+		} else {
+			/* Entry was evicted or reloaded while being compressed */
+			Mem_Free(job->blocks);
+			Mem_Free(job->upper);
+		}
+	}
+	Mutex_Unlock(mapCache_mutex);
+	Mem_Free(job->data);
+}
+
+/* Compresses all the entries which are still uncompressed */
+static void MapCache_CompressAll(void) {
+	struct MapCacheEntry job;
+	cc_bool found;
+	int i;
+
+	while (!mapCache_stopping) {
+		Mutex_Lock(mapCache_mutex);
+		{
+			for (i = 0, found = false; i < mapCache_count && !found; i++) {
+				if (!mapCache_entries[i].blocks || mapCache_entries[i].compressing) continue;
+
+				mapCache_entries[i].compressing = true;
+				job   = mapCache_entries[i];
+				found = true;
+			}
+		}
+		Mutex_Unlock(mapCache_mutex);
+
+		if (!found) return;
+		MapCache_CompressEntry(&job);
+	}
+}
+
+static void MapCache_RunWorker(void) {
+	for (;;)
+	{
+		MapCache_CompressAll();
+		if (mapCache_stopping) break;
+		Waitable_Wait(mapCache_waitable);
+	}
+}
+
+/* Hands the blocks of the current map over to the cache, */
+/*  which are then compressed on a background thread */
+static void MapCache_Add(void) {
+	struct MapCacheEntry e = { 0 };
+	int i;
+
+	if (mapCache_max == -1) {
+		mapCache_max = Options_GetInt(OPT_MAP_CACHE_COUNT, 0, MAP_CACHE_MAX_ENTRIES, 3);
+	}
+	if (!mapCache_max || !mapCache_mutex || !World.Loaded || !World.Blocks) return;
+	if (World.Volume > MAP_CACHE_MAX_VOLUME) return;
+
+	Mem_Copy(e.uuid, World.Uuid, WORLD_UUID_LEN);
+	e.width    = World.Width;
+	e.height   = World.Height;
+	e.length   = World.Length;
+	e.hasUpper = MapCache_HasUpper();
+	e.id       = ++mapCache_nextId;
+	e.env      = Env;
+
+	/* Take ownership of the blocks, so World_Reset doesn't free them */
+	e.blocks     = World.Blocks;
+	World.Blocks = NULL;
+#ifdef EXTENDED_BLOCKS
+	if (e.hasUpper) e.upper = World.Blocks2;
+	World.Blocks2 = NULL;
+#endif
+
+	Mutex_Lock(mapCache_mutex);
+	{
+		/* Evict least recently used map */
+		if (mapCache_count == mapCache_max) MapCache_Remove(mapCache_count - 1);
+
+		for (i = mapCache_count; i > 0; i--) {
+			mapCache_entries[i] = mapCache_entries[i - 1];
+		}
+		mapCache_entries[0] = e;
+		mapCache_count++;
+	}
+	Mutex_Unlock(mapCache_mutex);
+
+	if (!mapCache_thread) {
+		mapCache_stopping = false;
+		Thread_Run(&mapCache_thread, MapCache_RunWorker, 64 * 1024, "Map cache");
+	}
+	if (mapCache_thread) { Waitable_Signal(mapCache_waitable); return; }
+
+	/* Platform doesn't support threads, so compress it now */
+	MapCache_CompressAll();
+}
+
+/* Reuses the identity of the map being reloaded from the cache, so it is still recognised when rejoined */
+static cc_bool MapCache_TakeUuid(void) {
+	if (!mapCache_reloading) return false;
+	mapCache_reloading = false;
+
+	Mem_Copy(World.Uuid, mapCache_reloadUuid, WORLD_UUID_LEN);
+	return true;
+}
+
+static cc_result MapCache_Decompress(struct MapCacheEntry* e, BlockRaw* blocks, BlockRaw* upper, int volume) {
+	struct Stream stream, compStream;
+	struct InflateState* state;
+	cc_result res;
+
+	/* Still being compressed, so copy the blocks instead */
+	if (e->blocks) {
+		Mem_Copy(blocks, e->blocks, volume);
+		if (upper) Mem_Copy(upper, e->upper, volume);
+		return 0;
+	}
+
+	state = (struct InflateState*)Mem_TryAlloc(1, sizeof(struct InflateState));
+	if (!state) return ERR_OUT_OF_MEMORY;
+
+	Stream_ReadonlyMemory(&stream, e->data, e->size);
+	Inflate_MakeStream2(&compStream, state, &stream);
+
+	res = Stream_Read(&compStream, blocks, volume);
+	if (!res && upper) res = Stream_Read(&compStream, upper, volume);
+
+	Mem_Free(state);
+	return res;
+}
+
+cc_bool World_LoadCachedMap(const cc_uint8* uuid, int width, int height, int length) {
+	struct MapCacheEntry* e;
+	struct _EnvData env;
+	BlockRaw* blocks = NULL;
+	BlockRaw* upper  = NULL;
+	int i, volume;
+	cc_result res = ERR_NOT_SUPPORTED;
+	if (!mapCache_mutex) return false;
+
+	Mutex_Lock(mapCache_mutex);
+	for (i = 0; i < mapCache_count; i++) {
+		e = &mapCache_entries[i];
+		if (!Mem_Equal(e->uuid, uuid, WORLD_UUID_LEN)) continue;
+		if (width && (e->width != width || e->height != height || e->length != length)) continue;
+
+		width  = e->width; height = e->height; length = e->length;
+		volume = width * height * length;
+		env    = e->env;
+
+		blocks = (BlockRaw*)Mem_TryAlloc(volume, 1);
+		if (e->hasUpper) upper = (BlockRaw*)Mem_TryAlloc(volume, 1);
+
+		if (!blocks || (e->hasUpper && !upper)) {
+			res = ERR_OUT_OF_MEMORY;
+		} else {
+			res = MapCache_Decompress(e, blocks, upper, volume);
+		}
+		if (!res) MapCache_Remove(i);
+		break;
+	}
+	Mutex_Unlock(mapCache_mutex);
+	if (res) { Mem_Free(blocks); Mem_Free(upper); return false; }
+
+	/* Environment settings the server sent while the map was loading take priority */
+	if (!env_wasSet) Env = env;
+#ifdef EXTENDED_BLOCKS
+	if (upper) World_SetMapUpper(upper);
+#endif
+	Mem_Copy(mapCache_reloadUuid, uuid, WORLD_UUID_LEN);
+	mapCache_reloading = true;
+	World_SetNewMap(blocks, width, height, length);
+	return true;
+}
+
+static void MapCache_Init(void) {
+	mapCache_mutex    = Mutex_Create("Map cache");
+	mapCache_waitable = Waitable_Create("Map cache wait");
+}
+
+static void MapCache_Free(void) {
+	mapCache_stopping = true;
+	if (mapCache_thread) {
+		Waitable_Signal(mapCache_waitable);
+		Thread_Join(mapCache_thread);
+	}
+	mapCache_thread = NULL;
+
+	while (mapCache_count) MapCache_Remove(0);
+	Mutex_Free(mapCache_mutex);
+	Waitable_Free(mapCache_waitable);
+	mapCache_mutex    = NULL;
+	mapCache_waitable = NULL;
+}
+#else
+static void MapCache_Add(void) { }
+static cc_bool MapCache_TakeUuid(void) { return false; }
+static void MapCache_Init(void) { }
+static void MapCache_Free(void) { }
+
+cc_bool World_LoadCachedMap(const cc_uint8* uuid, int width, int height, int length) { return false; }
+#endif
+
+
 /*########################################################################################################################*
 *----------------------------------------------------------World----------------------------------------------------------*
 *#########################################################################################################################*/
@@ -38,6 +379,7 @@ static void GenerateNewUuid(void) {
 }
 
 void World_Reset(void) {
+	MapCache_Add();
 #ifdef EXTENDED_BLOCKS
 	if (World.Blocks != World.Blocks2) Mem_Free(World.Blocks2);
 	World.Blocks2 = NULL;
@@ -79,7 +421,7 @@ void World_SetNewMap(BlockRaw* blocks, int width, int height, int length) {
 	if (Env.EdgeHeight == -1)   { Env.EdgeHeight   = height / 2; }
 	if (Env.CloudsHeight == -1) { Env.CloudsHeight = height + 2; }
 
-	GenerateNewUuid();
+	if (!World.Blocks || !MapCache_TakeUuid()) GenerateNewUuid();
 	World.Loaded = true;
 	Event_RaiseVoid(&WorldEvents.MapLoaded);
 }
@@ -156,12 +498,13 @@ BlockID World_SafeGetBlock(int x, int y, int z) {
 *-------------------------------------------------------Environment-------------------------------------------------------*
 *#########################################################################################################################*/
 #define Env_Set(src, dst, var) \
-if (src != dst) { dst = src; Event_RaiseInt(&WorldEvents.EnvVarChanged, var); }
+env_wasSet = true; if (src != dst) { dst = src; Event_RaiseInt(&WorldEvents.EnvVarChanged, var); }
 
 struct _EnvData Env;
 const char* const Weather_Names[3] = { "Sunny", "Rainy", "Snowy" };
 
 void Env_Reset(void) {
+	env_wasSet = false;
 	Env.EdgeHeight   = -1;
 	Env.SidesOffset  = -2;
 	Env.CloudsHeight = -1;
@@ -320,7 +663,18 @@ Vec3 Respawn_FindSpawnPosition(float x, float z, Vec3 modelSize) {
 	return spawn;
 }
 
+static void OnInit(void) {
+	MapCache_Init();
+	World_Reset();
+}
+
+static void OnFree(void) {
+	/* Don't bother caching the map when closing the game */
+	MapCache_Free();
+	World_Reset();
+}
+
 struct IGameComponent World_Component = {
-	World_Reset, /* Init  */
-	World_Reset  /* Free  */
+	OnInit, /* Init  */
+	OnFree  /* Free  */
 };
@@ -70,6 +70,9 @@ CC_API void World_NewMap(void);
 /* Sets blocks array/dimensions of the map and raises WorldEvents.MapLoaded event */
 /* May also sets some environment settings like border/clouds height, if they are -1 */
 CC_API void World_SetNewMap(BlockRaw* blocks, int width, int height, int length);
+/* Attempts to reload a recently left map from the in-memory cache of maps, and then raises WorldEvents.MapLoaded */
+/* The cached map must have the given uuid, and also the given dimensions unless width is 0 */
+CC_API cc_bool World_LoadCachedMap(const cc_uint8* uuid, int width, int height, int length);
 /* Sets the various dimension and max coordinate related variables. */
 /* NOTE: This is an internal API. Use World_SetNewMap instead. */
 CC_NOINLINE void World_SetDimensions(int width, int height, int length);
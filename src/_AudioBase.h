@@ -4,6 +4,7 @@
 #include "Errors.h"
 #include "Utils.h"
 #include "Platform.h"
+#include "Funcs.h"
 
 void Audio_Warn(cc_result res, const char* action) {
 	Logger_Warn(res, action, Audio_DescribeError);
@@ -114,10 +115,303 @@ void AudioBackend_LoadSounds(void) { Sounds_LoadDefault(); }
 *---------------------------------------------------Audio context code----------------------------------------------------*
 *#########################################################################################################################*/
 struct AudioContext music_ctx;
+
+#if defined AUDIO_SOFTWARE_MIXER && !defined CC_BUILD_NOSOUNDS
+/*########################################################################################################################*
+*-------------------------------------------------------Software mixer----------------------------------------------------*
+*#########################################################################################################################*/
+/* All sounds are mixed together on a dedicated thread into a single stereo output stream */
+/* This avoids needing to recreate backend contexts whenever a sound has a different format */
+/* Voices are stored in fixed size arrays, so playing a sound never allocates memory */
+/*  When full, the quietest voice is replaced instead */
+#define MIXER_MAX_VOICES  48
+#define MIXER_MAX_PENDING 16
+#define MIXER_BUFFERS      3
+#define MIXER_FRAMES    1024
+#define MIXER_CHANNELS     2
+#define MIXER_SAMPLE_RATE 44100
+
+struct MixerVoice {
+	const cc_int16* samples;
+	cc_uint32 frames;  /* Number of frames (i.e. samples per channel) */
+	int channels;
+	int gain;          /* Volume, in 8.8 fixed point */
+	cc_uint64 pos;     /* Current frame, in 48.16 fixed point */
+	cc_uint32 step;    /* Frames advanced per output frame, in 16.16 fixed point */
+};
+
+/* Voices queued by main thread, but not yet seen by the mixer thread (protected by mixer_mutex) */
+static struct MixerVoice mixer_pending[MIXER_MAX_PENDING];
+static int mixer_numPending;
+/* Voices currently being mixed (only accessed by the mixer thread) */
+static struct MixerVoice mixer_voices[MIXER_MAX_VOICES];
+static int mixer_numVoices;
+/* Samples the mixer thread may currently be reading from (protected by mixer_mutex) */
+static const void* mixer_using[MIXER_MAX_VOICES];
+static int mixer_numUsing;
+
+static struct AudioContext mixer_ctx;
+static struct AudioChunk mixer_chunks[MIXER_BUFFERS];
+static cc_int32 mixer_accum[MIXER_FRAMES * MIXER_CHANNELS];
+static void* mixer_thread;
+static void* mixer_mutex;
+static void* mixer_waitable;
+static volatile cc_bool mixer_stopping;
+static volatile cc_result mixer_result;
+
+/* Finds the voice to replace when full, i.e. the quietest voice */
+/*  (or when equally quiet, the one that has been playing the longest) */
+static int Mixer_FindStealable(struct MixerVoice* voices, int count) {
+	int i, best = 0;
+
+	for (i = 1; i < count; i++) 
+	{
+		if (voices[i].gain > voices[best].gain) continue;
+		if (voices[i].gain < voices[best].gain || voices[i].pos > voices[best].pos) best = i;
+	}
+	return best;
+}
+
+static struct MixerVoice* Mixer_NextVoice(struct MixerVoice* voices, int* count, int max) {
+	if (*count < max) return &voices[(*count)++];
+	return &voices[Mixer_FindStealable(voices, *count)];
+}
+
+/* Moves queued voices into the mixed voices, and publishes which samples are being mixed */
+/* NOTE: Voices that finished last mix are only unpublished here, after they are no longer read */
+static void Mixer_Sync(void) {
+	int i;
+	Mutex_Lock(mixer_mutex);
+	{
+		for (i = 0; i < mixer_numPending; i++) 
+		{
+			*Mixer_NextVoice(mixer_voices, &mixer_numVoices, MIXER_MAX_VOICES) = mixer_pending[i];
+		}
+		mixer_numPending = 0;
+
+		for (i = 0; i < mixer_numVoices; i++) 
+		{
+			mixer_using[i] = mixer_voices[i].samples;
+		}
+		mixer_numUsing = mixer_numVoices;
+	}
+	Mutex_Unlock(mixer_mutex);
+}
+
+/* Mixes the given voice into the accumulation buffer, returning false once the voice has finished */
+static cc_bool Mixer_MixVoice(struct MixerVoice* v, cc_int32* CC_RESTRICT dst, int frames) {
+	const cc_int16* CC_RESTRICT src;
+	cc_uint32 idx, next, frac;
+	int i, count, gain = v->gain;
+	cc_int32 l, r;
+
+	idx = (cc_uint32)(v->pos >> 16);
+	if (idx >= v->frames) return false;
+
+	/* Most sounds are mono and played at the output rate, so can be mixed very quickly */
+	if (v->step == 0x10000 && !(v->pos & 0xFFFF) && v->channels == 1) {
+		count = (int)min((cc_uint32)frames, v->frames - idx);
+		src   = v->samples + idx;
+
+		for (i = 0; i < count; i++) 
+		{
+			l = src[i] * gain;
+			dst[i * 2 + 0] += l;
+			dst[i * 2 + 1] += l;
+		}
+		v->pos += (cc_uint64)count << 16;
+		return idx + count < v->frames;
+	}
+
+	/* Otherwise linearly interpolate between the two nearest frames */
+	for (i = 0; i < frames; i++) 
+	{
+		idx = (cc_uint32)(v->pos >> 16);
+		if (idx >= v->frames) return false;
+		next = idx + 1 < v->frames ? idx + 1 : idx;
+		frac = (cc_uint32)(v->pos & 0xFFFF);
+
+		if (v->channels == 1) {
+			l = v->samples[idx];
+			l = l + (((v->samples[next] - l) * (cc_int32)frac) >> 16);
+			r = l;
+		} else {
+			l = v->samples[idx * 2 + 0];
+			r = v->samples[idx * 2 + 1];
+			l = l + (((v->samples[next * 2 + 0] - l) * (cc_int32)frac) >> 16);
+			r = r + (((v->samples[next * 2 + 1] - r) * (cc_int32)frac) >> 16);
+		}
+
+		dst[i * 2 + 0] += l * gain;
+		dst[i * 2 + 1] += r * gain;
+		v->pos += v->step;
+	}
+	return (cc_uint32)(v->pos >> 16) < v->frames;
+}
+
+static void Mixer_Output(cc_int16* CC_RESTRICT dst, const cc_int32* CC_RESTRICT src, int count) {
+	cc_int32 value;
+	int i;
+
+	for (i = 0; i < count; i++) 
+	{
+		value  = src[i] >> 8;
+		value  = value < -32768 ? -32768 : value;
+		dst[i] = value > 32767 ? 32767 : value;
+	}
+}
+
+static void Mixer_Fill(struct AudioChunk* chunk) {
+	int i;
+	Mem_Set(mixer_accum, 0, sizeof(mixer_accum));
+
+	/* Samples of all these voices are in mixer_using, so main thread won't free them */
+	for (i = 0; i < mixer_numVoices; ) 
+	{
+		if (Mixer_MixVoice(&mixer_voices[i], mixer_accum, MIXER_FRAMES)) { i++; continue; }
+
+		/* Voice finished playing, so remove it */
+		mixer_voices[i] = mixer_voices[--mixer_numVoices];
+	}
+
+	Mixer_Output((cc_int16*)chunk->data, mixer_accum, MIXER_FRAMES * MIXER_CHANNELS);
+	chunk->size = MIXER_FRAMES * MIXER_CHANNELS * 2;
+}
+
+static cc_result Mixer_Update(int* inUse) {
+	cc_result res;
+	int prev;
+	*inUse = MIXER_BUFFERS + 1;
+
+	/* Some backends only release one finished buffer per update */
+	do {
+		prev = *inUse;
+		if ((res = StreamContext_Update(&mixer_ctx, inUse))) return res;
+	} while (*inUse > 0 && *inUse < prev);
+	return 0;
+}
+
+static void Mixer_RunLoop(void) {
+	int inUse, cur = 0;
+	cc_result res = 0;
+
+	while (!mixer_stopping) {
+		Mixer_Sync();
+		if ((res = Mixer_Update(&inUse))) break;
+
+		if (!mixer_numVoices) {
+			/* Nothing to mix, so sleep until another sound is played */
+			Waitable_Wait(mixer_waitable); continue;
+		}
+		if (inUse >= MIXER_BUFFERS) {
+			Waitable_WaitFor(mixer_waitable, 5); continue;
+		}
+
+		Mixer_Fill(&mixer_chunks[cur]);
+		if ((res = StreamContext_Enqueue(&mixer_ctx, &mixer_chunks[cur]))) break;
+		cur = (cur + 1) % MIXER_BUFFERS;
+
+		/* Output stream stops once it has run out of queued data */
+		if (!inUse && (res = StreamContext_Play(&mixer_ctx))) break;
+	}
+
+	if (!mixer_stopping) mixer_result = res;
+}
+
+static cc_result Mixer_Init(void) {
+	cc_result res;
+	if ((res = Audio_Init(&mixer_ctx, MIXER_BUFFERS))) return res;
+	if ((res = StreamContext_SetFormat(&mixer_ctx, MIXER_CHANNELS, MIXER_SAMPLE_RATE, 100))) return res;
+	if ((res = Audio_AllocChunks(MIXER_FRAMES * MIXER_CHANNELS * 2, mixer_chunks, MIXER_BUFFERS))) return res;
+	/* Volume is applied per voice when mixing instead */
+	Audio_SetVolume(&mixer_ctx, 100);
+
+	mixer_numPending = 0;
+	mixer_numVoices  = 0;
+	mixer_numUsing   = 0;
+	mixer_stopping   = false;
+	mixer_result     = 0;
+
+	mixer_mutex    = Mutex_Create("Audio mixer");
+	mixer_waitable = Waitable_Create("Audio mixer wait");
+	Thread_Run(&mixer_thread, Mixer_RunLoop, 64 * 1024, "Audio mixer");
+	return 0;
+}
+
+/* NOTE: Only the first call allocates anything, after that this is just a few assignments */
+/*  while briefly holding mixer_mutex, which the mixer thread never holds while mixing */
+cc_result AudioPool_Play(struct AudioData* data) {
+	struct MixerVoice* voice;
+	cc_uint64 step;
+	cc_result res;
+
+	if (!mixer_thread && (res = Mixer_Init())) return res;
+	if (mixer_result) return mixer_result;
+	if (data->channels != 1 && data->channels != 2) return ERR_INVALID_ARGUMENT;
+
+	step = (cc_uint64)Audio_AdjustSampleRate(data->sampleRate, data->rate) << 16;
+	step /= MIXER_SAMPLE_RATE;
+
+	Mutex_Lock(mixer_mutex);
+	{
+		voice = Mixer_NextVoice(mixer_pending, &mixer_numPending, MIXER_MAX_PENDING);
+		voice->samples  = (const cc_int16*)data->chunk.data;
+		voice->frames   = data->chunk.size / (2 * data->channels);
+		voice->channels = data->channels;
+		voice->gain     = data->volume * 256 / 100;
+		voice->pos      = 0;
+		voice->step     = (cc_uint32)step;
+	}
+	Mutex_Unlock(mixer_mutex);
+
+	Waitable_Signal(mixer_waitable);
+	return 0;
+}
+
+int AudioPool_GetUsing(const void** samples) {
+	int i, count = 0;
+	if (!mixer_thread) return 0;
+
+	Mutex_Lock(mixer_mutex);
+	{
+		for (i = 0; i < mixer_numPending; i++) 
+		{
+			samples[count++] = mixer_pending[i].samples;
+		}
+		for (i = 0; i < mixer_numUsing; i++) 
+		{
+			samples[count++] = mixer_using[i];
+		}
+	}
+	Mutex_Unlock(mixer_mutex);
+	return count;
+}
+
+void AudioPool_Close(void) {
+	if (!mixer_thread) return;
+
+	mixer_stopping = true;
+	Waitable_Signal(mixer_waitable);
+	Thread_Join(mixer_thread);
+	mixer_thread = NULL;
+
+	/* Must be closed before freeing chunks, as backend may still be reading from them */
+	Audio_Close(&mixer_ctx);
+	Audio_FreeChunks(mixer_chunks, MIXER_BUFFERS);
+	Mutex_Free(mixer_mutex);
+	Waitable_Free(mixer_waitable);
+
+	mixer_numPending = 0;
+	mixer_numVoices  = 0;
+	mixer_numUsing   = 0;
+}
+#else
 #ifndef POOL_MAX_CONTEXTS
 #define POOL_MAX_CONTEXTS 8
 #endif
 static struct AudioContext context_pool[POOL_MAX_CONTEXTS];
+/* Samples last played on each context (backend may still be reading from them) */
+static const void* context_samples[POOL_MAX_CONTEXTS];
 
 #ifndef CC_BUILD_NOSOUNDS
 cc_result AudioPool_Play(struct AudioData* data) {
@@ -137,6 +431,7 @@ cc_result AudioPool_Play(struct AudioData* data) {
 		if (!SoundContext_FastPlay(ctx, data)) continue;
 
 		Audio_SetVolume(ctx, data->volume);
+		context_samples[i] = data->chunk.data;
 		return SoundContext_PlayData(ctx, data);
 	}
 
@@ -150,16 +445,36 @@ cc_result AudioPool_Play(struct AudioData* data) {
 		if (isBusy) continue;
 
 		Audio_SetVolume(ctx, data->volume);
+		context_samples[i] = data->chunk.data;
 		return SoundContext_PlayData(ctx, data);
 	}
 	return 0;
 }
 
+int AudioPool_GetUsing(const void** samples) {
+	cc_bool isBusy;
+	int i, count = 0;
+
+	for (i = 0; i < POOL_MAX_CONTEXTS && count < AUDIOPOOL_MAX_USING; i++)
+	{
+		if (!context_samples[i]) continue;
+		/* Assume still in use when unable to tell */
+		if (SoundContext_PollBusy(&context_pool[i], &isBusy) || isBusy) {
+			samples[count++] = context_samples[i];
+		} else {
+			context_samples[i] = NULL;
+		}
+	}
+	return count;
+}
+
 void AudioPool_Close(void) {
 	int i;
 	for (i = 0; i < POOL_MAX_CONTEXTS; i++)
 	{
 		Audio_Close(&context_pool[i]);
+		context_samples[i] = NULL;
 	}
 }
 #endif
+#endif
@@ -317,40 +317,54 @@ void Gfx_CalcPerspectiveMatrix(struct Matrix* matrix, float fov, float aspect, f
 /*########################################################################################################################*
 *-----------------------------------------------------------Misc----------------------------------------------------------*
 *#########################################################################################################################*/
-static BitmapCol* GL_GetRow(struct Bitmap* bmp, int y, void* ctx) { 
-	/* OpenGL stores bitmap in bottom-up order, so flip order when saving */
-	return Bitmap_GetRow(bmp, (bmp->height - 1) - y); 
+/* OpenGL stores bitmap in bottom-up order, so flip rows to make it top-down */
+static void GL_FlipRows(struct Bitmap* bmp, BitmapCol* tmp) {
+	int y, stride = bmp->width * BITMAPCOLOR_SIZE;
+	BitmapCol* a;
+	BitmapCol* b;
+
+	for (y = 0; y < bmp->height / 2; y++)
+	{
+		a = Bitmap_GetRow(bmp, y);
+		b = Bitmap_GetRow(bmp, (bmp->height - 1) - y);
+		Mem_Copy(tmp, a, stride);
+		Mem_Copy(a,   b, stride);
+		Mem_Copy(b, tmp, stride);
+	}
 }
-cc_result Gfx_TakeScreenshot(struct Stream* output) {
-	struct Bitmap bmp;
-	cc_result res;
+
+cc_result Gfx_ReadScreenshot(struct Bitmap* bmp) {
+	BitmapCol* tmp;
 	GLint vp[4];
 	
 	_glGetIntegerv(GL_VIEWPORT, vp); /* { x, y, width, height } */
-	bmp.width  = vp[2]; 
-	bmp.height = vp[3];
+	bmp->width  = vp[2]; 
+	bmp->height = vp[3];
 
-	bmp.scan0  = (BitmapCol*)Mem_TryAlloc(bmp.width * bmp.height, BITMAPCOLOR_SIZE);
-	if (!bmp.scan0) return ERR_OUT_OF_MEMORY;
+	bmp->scan0  = (BitmapCol*)Mem_TryAlloc(bmp->width * bmp->height, BITMAPCOLOR_SIZE);
+	if (!bmp->scan0) return ERR_OUT_OF_MEMORY;
 #if defined CC_BUILD_SYMBIAN
-	_glReadPixels(0, 0, bmp.width, bmp.height, GL_RGBA, TRANSFER_FORMAT, bmp.scan0);
+	_glReadPixels(0, 0, bmp->width, bmp->height, GL_RGBA, TRANSFER_FORMAT, bmp->scan0);
 	/* ??? */
 	if (convert_rgba) {
-		BitmapCol* tmp = (BitmapCol*)Mem_TryAlloc(bmp.width * bmp.height, BITMAPCOLOR_SIZE);
-		if (!tmp) return ERR_OUT_OF_MEMORY;
+		tmp = (BitmapCol*)Mem_TryAlloc(bmp->width * bmp->height, BITMAPCOLOR_SIZE);
+		if (!tmp) { Mem_Free(bmp->scan0); return ERR_OUT_OF_MEMORY; }
 		
-		ConvertRGBA(tmp, bmp.scan0, bmp.width * bmp.height);
+		ConvertRGBA(tmp, bmp->scan0, bmp->width * bmp->height);
 		
-		Mem_Free(bmp.scan0);
-		bmp.scan0 = tmp;
+		Mem_Free(bmp->scan0);
+		bmp->scan0 = tmp;
 	}
 #else
-	_glReadPixels(0, 0, bmp.width, bmp.height, PIXEL_FORMAT, TRANSFER_FORMAT, bmp.scan0);
+	_glReadPixels(0, 0, bmp->width, bmp->height, PIXEL_FORMAT, TRANSFER_FORMAT, bmp->scan0);
 #endif
 
-	res = Png_Encode(&bmp, output, GL_GetRow, false, NULL);
-	Mem_Free(bmp.scan0);
-	return res;
+	tmp = (BitmapCol*)Mem_TryAlloc(bmp->width, BITMAPCOLOR_SIZE);
+	if (!tmp) { Mem_Free(bmp->scan0); return ERR_OUT_OF_MEMORY; }
+
+	GL_FlipRows(bmp, tmp);
+	Mem_Free(tmp);
+	return 0;
 }
 
 static void AppendVRAMStats(cc_string* info) {
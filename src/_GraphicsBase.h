@@ -290,6 +290,18 @@ void Gfx_RestoreAlphaState(cc_uint8 draw) {
 	if (draw == DRAW_SPRITE)            Gfx_SetAlphaTest(false);
 }
 
+#ifdef CC_BUILD_GFXREADBACK
+cc_result Gfx_TakeScreenshot(struct Stream* output) {
+	struct Bitmap bmp;
+	cc_result res = Gfx_ReadScreenshot(&bmp);
+	if (res) return res;
+
+	res = Png_Encode(&bmp, output, NULL, false, NULL);
+	Mem_Free(bmp.scan0);
+	return res;
+}
+#endif
+
 static CC_INLINE float Reversed_CalcZNear(float fov, int depthbufferBits) {
 	/* With reversed z depth, near Z plane can be much closer (with sufficient depth buffer precision) */
 	/*   This reduces clipping with high FOV without sacrificing depth precision for faraway objects */
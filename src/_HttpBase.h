@@ -42,22 +42,23 @@ static void RequestList_EnsureSpace(struct RequestList* list) {
 				sizeof(struct HttpRequest), HTTP_DEF_ELEMS, 10);
 }
 
-/* Adds a request to the list */
+/* Adds a request to the list, keeping the list sorted by priority class */
 static void RequestList_Append(struct RequestList* list, struct HttpRequest* item, cc_uint8 flags) {
-	int i;
+	int i, j;
 	RequestList_EnsureSpace(list);
 
 	if (flags & HTTP_FLAG_PRIORITY) {
-		/* Shift all requests right one place */
-		for (i = list->count; i > 0; i--) 
-		{
-			HttpRequest_Copy(&list->entries[i], &list->entries[i - 1]);
-		}
-		/* Insert new request at front/start */
-		i = 0;
+		/* Insert new request at front/start of its priority class */
+		for (i = 0; i < list->count && list->entries[i].priority < item->priority; i++) { }
 	} else {
-		/* Insert new request at end */
-		i = list->count;
+		/* Insert new request at end of its priority class */
+		for (i = list->count; i > 0 && list->entries[i - 1].priority > item->priority; i--) { }
+	}
+
+	/* Shift all later requests right one place */
+	for (j = list->count; j > i; j--) 
+	{
+		HttpRequest_Copy(&list->entries[j], &list->entries[j - 1]);
 	}
 
 	HttpRequest_Copy(&list->entries[i], item);
@@ -243,6 +244,13 @@ static struct RequestList processedReqs;
 static int nextReqID;
 static void HttpBackend_Add(struct HttpRequest* req, cc_uint8 flags);
 
+static cc_uint8 Http_GetPriority(cc_uint8 flags) {
+	if (flags & HTTP_FLAG_TEXTURE_PACK) return 0;
+	if (flags & HTTP_FLAG_MAP_ENV)      return 1;
+	if (flags & HTTP_FLAG_SKIN)         return 3;
+	return 2;
+}
+
 /* Adds a req to the list of pending requests, waking up worker thread if needed. */
 static int Http_Add(const cc_string* url, cc_uint8 flags, cc_uint8 type, const cc_string* lastModified,
 					const cc_string* etag, const void* data, cc_uint32 size, struct StringsBuffer* cookies) {
@@ -255,6 +263,8 @@ static int Http_Add(const cc_string* url, cc_uint8 flags, cc_uint8 type, const c
 
 	req.id = ++nextReqID;
 	req.requestType = type;
+	req.priority    = Http_GetPriority(flags);
+	req.flags       = flags;
 
 	/* Change http:// to https:// if required */
 	if (httpsOnly) {
@@ -340,7 +350,7 @@ int Http_AsyncGetSkin(const cc_string* skinName, cc_uint8 flags) {
 	} else {
 		String_Format2(&url, "%s/%s.png", &skinServer, skinName);
 	}
-	return Http_AsyncGetData(&url, flags);
+	return Http_AsyncGetData(&url, flags | HTTP_FLAG_SKIN | HTTP_FLAG_CACHE);
 }
 
 int Http_AsyncGetData(const cc_string* url, cc_uint8 flags) {
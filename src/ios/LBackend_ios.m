@@ -657,12 +657,13 @@ void LBackend_TableFlagAdded(struct LTable* w) {
 /*########################################################################################################################*
  *------------------------------------------------------UI Backend--------------------------------------------------------*
  *#########################################################################################################################*/
-void LBackend_DecodeFlag(struct Flag* flag, cc_uint8* data, cc_uint32 len) {
+cc_result LBackend_DecodeFlag(struct Flag* flag, cc_uint8* data, cc_uint32 len) {
     NSData* ns_data = [NSData dataWithBytes:data length:len];
     UIImage* img = [UIImage imageWithData:ns_data];
-    if (!img) return;
+    if (!img) return ERR_INVALID_ARGUMENT;
     
 	flag->meta = (void*)[img retain]; // TODO this leaks memory as it is never freed by LWeb.c
+    return 0;
 }
 
 static void LBackend_LayoutDimensions(struct LWidget* w, CGRect* r) {
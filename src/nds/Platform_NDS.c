@@ -259,6 +259,11 @@ int File_Exists(const cc_filepath* path) {
 	return attribs >= 0 && (attribs & ATTR_DIRECTORY) == 0;
 }
 
+cc_result File_Delete(const cc_filepath* path) {
+	if (!fat_available) return ERR_NON_WRITABLE_FS;
+	return unlink(path->buffer) == -1 ? errno : 0;
+}
+
 cc_result Directory_Enum(const cc_string* dirPath, void* obj, Directory_EnumCallback callback) {
 	cc_string path; char pathBuffer[FILENAME_SIZE];
 	cc_filepath str;
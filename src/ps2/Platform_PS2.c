@@ -190,6 +190,11 @@ int File_Exists(const cc_filepath* path) {
 	return fioGetstat(path->buffer, &sb) >= 0 && (sb.mode & FIO_SO_IFREG);
 }
 
+cc_result File_Delete(const cc_filepath* path) {
+	int res = fioRemove(path->buffer);
+	return res < 0 ? res : 0;
+}
+
 // For some reason fioDread seems to be returning a iox_dirent_t, instead of a io_dirent_t
 // The offset of 'name' in iox_dirent_t is different to 'iox_dirent_t', so naively trying
 // to use entry.name doesn't work
@@ -128,6 +128,11 @@ int File_Exists(const cc_filepath* path) {
 	return sceIoGetstat(path->buffer, &sb) == 0 && SCE_S_ISREG(sb.st_mode) != 0;
 }
 
+cc_result File_Delete(const cc_filepath* path) {
+	int result = sceIoRemove(path->buffer);
+	return GetSCEResult(result);
+}
+
 cc_result Directory_Enum(const cc_string* dirPath, void* obj, Directory_EnumCallback callback) {
 	cc_string path; char pathBuffer[FILENAME_SIZE];
 	cc_filepath str;
@@ -108,6 +108,11 @@ int File_Exists(const cc_filepath* path) {
 	return interop_FileExists(path->buffer);
 }
 
+extern int interop_FileDelete(const char* path);
+cc_result File_Delete(const cc_filepath* path) {
+	return interop_FileDelete(path->buffer);
+}
+
 static void* enum_obj;
 static Directory_EnumCallback enum_callback;
 EMSCRIPTEN_KEEPALIVE void Directory_IterCallback(const char* src) {
@@ -276,6 +276,26 @@ mergeInto(LibraryManager.library, {
     path = CCFS.resolvePath(path);
     return path in CCFS.entries;
   },
+  interop_FileDelete__deps: ['IDBFS_getDB'],
+  interop_FileDelete: function(raw) {
+    var path = CCFS.resolvePath(UTF8ToString(raw));
+    try {
+      CCFS.unlink(path);
+    } catch (e) {
+      if (!(e instanceof CCFS.ErrnoError)) abort(e);
+      return e.errno;
+    }
+
+    // also remove the persisted copy, otherwise it comes back on next load
+    _IDBFS_getDB(function(err, db) {
+      if (err) return;
+      try {
+        var transaction = db.transaction([IDBFS_DB_STORE_NAME], 'readwrite');
+        transaction.objectStore(IDBFS_DB_STORE_NAME).delete(path);
+      } catch (err) { }
+    });
+    return 0;
+  },
   interop_FileCreate: function(raw, flags) {
     var path = UTF8ToString(raw);
     try {